@@ -0,0 +1,486 @@
+#pragma once
+
+#include <algorithm>  // copy(), fill(), max(), min()
+#include <cmath>
+#include <iomanip>
+#include <vector>
+
+#include "hart_dsp.hpp"
+#include "hart_exceptions.hpp"
+#include "hart_precision.hpp"
+#include "hart_utils.hpp"
+
+namespace hart
+{
+
+/// @brief Biquad filter, with all the usual RBJ cookbook responses
+/// @details Runs in transposed direct form II, in double precision no matter the sample type. Low and high pass filters
+/// can be of any order, in which case they become Butterworth filters made of a cascade of biquads (plus a first order
+/// section for odd orders). All three parameters can be automated: the coefficients are recalculated from the envelope
+/// values every few frames, and interpolated linearly in between, so sweeping the cutoff doesn't produce zipper noise.
+/// Consider using shorthands like @ref LPF or @ref HPF instead of this class.
+/// @ingroup DSP
+template <typename SampleType>
+class Biquad:
+    public hart::DSP<SampleType>
+{
+public:
+    /// @brief Filter response
+    enum class Type
+    {
+        lowPass,    ///< Low pass, 12dB/octave per each second order section
+        highPass,   ///< High pass, 12dB/octave per each second order section
+        bandPass,   ///< Band pass with 0dB gain at the center frequency
+        notch,      ///< Notch (band reject)
+        allPass,    ///< All pass, only changes the phase
+        peak,       ///< Peaking EQ (bell)
+        lowShelf,   ///< Low shelf
+        highShelf   ///< High shelf
+    };
+
+    enum Params
+    {
+        frequencyHz,  ///< Cutoff, center or corner frequency in Hz
+        q,  ///< Resonance (Q factor), ignored by the Butterworth filters of orders other than 2
+        gainDb  ///< Gain in decibels, used only by peaking and shelving filters
+    };
+
+    /// @brief Q of a second order Butterworth filter
+    static constexpr double butterworthQ = 0.70710678118654752;
+
+    /// @brief Constructor
+    /// @param type Filter response
+    /// @param frequencyHz Cutoff, center or corner frequency in Hz
+    /// @param q Resonance (Q factor)
+    /// @param gainDb Gain in decibels, only used by peaking and shelving filters
+    /// @param order Filter order, only low and high pass filters support orders other than 2
+    Biquad (Type type, double frequencyHz = 1000.0, double q = butterworthQ, double gainDb = 0.0, size_t order = 2):
+        m_type (type),
+        m_order (order),
+        m_initialFrequencyHz (frequencyHz),
+        m_initialQ (q),
+        m_initialGainDb (gainDb),
+        m_frequencyHz (frequencyHz),
+        m_q (q),
+        m_gainDb (gainDb)
+    {
+        if (frequencyHz <= 0)
+            HART_THROW (hart::ValueError, "Invalid frequency value");
+
+        if (q <= 0)
+            HART_THROW (hart::ValueError, "Q should be a positive value");
+
+        if (order == 0 || (order != 2 && type != Type::lowPass && type != Type::highPass))
+            HART_THROW (hart::ValueError, "Unsupported filter order");
+
+        initSections();
+    }
+
+    void prepare (double sampleRateHz, size_t numInputChannels, size_t /* numOutputChannels */, size_t /* maxBlockSizeFrames */) override
+    {
+        m_sampleRateHz = sampleRateHz;
+        m_states.resize (numInputChannels * m_sectionQs.size());
+        reset();
+    }
+
+    void process (const AudioBuffer<SampleType>& input, AudioBuffer<SampleType>& output, const EnvelopeBuffers& envelopeBuffers) override
+    {
+        const size_t numChannels = input.getNumChannels();
+        const size_t numFrames = input.getNumFrames();
+        hassert (output.getNumFrames() == numFrames);
+
+        if (! supportsChannelLayout (numChannels, output.getNumChannels()))
+            HART_THROW_OR_RETURN_VOID (hart::ChannelLayoutError, "Unsupported channel configuration");
+
+        if (numChannels * m_sectionQs.size() != m_states.size())
+            HART_THROW_OR_RETURN_VOID (hart::StateError, "Filter must be prepared for this number of channels before processing");
+
+        // Nothing rings, so silence stays silent
+        if (input.isSilent() && isIdle())
+        {
+            output.fillSilence();
+            return;
+        }
+
+        if (&input != &output)
+        {
+            for (size_t channel = 0; channel < numChannels; ++channel)
+                std::copy (input[channel], input[channel] + numFrames, output[channel]);
+        }
+
+        if (! hasEnvelopes (envelopeBuffers))
+        {
+            for (size_t channel = 0; channel < numChannels; ++channel)
+                for (size_t section = 0; section < m_sectionQs.size(); ++section)
+                    processSection (output[channel], numFrames, m_coefficients[section], getState (channel, section));
+
+            return;
+        }
+
+        const size_t updateIntervalFrames = coefficientUpdateIntervalFrames;
+
+        for (size_t startFrame = 0; startFrame < numFrames; startFrame += updateIntervalFrames)
+        {
+            const size_t numChunkFrames = std::min (updateIntervalFrames, numFrames - startFrame);
+
+            // Right after reset, the filter starts at the envelope values instead of gliding towards them
+            if (! m_hasAutomationStarted)
+            {
+                updateCoefficients (getParamValues (envelopeBuffers, startFrame), m_coefficients);
+                m_hasAutomationStarted = true;
+            }
+
+            updateCoefficients (getParamValues (envelopeBuffers, startFrame + numChunkFrames - 1), m_targetCoefficients);
+
+            for (size_t channel = 0; channel < numChannels; ++channel)
+                for (size_t section = 0; section < m_sectionQs.size(); ++section)
+                    processSectionInterpolated (output[channel] + startFrame, numChunkFrames, m_coefficients[section], m_targetCoefficients[section], getState (channel, section));
+
+            m_coefficients = m_targetCoefficients;
+        }
+    }
+
+    void reset() override
+    {
+        std::fill (m_states.begin(), m_states.end(), State());
+        m_hasAutomationStarted = false;
+
+        if (m_sampleRateHz > 0)
+            updateCoefficients (getParamValues(), m_coefficients);
+    }
+
+    /// @param id @ref Biquad::frequencyHz, @ref Biquad::q or @ref Biquad::gainDb
+    /// @param value Frequency in Hz, Q factor or gain in decibels respectively
+    void setValue (int id, double value) override
+    {
+        if (id == Params::frequencyHz)
+            m_frequencyHz = value;
+        else if (id == Params::q)
+            m_q = value;
+        else if (id == Params::gainDb)
+            m_gainDb = value;
+
+        if (m_sampleRateHz > 0)
+            updateCoefficients (getParamValues(), m_coefficients);
+    }
+
+    /// @param id @ref Biquad::frequencyHz, @ref Biquad::q or @ref Biquad::gainDb
+    /// @retval (value) Frequency in Hz, Q factor or gain in decibels respectively
+    double getValue (int id) const override
+    {
+        if (id == Params::frequencyHz)
+            return m_frequencyHz;
+
+        if (id == Params::q)
+            return m_q;
+
+        if (id == Params::gainDb)
+            return m_gainDb;
+
+        return 0.0;
+    }
+
+    /// @details Supports only n-to-n channel configurations
+    bool supportsChannelLayout (size_t numInputChannels, size_t numOutputChannels) const override
+    {
+        return numInputChannels == numOutputChannels;
+    }
+
+    void represent (std::ostream& stream) const override
+    {
+        stream << "Biquad (" << getTypeName (m_type) << ", "
+            << hzPrecision << m_initialFrequencyHz << "_Hz, "
+            << linPrecision << m_initialQ << ", "
+            << dbPrecision << m_initialGainDb << "_dB, "
+            << m_order << ")";
+    }
+
+    /// @details All the parameters can be automated
+    bool supportsEnvelopeFor (int id) const override
+    {
+        return id == Params::frequencyHz || id == Params::q || id == Params::gainDb;
+    }
+
+    HART_DSP_DEFINE_COPY_AND_MOVE (Biquad);
+
+protected:
+    const Type m_type;
+    const size_t m_order;
+    const double m_initialFrequencyHz;
+    const double m_initialQ;
+    const double m_initialGainDb;
+
+    static const char* getTypeName (Type type)
+    {
+        switch (type)
+        {
+            case Type::lowPass:   return "Biquad::Type::lowPass";
+            case Type::highPass:  return "Biquad::Type::highPass";
+            case Type::bandPass:  return "Biquad::Type::bandPass";
+            case Type::notch:     return "Biquad::Type::notch";
+            case Type::allPass:   return "Biquad::Type::allPass";
+            case Type::peak:      return "Biquad::Type::peak";
+            case Type::lowShelf:  return "Biquad::Type::lowShelf";
+            case Type::highShelf: return "Biquad::Type::highShelf";
+        }
+
+        return "Biquad::Type::unknown";
+    }
+
+private:
+    /// @brief Normalized coefficients, with a0 being 1
+    struct Coefficients
+    {
+        double b0 = 1.0;
+        double b1 = 0.0;
+        double b2 = 0.0;
+        double a1 = 0.0;
+        double a2 = 0.0;
+    };
+
+    struct State
+    {
+        double z1 = 0.0;
+        double z2 = 0.0;
+    };
+
+    struct Values
+    {
+        double frequencyHz;
+        double q;
+        double gainDb;
+    };
+
+    /// @brief How often the coefficients get recalculated when automated
+    static constexpr size_t coefficientUpdateIntervalFrames = 32;
+
+    double m_frequencyHz;
+    double m_q;
+    double m_gainDb;
+    double m_sampleRateHz = 0.0;
+    bool m_hasAutomationStarted = false;
+
+    /// @brief Q of each section, or zero for a first order section
+    std::vector<double> m_sectionQs;
+    std::vector<Coefficients> m_coefficients;
+    std::vector<Coefficients> m_targetCoefficients;
+    std::vector<State> m_states;
+
+    void initSections()
+    {
+        m_sectionQs.clear();
+
+        if (m_order == 2)
+        {
+            m_sectionQs.push_back (0.0);  // Uses m_q
+        }
+        else if (m_order % 2 == 0)
+        {
+            for (size_t section = 0; section < m_order / 2; ++section)
+                m_sectionQs.push_back (1.0 / (2.0 * std::cos (hart::pi * (2 * section + 1) / (2.0 * m_order))));
+        }
+        else
+        {
+            m_sectionQs.push_back (0.0);
+
+            for (size_t section = 1; section <= m_order / 2; ++section)
+                m_sectionQs.push_back (1.0 / (2.0 * std::cos (hart::pi * section / m_order)));
+        }
+
+        m_coefficients.resize (m_sectionQs.size());
+        m_targetCoefficients.resize (m_sectionQs.size());
+    }
+
+    State& getState (size_t channel, size_t section)
+    {
+        return m_states[channel * m_sectionQs.size() + section];
+    }
+
+    bool isIdle() const
+    {
+        for (const State& state : m_states)
+            if (state.z1 != 0.0 || state.z2 != 0.0)
+                return false;
+
+        return true;
+    }
+
+    static bool hasEnvelopes (const EnvelopeBuffers& envelopeBuffers)
+    {
+        return ! envelopeBuffers.empty() && (contains (envelopeBuffers, (int) Params::frequencyHz)
+            || contains (envelopeBuffers, (int) Params::q) || contains (envelopeBuffers, (int) Params::gainDb));
+    }
+
+    Values getParamValues() const
+    {
+        return Values { m_frequencyHz, m_q, m_gainDb };
+    }
+
+    /// @brief Gets the parameter values at a given frame, taking them from the envelopes wherever there are any
+    Values getParamValues (const EnvelopeBuffers& envelopeBuffers, size_t frame) const
+    {
+        Values values = getParamValues();
+
+        for (const auto& item : envelopeBuffers)
+        {
+            if (item.first == Params::frequencyHz)
+                values.frequencyHz = item.second[frame];
+            else if (item.first == Params::q)
+                values.q = item.second[frame];
+            else if (item.first == Params::gainDb)
+                values.gainDb = item.second[frame];
+        }
+
+        return values;
+    }
+
+    void updateCoefficients (const Values& values, std::vector<Coefficients>& coefficients) const
+    {
+        // Keeps the filter stable no matter what the envelopes throw at it
+        const double frequencyHz = hart::clamp (values.frequencyHz, 1.0, 0.49 * m_sampleRateHz);
+        const double q = std::max (values.q, 1e-3);
+        const double w0 = hart::twoPi * frequencyHz / m_sampleRateHz;
+
+        for (size_t section = 0; section < m_sectionQs.size(); ++section)
+        {
+            if (m_order != 2 && m_sectionQs[section] == 0.0)
+                coefficients[section] = makeFirstOrderCoefficients (w0);
+            else
+                coefficients[section] = makeCoefficients (w0, m_order == 2 ? q : m_sectionQs[section], values.gainDb);
+        }
+    }
+
+    Coefficients makeFirstOrderCoefficients (double w0) const
+    {
+        const double k = std::tan (w0 / 2.0);
+        Coefficients c;
+        c.a1 = (k - 1.0) / (k + 1.0);
+
+        if (m_type == Type::lowPass)
+        {
+            c.b0 = k / (k + 1.0);
+            c.b1 = c.b0;
+        }
+        else
+        {
+            c.b0 = 1.0 / (k + 1.0);
+            c.b1 = -c.b0;
+        }
+
+        return c;
+    }
+
+    Coefficients makeCoefficients (double w0, double q, double gainDb) const
+    {
+        const double cosW0 = std::cos (w0);
+        const double alpha = std::sin (w0) / (2.0 * q);
+        const double a = std::pow (10.0, gainDb / 40.0);
+        const double twoSqrtAAlpha = 2.0 * std::sqrt (a) * alpha;
+        double b0 = 1.0, b1 = 0.0, b2 = 0.0, a0 = 1.0, a1 = 0.0, a2 = 0.0;
+
+        switch (m_type)
+        {
+            case Type::lowPass:
+                b0 = (1.0 - cosW0) / 2.0; b1 = 1.0 - cosW0; b2 = b0;
+                a0 = 1.0 + alpha; a1 = -2.0 * cosW0; a2 = 1.0 - alpha;
+                break;
+
+            case Type::highPass:
+                b0 = (1.0 + cosW0) / 2.0; b1 = -(1.0 + cosW0); b2 = b0;
+                a0 = 1.0 + alpha; a1 = -2.0 * cosW0; a2 = 1.0 - alpha;
+                break;
+
+            case Type::bandPass:
+                b0 = alpha; b1 = 0.0; b2 = -alpha;
+                a0 = 1.0 + alpha; a1 = -2.0 * cosW0; a2 = 1.0 - alpha;
+                break;
+
+            case Type::notch:
+                b0 = 1.0; b1 = -2.0 * cosW0; b2 = 1.0;
+                a0 = 1.0 + alpha; a1 = -2.0 * cosW0; a2 = 1.0 - alpha;
+                break;
+
+            case Type::allPass:
+                b0 = 1.0 - alpha; b1 = -2.0 * cosW0; b2 = 1.0 + alpha;
+                a0 = 1.0 + alpha; a1 = -2.0 * cosW0; a2 = 1.0 - alpha;
+                break;
+
+            case Type::peak:
+                b0 = 1.0 + alpha * a; b1 = -2.0 * cosW0; b2 = 1.0 - alpha * a;
+                a0 = 1.0 + alpha / a; a1 = -2.0 * cosW0; a2 = 1.0 - alpha / a;
+                break;
+
+            case Type::lowShelf:
+                b0 = a * ((a + 1.0) - (a - 1.0) * cosW0 + twoSqrtAAlpha);
+                b1 = 2.0 * a * ((a - 1.0) - (a + 1.0) * cosW0);
+                b2 = a * ((a + 1.0) - (a - 1.0) * cosW0 - twoSqrtAAlpha);
+                a0 = (a + 1.0) + (a - 1.0) * cosW0 + twoSqrtAAlpha;
+                a1 = -2.0 * ((a - 1.0) + (a + 1.0) * cosW0);
+                a2 = (a + 1.0) + (a - 1.0) * cosW0 - twoSqrtAAlpha;
+                break;
+
+            case Type::highShelf:
+                b0 = a * ((a + 1.0) + (a - 1.0) * cosW0 + twoSqrtAAlpha);
+                b1 = -2.0 * a * ((a - 1.0) + (a + 1.0) * cosW0);
+                b2 = a * ((a + 1.0) + (a - 1.0) * cosW0 - twoSqrtAAlpha);
+                a0 = (a + 1.0) - (a - 1.0) * cosW0 + twoSqrtAAlpha;
+                a1 = 2.0 * ((a - 1.0) - (a + 1.0) * cosW0);
+                a2 = (a + 1.0) - (a - 1.0) * cosW0 - twoSqrtAAlpha;
+                break;
+        }
+
+        Coefficients c;
+        c.b0 = b0 / a0;
+        c.b1 = b1 / a0;
+        c.b2 = b2 / a0;
+        c.a1 = a1 / a0;
+        c.a2 = a2 / a0;
+        return c;
+    }
+
+    static void processSection (SampleType* samples, size_t numFrames, const Coefficients& c, State& state)
+    {
+        double z1 = state.z1;
+        double z2 = state.z2;
+
+        for (size_t frame = 0; frame < numFrames; ++frame)
+        {
+            const double x = samples[frame];
+            const double y = c.b0 * x + z1;
+            z1 = c.b1 * x - c.a1 * y + z2;
+            z2 = c.b2 * x - c.a2 * y;
+            samples[frame] = static_cast<SampleType> (y);
+        }
+
+        state.z1 = z1;
+        state.z2 = z2;
+    }
+
+    /// @brief Same as @ref processSection(), but glides from one set of coefficients to another, reaching it at the last frame
+    static void processSectionInterpolated (SampleType* samples, size_t numFrames, const Coefficients& from, const Coefficients& to, State& state)
+    {
+        double z1 = state.z1;
+        double z2 = state.z2;
+
+        for (size_t frame = 0; frame < numFrames; ++frame)
+        {
+            const double t = static_cast<double> (frame + 1) / numFrames;
+            const double b0 = from.b0 + (to.b0 - from.b0) * t;
+            const double b1 = from.b1 + (to.b1 - from.b1) * t;
+            const double b2 = from.b2 + (to.b2 - from.b2) * t;
+            const double a1 = from.a1 + (to.a1 - from.a1) * t;
+            const double a2 = from.a2 + (to.a2 - from.a2) * t;
+
+            const double x = samples[frame];
+            const double y = b0 * x + z1;
+            z1 = b1 * x - a1 * y + z2;
+            z2 = b2 * x - a2 * y;
+            samples[frame] = static_cast<SampleType> (y);
+        }
+
+        state.z1 = z1;
+        state.z2 = z2;
+    }
+};
+
+}  // namespace hart
@@ -0,0 +1,36 @@
+#pragma once
+
+#include "dsp/hart_biquad.hpp"
+#include "hart_precision.hpp"
+
+namespace hart
+{
+
+/// @brief Band pass filter
+/// @details Second order filter with 0dB gain at the center frequency
+/// @see Biquad
+/// @ingroup DSP
+template <typename SampleType>
+class BPF:
+    public Biquad<SampleType>
+{
+public:
+    /// @brief Constructor
+    /// @param centerHz Center frequency in Hz
+    /// @param q Resonance (Q factor), higher values make the band narrower
+    BPF (double centerHz = 1000.0, double q = Biquad<SampleType>::butterworthQ):
+        Biquad<SampleType> (Biquad<SampleType>::Type::bandPass, centerHz, q)
+    {
+    }
+
+    void represent (std::ostream& stream) const override
+    {
+        stream << "BPF ("
+            << hzPrecision << this->m_initialFrequencyHz << "_Hz, "
+            << linPrecision << this->m_initialQ << ")";
+    }
+
+    HART_DSP_DEFINE_COPY_AND_MOVE (BPF);
+};
+
+}  // namespace hart
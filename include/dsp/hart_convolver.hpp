@@ -0,0 +1,296 @@
+#pragma once
+
+#include <algorithm>  // copy(), fill(), min()
+#include <complex>
+#include <cstddef>  // ptrdiff_t
+#include <memory>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "hart_dsp.hpp"
+#include "hart_exceptions.hpp"
+#include "hart_fft.hpp"
+#include "signals/hart_wavfile.hpp"
+#include "hart_utils.hpp"
+
+namespace hart
+{
+
+/// @brief Convolves the signal with an impulse response
+/// @details Useful for generating reference audio for reverbs or cabinet simulations from measured impulse responses.
+/// The first partition of the impulse response is applied directly in time domain, so there's no latency,
+/// and the rest of it is applied with uniformly partitioned FFT convolution and a frequency domain delay line.
+/// The impulse response can have either one channel, which gets applied to all the channels, or the same number of
+/// channels as the output, in which case each output channel gets its own. Mono input can be convolved with a
+/// multichannel impulse response too, e.g. to make a stereo reverb tail out of a mono signal.
+/// @ingroup DSP
+template <typename SampleType>
+class Convolver:
+    public hart::DSP<SampleType>
+{
+public:
+    /// @brief Creates a convolver from an audio buffer
+    /// @param impulseResponse Impulse response, one or more channels. It's used at any sample rate.
+    Convolver (const AudioBuffer<SampleType>& impulseResponse)
+    {
+        std::stringstream stream;
+        stream << "Convolver (<" << impulseResponse.getNumChannels() << " channel impulse response, " << impulseResponse.getNumFrames() << " frames>)";
+        m_description = stream.str();
+
+        std::vector<std::vector<double>> channels (impulseResponse.getNumChannels(), std::vector<double> (impulseResponse.getNumFrames()));
+
+        for (size_t channel = 0; channel < channels.size(); ++channel)
+            std::copy (impulseResponse[channel], impulseResponse[channel] + impulseResponse.getNumFrames(), channels[channel].begin());
+
+        init (channels);
+    }
+
+    /// @brief Creates a convolver from a wav file
+    /// @param impulseResponse Wav file with the impulse response. Only its sample rate is supported.
+    Convolver (const WavFile<SampleType>& impulseResponse):
+        m_impulseResponseSampleRateHz (impulseResponse.getWavSampleRateHz())
+    {
+        m_description = "Convolver (WavFile (\"" + impulseResponse.getFilePath() + "\"))";
+
+        const AudioBuffer<float>& wavFrames = impulseResponse.getWavFrames();
+        std::vector<std::vector<double>> channels (wavFrames.getNumChannels(), std::vector<double> (wavFrames.getNumFrames()));
+
+        for (size_t channel = 0; channel < channels.size(); ++channel)
+            std::copy (wavFrames[channel], wavFrames[channel] + wavFrames.getNumFrames(), channels[channel].begin());
+
+        init (channels);
+    }
+
+    void prepare (double /* sampleRateHz */, size_t numInputChannels, size_t numOutputChannels, size_t /* maxBlockSizeFrames */) override
+    {
+        m_numInputChannels = numInputChannels;
+        m_channelStates.assign (numOutputChannels, ChannelState (m_kernel->partitionSizeFrames, m_kernel->numPartitions, m_fft.getNumBins()));
+        reset();
+    }
+
+    void process (const AudioBuffer<SampleType>& input, AudioBuffer<SampleType>& output, const EnvelopeBuffers& /* envelopeBuffers */) override
+    {
+        const size_t numFrames = input.getNumFrames();
+        hassert (output.getNumFrames() == numFrames);
+
+        if (! supportsChannelLayout (input.getNumChannels(), output.getNumChannels()))
+            HART_THROW_OR_RETURN_VOID (hart::ChannelLayoutError, "Unsupported channel configuration");
+
+        if (input.getNumChannels() != m_numInputChannels || output.getNumChannels() != m_channelStates.size())
+            HART_THROW_OR_RETURN_VOID (hart::StateError, "Convolver must be prepared for this channel layout before processing");
+
+        // Once the tail has died out, silence in means silence out
+        if (input.isSilent())
+        {
+            if (m_numSilentFrames >= m_kernel->lengthFrames + 2 * m_kernel->partitionSizeFrames)
+            {
+                output.fillSilence();
+                return;
+            }
+
+            m_numSilentFrames += numFrames;
+        }
+        else
+        {
+            m_numSilentFrames = 0;
+        }
+
+        for (size_t channel = 0; channel < output.getNumChannels(); ++channel)
+        {
+            const SampleType* inputFrames = input[m_numInputChannels == 1 ? 0 : channel];
+            const size_t kernelChannel = m_kernel->numChannels == 1 ? 0 : channel;
+            processChannel (inputFrames, output[channel], numFrames, kernelChannel, m_channelStates[channel]);
+        }
+    }
+
+    void reset() override
+    {
+        m_numSilentFrames = 0;
+
+        for (ChannelState& state : m_channelStates)
+        {
+            std::fill (state.inputFrames.begin(), state.inputFrames.end(), 0.0);
+            std::fill (state.tailFrames.begin(), state.tailFrames.end(), 0.0);
+            std::fill (state.delayLine.begin(), state.delayLine.end(), std::complex<double>());
+            state.positionFrames = 0;
+            state.delayLinePosition = 0;
+        }
+    }
+
+    /// @details Convolver has no parameters
+    void setValue (int /* id */, double /* value */) override {}
+
+    /// @details Convolver has no parameters
+    double getValue (int /* id */) const override
+    {
+        return 0.0;
+    }
+
+    /// @details Supports n-to-n configurations with either mono or n-channel impulse response,
+    /// and 1-to-n configurations with n-channel impulse response
+    bool supportsChannelLayout (size_t numInputChannels, size_t numOutputChannels) const override
+    {
+        const bool isKernelLayoutSupported = m_kernel->numChannels == 1 || m_kernel->numChannels == numOutputChannels;
+        return isKernelLayoutSupported && (numInputChannels == numOutputChannels || numInputChannels == 1);
+    }
+
+    /// @details If the impulse response came from a wav file, only its sample rate is supported
+    bool supportsSampleRate (double sampleRateHz) const override
+    {
+        return m_impulseResponseSampleRateHz <= 0 || floatsEqual (sampleRateHz, m_impulseResponseSampleRateHz);
+    }
+
+    void represent (std::ostream& stream) const override
+    {
+        stream << m_description;
+    }
+
+    HART_DSP_DEFINE_COPY_AND_MOVE (Convolver);
+
+private:
+    /// @brief Largest partition, also the length of the part of the impulse response that gets applied directly
+    static constexpr size_t maxPartitionSizeFrames = 256;
+
+    /// @brief Impulse response prepared for convolution, it never changes, so it's shared between the copies
+    struct Kernel
+    {
+        size_t numChannels = 0;
+        size_t lengthFrames = 0;
+        size_t partitionSizeFrames = 0;
+        size_t numPartitions = 0;
+
+        /// @brief First partition of each channel, for the direct convolution
+        std::vector<std::vector<double>> heads;
+
+        /// @brief Spectra of the rest of the partitions of each channel, one after another
+        std::vector<std::vector<std::complex<double>>> tailSpectra;
+    };
+
+    struct ChannelState
+    {
+        /// @brief Previous block of input followed by the one being filled
+        std::vector<double> inputFrames;
+
+        /// @brief Output of the FFT part of the convolution for the current block
+        std::vector<double> tailFrames;
+
+        /// @brief Ring of spectra of the past input blocks, one per tail partition
+        std::vector<std::complex<double>> delayLine;
+
+        size_t positionFrames = 0;
+        size_t delayLinePosition = 0;
+
+        ChannelState (size_t partitionSizeFrames, size_t numPartitions, size_t numBins):
+            inputFrames (2 * partitionSizeFrames),
+            tailFrames (partitionSizeFrames),
+            delayLine ((numPartitions - 1) * numBins)
+        {
+        }
+    };
+
+    std::string m_description;
+    double m_impulseResponseSampleRateHz = 0.0;
+    std::shared_ptr<const Kernel> m_kernel;
+    RealFFT m_fft {4};
+    size_t m_numInputChannels = 0;
+    size_t m_numSilentFrames = 0;
+    std::vector<ChannelState> m_channelStates;
+    std::vector<std::complex<double>> m_spectrum;
+    std::vector<double> m_fftFrames;
+
+    void init (const std::vector<std::vector<double>>& impulseResponse)
+    {
+        if (impulseResponse.empty() || impulseResponse[0].empty())
+            HART_THROW_OR_RETURN_VOID (hart::ValueError, "Impulse response can't be empty");
+
+        const size_t maxPartitionSize = maxPartitionSizeFrames;
+        std::shared_ptr<Kernel> kernel = std::make_shared<Kernel>();
+        kernel->numChannels = impulseResponse.size();
+        kernel->lengthFrames = impulseResponse[0].size();
+        kernel->partitionSizeFrames = std::min<size_t> (maxPartitionSize, std::max<size_t> (2, nextPowerOfTwo (kernel->lengthFrames)));
+        kernel->numPartitions = (kernel->lengthFrames + kernel->partitionSizeFrames - 1) / kernel->partitionSizeFrames;
+
+        const size_t partitionSizeFrames = kernel->partitionSizeFrames;
+        m_fft = RealFFT (2 * partitionSizeFrames);
+        m_spectrum.resize (m_fft.getNumBins());
+        m_fftFrames.resize (2 * partitionSizeFrames);
+
+        for (const std::vector<double>& channel : impulseResponse)
+        {
+            const size_t headSizeFrames = std::min (partitionSizeFrames, channel.size());
+            kernel->heads.emplace_back (channel.begin(), channel.begin() + headSizeFrames);
+            kernel->tailSpectra.emplace_back ((kernel->numPartitions - 1) * m_fft.getNumBins());
+
+            for (size_t partition = 1; partition < kernel->numPartitions; ++partition)
+            {
+                const size_t startFrame = partition * partitionSizeFrames;
+                const size_t numFrames = std::min (partitionSizeFrames, channel.size() - startFrame);
+
+                // Zero padded to twice the partition size, so the blocks don't wrap around into each other
+                std::fill (m_fftFrames.begin(), m_fftFrames.end(), 0.0);
+                std::copy (channel.begin() + startFrame, channel.begin() + startFrame + numFrames, m_fftFrames.begin());
+                m_fft.forward (m_fftFrames.data(), &kernel->tailSpectra.back()[(partition - 1) * m_fft.getNumBins()]);
+            }
+        }
+
+        m_kernel = kernel;
+    }
+
+    void processChannel (const SampleType* input, SampleType* output, size_t numFrames, size_t kernelChannel, ChannelState& state)
+    {
+        const size_t partitionSizeFrames = m_kernel->partitionSizeFrames;
+        const std::vector<double>& head = m_kernel->heads[kernelChannel];
+
+        for (size_t frame = 0; frame < numFrames; ++frame)
+        {
+            // Input is read before the output gets written, so it's safe to process in place
+            const double* latestInputFrame = &state.inputFrames[partitionSizeFrames + state.positionFrames];
+            state.inputFrames[partitionSizeFrames + state.positionFrames] = input[frame];
+            double outputValue = state.tailFrames[state.positionFrames];
+
+            for (size_t i = 0; i < head.size(); ++i)
+                outputValue += head[i] * latestInputFrame[-static_cast<std::ptrdiff_t> (i)];
+
+            output[frame] = static_cast<SampleType> (outputValue);
+
+            if (++state.positionFrames == partitionSizeFrames)
+                advanceBlock (kernelChannel, state);
+        }
+    }
+
+    /// @brief Pushes the complete block of input into the delay line, and calculates the tail for the next block
+    void advanceBlock (size_t kernelChannel, ChannelState& state)
+    {
+        const size_t partitionSizeFrames = m_kernel->partitionSizeFrames;
+        const size_t numTailPartitions = m_kernel->numPartitions - 1;
+        const size_t numBins = m_fft.getNumBins();
+
+        if (numTailPartitions > 0)
+        {
+            state.delayLinePosition = (state.delayLinePosition + 1) % numTailPartitions;
+            m_fft.forward (state.inputFrames.data(), &state.delayLine[state.delayLinePosition * numBins]);
+            std::fill (m_spectrum.begin(), m_spectrum.end(), std::complex<double>());
+
+            // Partition n gets applied to the input from n blocks ago
+            for (size_t partition = 0; partition < numTailPartitions; ++partition)
+            {
+                const size_t delayLineIndex = (state.delayLinePosition + numTailPartitions - partition) % numTailPartitions;
+                const std::complex<double>* inputSpectrum = &state.delayLine[delayLineIndex * numBins];
+                const std::complex<double>* kernelSpectrum = &m_kernel->tailSpectra[kernelChannel][partition * numBins];
+
+                for (size_t bin = 0; bin < numBins; ++bin)
+                    m_spectrum[bin] += inputSpectrum[bin] * kernelSpectrum[bin];
+            }
+
+            // Overlap-save: the first half has wrapped around, the second half is the actual output
+            m_fft.inverse (m_spectrum.data(), m_fftFrames.data());
+            std::copy (m_fftFrames.begin() + partitionSizeFrames, m_fftFrames.end(), state.tailFrames.begin());
+        }
+
+        std::copy (state.inputFrames.begin() + partitionSizeFrames, state.inputFrames.end(), state.inputFrames.begin());
+        state.positionFrames = 0;
+    }
+};
+
+}  // namespace hart
@@ -0,0 +1,316 @@
+#pragma once
+
+#include <algorithm>  // copy(), fill(), max(), min()
+#include <cmath>
+#include <vector>
+
+#include "hart_dsp.hpp"
+#include "hart_exceptions.hpp"
+#include "hart_fft.hpp"  // nextPowerOfTwo()
+#include "hart_precision.hpp"
+#include "hart_utils.hpp"
+
+namespace hart
+{
+
+/// @brief Delays the signal by a fixed or automated amount of time
+/// @details Useful for modelling latency in reference signals, e.g. to compare a lookahead limiter's output
+/// to its delayed input with @ref EqualsTo, or for building reference models of modulated effects like chorus or flanger.
+/// Delays that are a whole number of frames, which is what latency usually is, are just copied over block by block,
+/// so they're exact and cheap regardless of the chosen interpolation. Otherwise, the delay is interpolated:
+///  - @ref Interpolation::none rounds the delay to the nearest frame
+///  - @ref Interpolation::linear is the cheapest, but it rolls off the high frequencies
+///  - @ref Interpolation::lagrange is third order Lagrange interpolation, which rolls off a lot less
+///  - @ref Interpolation::thiran is a first order Thiran allpass filter: flat magnitude response, but its phase
+///    response is only linear at low frequencies, and it rings a bit when the delay changes. Delays shorter
+///    than half a frame can't be made this way, so they're rounded up to half a frame.
+/// @ingroup DSP
+template <typename SampleType>
+class Delay:
+    public hart::DSP<SampleType>
+{
+public:
+    enum Params
+    {
+        delaySeconds  ///< Delay time in seconds
+    };
+
+    enum class Interpolation
+    {
+        none,
+        linear,
+        lagrange,
+        thiran
+    };
+
+    /// @brief Constructor
+    /// @param delaySeconds Initial delay time in seconds
+    /// @param interpolation How to deal with delays that are not a whole number of frames
+    /// @param maxDelaySeconds The longest delay that is going to be set or automated, if it's longer than the initial one.
+    /// Longer delays are clamped to it.
+    Delay (double delaySeconds = 0.0, Interpolation interpolation = Interpolation::linear, double maxDelaySeconds = 0.0):
+        m_initialDelaySeconds (delaySeconds),
+        m_delaySeconds (delaySeconds),
+        m_interpolation (interpolation),
+        m_maxDelaySeconds (std::max (delaySeconds, maxDelaySeconds))
+    {
+        if (delaySeconds < 0 || maxDelaySeconds < 0)
+            HART_THROW_OR_RETURN_VOID (hart::ValueError, "Delay time can't be negative");
+    }
+
+    void prepare (double sampleRateHz, size_t numInputChannels, size_t /* numOutputChannels */, size_t maxBlockSizeFrames) override
+    {
+        m_sampleRateHz = sampleRateHz;
+        m_maxDelayFrames = m_maxDelaySeconds * sampleRateHz;
+
+        // Room for the longest delay, the whole block that gets written before reading, and the interpolation taps
+        const size_t ringSizeFrames = nextPowerOfTwo (static_cast<size_t> (std::ceil (m_maxDelayFrames)) + maxBlockSizeFrames + 4);
+        m_ringMask = ringSizeFrames - 1;
+        m_rings.assign (numInputChannels, std::vector<SampleType> (ringSizeFrames));
+        m_thiranStates.assign (numInputChannels, ThiranState());
+        reset();
+    }
+
+    void process (const AudioBuffer<SampleType>& input, AudioBuffer<SampleType>& output, const EnvelopeBuffers& envelopeBuffers) override
+    {
+        const size_t numFrames = input.getNumFrames();
+        hassert (output.getNumFrames() == numFrames);
+
+        if (! supportsChannelLayout (input.getNumChannels(), output.getNumChannels()))
+            HART_THROW_OR_RETURN_VOID (hart::ChannelLayoutError, "Unsupported channel configuration");
+
+        const bool hasDelayEnvelope = ! envelopeBuffers.empty() && contains (envelopeBuffers, (int) Params::delaySeconds);
+
+        // Input is written to the ring before reading, so it's fine to process in place
+        for (size_t channel = 0; channel < input.getNumChannels(); ++channel)
+            writeBlock (m_rings[channel], input[channel], numFrames);
+
+        // Once the longest delay is over, silence in means silence out
+        const double settlingFrames = m_maxDelayFrames + 64;
+
+        if (input.isSilent() && m_numSilentFrames >= settlingFrames)
+        {
+            for (ThiranState& thiranState : m_thiranStates)
+                thiranState = ThiranState();
+
+            output.fillSilence();
+            advance (numFrames);
+            return;
+        }
+
+        m_numSilentFrames = input.isSilent() ? m_numSilentFrames + numFrames : 0;
+
+        if (hasDelayEnvelope)
+        {
+            const std::vector<double>& delayEnvelopeValues = envelopeBuffers.at (Params::delaySeconds);
+
+            for (size_t channel = 0; channel < input.getNumChannels(); ++channel)
+                for (size_t frame = 0; frame < numFrames; ++frame)
+                    output[channel][frame] = readInterpolated (channel, frame, clampDelayFrames (delayEnvelopeValues[frame] * m_sampleRateHz));
+        }
+        else
+        {
+            const double delayFrames = clampDelayFrames (m_delaySeconds * m_sampleRateHz);
+            const double roundedDelayFrames = std::round (delayFrames);
+
+            if (m_interpolation == Interpolation::none || std::abs (delayFrames - roundedDelayFrames) < wholeFrameTolerance)
+            {
+                for (size_t channel = 0; channel < input.getNumChannels(); ++channel)
+                    readBlock (m_rings[channel], output[channel], numFrames, static_cast<size_t> (roundedDelayFrames));
+            }
+            else
+            {
+                for (size_t channel = 0; channel < input.getNumChannels(); ++channel)
+                    for (size_t frame = 0; frame < numFrames; ++frame)
+                        output[channel][frame] = readInterpolated (channel, frame, delayFrames);
+            }
+        }
+
+        advance (numFrames);
+    }
+
+    void reset() override
+    {
+        for (std::vector<SampleType>& ring : m_rings)
+            std::fill (ring.begin(), ring.end(), (SampleType) 0);
+
+        for (ThiranState& thiranState : m_thiranStates)
+            thiranState = ThiranState();
+
+        m_writePosition = 0;
+        m_numSilentFrames = 0;
+    }
+
+    /// @param id Only @ref Delay::delaySeconds is accepted
+    /// @param value Delay time in seconds
+    void setValue (int id, double value) override
+    {
+        if (id == Params::delaySeconds)
+            m_delaySeconds = value;
+    }
+
+    /// @param id Only @ref Delay::delaySeconds is accepted
+    /// @retval (value) Delay time in seconds
+    double getValue (int id) const override
+    {
+        if (id == Params::delaySeconds)
+            return m_delaySeconds;
+
+        return 0.0;
+    }
+
+    /// @details Supports only n-to-n channel configurations
+    bool supportsChannelLayout (size_t numInputChannels, size_t numOutputChannels) const override
+    {
+        return numInputChannels == numOutputChannels;
+    }
+
+    void represent (std::ostream& stream) const override
+    {
+        stream << "Delay (" << secPrecision << m_initialDelaySeconds << "_s, " << getInterpolationName (m_interpolation);
+
+        if (m_maxDelaySeconds > m_initialDelaySeconds)
+            stream << ", " << m_maxDelaySeconds << "_s";
+
+        stream << ')';
+    }
+
+    /// @param id Only @ref Delay::delaySeconds is accepted
+    /// retval (bool) true for Delay::delaySeconds, else otherwise
+    bool supportsEnvelopeFor (int id) const override
+    {
+        return id == Params::delaySeconds;
+    }
+
+    HART_DSP_DEFINE_COPY_AND_MOVE (Delay);
+
+private:
+    /// @brief Delays this close to a whole number of frames are treated as whole, so that round-off errors
+    /// of converting frames to seconds and back don't make them interpolated
+    static constexpr double wholeFrameTolerance = 1e-6;
+
+    struct ThiranState
+    {
+        double previousInput = 0.0;
+        double previousOutput = 0.0;
+    };
+
+    const double m_initialDelaySeconds;
+    double m_delaySeconds;
+    const Interpolation m_interpolation;
+    const double m_maxDelaySeconds;
+
+    double m_sampleRateHz = 0.0;
+    double m_maxDelayFrames = 0.0;
+    size_t m_ringMask = 0;
+    size_t m_writePosition = 0;
+    size_t m_numSilentFrames = 0;
+    std::vector<std::vector<SampleType>> m_rings;
+    std::vector<ThiranState> m_thiranStates;
+
+    double clampDelayFrames (double delayFrames) const
+    {
+        return hart::clamp (delayFrames, 0.0, m_maxDelayFrames);
+    }
+
+    void advance (size_t numFrames)
+    {
+        m_writePosition = (m_writePosition + numFrames) & m_ringMask;
+    }
+
+    /// @brief Copies the block into the ring in at most two contiguous chunks
+    void writeBlock (std::vector<SampleType>& ring, const SampleType* input, size_t numFrames)
+    {
+        const size_t numFramesBeforeWrap = std::min (numFrames, ring.size() - m_writePosition);
+        std::copy (input, input + numFramesBeforeWrap, ring.begin() + m_writePosition);
+        std::copy (input + numFramesBeforeWrap, input + numFrames, ring.begin());
+    }
+
+    /// @brief Copies the delayed block out of the ring in at most two contiguous chunks
+    void readBlock (const std::vector<SampleType>& ring, SampleType* output, size_t numFrames, size_t delayFrames)
+    {
+        const size_t readPosition = (m_writePosition + ring.size() - delayFrames) & m_ringMask;
+        const size_t numFramesBeforeWrap = std::min (numFrames, ring.size() - readPosition);
+        std::copy (ring.begin() + readPosition, ring.begin() + readPosition + numFramesBeforeWrap, output);
+        std::copy (ring.begin(), ring.begin() + (numFrames - numFramesBeforeWrap), output + numFramesBeforeWrap);
+    }
+
+    /// @brief Gets the frame that's a whole number of frames behind the frame of the current block
+    SampleType getDelayedFrame (size_t channel, size_t frame, size_t delayFrames) const
+    {
+        return m_rings[channel][(m_writePosition + frame + m_rings[channel].size() - delayFrames) & m_ringMask];
+    }
+
+    SampleType readInterpolated (size_t channel, size_t frame, double delayFrames)
+    {
+        switch (m_interpolation)
+        {
+            case Interpolation::none:
+                return getDelayedFrame (channel, frame, static_cast<size_t> (std::round (delayFrames)));
+
+            case Interpolation::linear:
+            {
+                const size_t wholeDelayFrames = static_cast<size_t> (delayFrames);
+                const double fraction = delayFrames - wholeDelayFrames;
+                const double newer = getDelayedFrame (channel, frame, wholeDelayFrames);
+                const double older = getDelayedFrame (channel, frame, wholeDelayFrames + 1);
+                return static_cast<SampleType> (newer + fraction * (older - newer));
+            }
+
+            case Interpolation::lagrange:
+            {
+                // Four points around the delay, centered on it unless it's less than a frame away from now
+                const size_t firstDelayFrames = delayFrames < 1.0 ? 0 : static_cast<size_t> (delayFrames) - 1;
+                const double position = delayFrames - firstDelayFrames;
+                double value = 0.0;
+
+                for (size_t point = 0; point < 4; ++point)
+                {
+                    double weight = 1.0;
+
+                    for (size_t otherPoint = 0; otherPoint < 4; ++otherPoint)
+                        if (otherPoint != point)
+                            weight *= (position - otherPoint) / ((double) point - otherPoint);
+
+                    value += weight * getDelayedFrame (channel, frame, firstDelayFrames + point);
+                }
+
+                return static_cast<SampleType> (value);
+            }
+
+            case Interpolation::thiran:
+            {
+                // Allpass filter works best for delays between half a frame and one and a half frames,
+                // so the whole frames take care of the rest
+                const double thiranDelayFrames = std::max (0.5, delayFrames);
+                const size_t wholeDelayFrames = static_cast<size_t> (std::floor (thiranDelayFrames - 0.5));
+                const double fraction = thiranDelayFrames - wholeDelayFrames;
+                const double coefficient = (1.0 - fraction) / (1.0 + fraction);
+
+                ThiranState& state = m_thiranStates[channel];
+                const double delayedInput = getDelayedFrame (channel, frame, wholeDelayFrames);
+                const double value = coefficient * delayedInput + state.previousInput - coefficient * state.previousOutput;
+                state.previousInput = delayedInput;
+                state.previousOutput = value;
+                return static_cast<SampleType> (value);
+            }
+        }
+
+        return (SampleType) 0;
+    }
+
+    static const char* getInterpolationName (Interpolation interpolation)
+    {
+        switch (interpolation)
+        {
+            case Interpolation::none:     return "Delay::Interpolation::none";
+            case Interpolation::linear:   return "Delay::Interpolation::linear";
+            case Interpolation::lagrange: return "Delay::Interpolation::lagrange";
+            case Interpolation::thiran:   return "Delay::Interpolation::thiran";
+        }
+
+        return "";
+    }
+};
+
+}  // namespace hart
@@ -135,11 +135,11 @@ public:
     DSP() = default;
 
     /// @brief Copies from another DSP effect instance
-    /// @details Attached automation envelopes are deep-copied
-    DSP (const DSP& other)
+    /// @details Attached automation envelopes are shared with the other instance until either of them
+    /// attaches a new envelope or gets prepared, so copying an effect with lots of automation is cheap
+    DSP (const DSP& other):
+        m_envelopes (other.m_envelopes)
     {
-        for (auto& pair : other.m_envelopes)
-            m_envelopes.emplace (pair.first, pair.second->copy());
     }
 
     /// @brief Move constructor
@@ -150,14 +150,11 @@ public:
     }
 
     /// @brief Copies from another DSP effect instance
-    /// @details Attached automation envelopes are deep-copied
+    /// @details Attached automation envelopes are shared the same way as with the copy constructor
     DSP& operator= (const DSP& other)
     {
-        if (this == &other)
-            return *this;
-
-        for (auto& pair : other.m_envelopes)
-            m_envelopes.emplace (pair.first, pair.second->copy());
+        if (this != &other)
+            m_envelopes = other.m_envelopes;
 
         return *this;
     }
@@ -185,7 +182,7 @@ public:
         if (! supportsEnvelopeFor(paramId))
             HART_THROW_OR_RETURN (hart::UnsupportedError, std::string ("DSP doesn't support envelopes for param ID: ") + std::to_string (paramId), *this);
 
-        m_envelopes.emplace (paramId, hart::make_unique<Envelope> (std::move (envelope)));
+        getUniqueEnvelopes()[paramId] = envelope.copy();  // Envelope is abstract, so it can only be cloned
         return *this;
     }
 
@@ -202,7 +199,7 @@ public:
         if (! supportsEnvelopeFor(paramId))
             HART_THROW_OR_RETURN (hart::UnsupportedError, std::string ("DSP doesn't support envelopes for param ID: ") + std::to_string (paramId), *this);
 
-        m_envelopes.emplace (paramId, envelope.copy());
+        getUniqueEnvelopes()[paramId] = envelope.copy();
         return *this;
     }
 
@@ -213,7 +210,7 @@ public:
     /// @return Reference to itself for chaining
     bool hasEnvelopeFor (int paramId)
     {
-        return m_envelopes.find (paramId) != m_envelopes.end();
+        return m_envelopes != nullptr && m_envelopes->find (paramId) != m_envelopes->end();
     }
 
     /// @brief Prepares all the attached envelopes and the effect itself for processing
@@ -226,13 +223,21 @@ public:
     {
         m_envelopeBuffers.clear();  // TODO: Remove only unused buffers
 
-        for (auto& item : m_envelopes)
+        if (m_envelopes != nullptr)
         {
-            const int paramId = item.first;
-            m_envelopeBuffers.emplace (paramId, std::vector<double> (maxBlockSizeFrames));
-        }
+            Envelopes& envelopes = getUniqueEnvelopes();
 
-        hassert (m_envelopes.size() == m_envelopeBuffers.size());
+            for (auto& item : envelopes)
+            {
+                const int paramId = item.first;
+                m_envelopeBuffers.emplace (paramId, std::vector<double> (maxBlockSizeFrames));
+            }
+
+            hassert (envelopes.size() == m_envelopeBuffers.size());
+
+            for (auto& item : envelopes)
+                item.second->prepare (sampleRateHz, maxBlockSizeFrames);
+        }
 
         for (auto& item : m_envelopeBuffers)
         {
@@ -250,6 +255,22 @@ public:
         prepare (sampleRateHz, numInputChannels, numOutputChannels, maxBlockSizeFrames);
     }
 
+    /// @brief Resets all the attached envelopes and the effect itself to initial state
+    /// @details This method is intended to be called by DSP hosts like @ref hart::AudioTestBuilder or @ref hart::Signal.
+    /// Unlike @ref reset(), it also rewinds the automation, so that the audio produced afterwards is identical
+    /// to the one produced right after @ref prepareWithEnvelopes().
+    /// @attention If you're not making a custom host, you probably don't need to call this method.
+    void resetWithEnvelopes()
+    {
+        if (m_envelopes != nullptr)
+        {
+            for (auto& item : getUniqueEnvelopes())
+                item.second->reset();
+        }
+
+        reset();
+    }
+
     /// @brief Renders all the automation envelopes and processes the audio
     /// @details This method is intended to be called by DSP hosts like @ref hart::AudioTestBuilder @ref hart::Signal.
     /// If you're making something that owns an instance of a Signal and needs it to generate audio,
@@ -281,9 +302,32 @@ public:
     using SampleTypePublicAlias = SampleType;
 
 private:
-    std::unordered_map<int, std::unique_ptr<Envelope>> m_envelopes;
+    using Envelopes = std::unordered_map<int, std::unique_ptr<Envelope>>;
+
+    std::shared_ptr<Envelopes> m_envelopes;
     EnvelopeBuffers m_envelopeBuffers;
 
+    /// @brief Gets the attached envelopes for modifying them
+    /// @details If the envelopes are shared with other copies of this effect, this one gets its own copies of them first
+    Envelopes& getUniqueEnvelopes()
+    {
+        if (m_envelopes == nullptr)
+        {
+            m_envelopes = std::make_shared<Envelopes>();
+        }
+        else if (m_envelopes.use_count() > 1)
+        {
+            std::shared_ptr<Envelopes> uniqueEnvelopes = std::make_shared<Envelopes>();
+
+            for (const auto& item : *m_envelopes)
+                uniqueEnvelopes->emplace (item.first, item.second->copy());
+
+            m_envelopes = std::move (uniqueEnvelopes);
+        }
+
+        return *m_envelopes;
+    }
+
     /// @brief Gets sample-accurate automation envelope values for a specific parameter
     /// @param[in] paramId Some ID that your subclass understands
     /// @param[in] blockSize Buffer size in frames, should be the same as ```input```/```output```'s size in @ref process()
@@ -303,7 +347,7 @@ private:
         }
         else
         {
-            m_envelopes[paramId]->renderNextBlock (blockSize, valuesOutput);
+            getUniqueEnvelopes()[paramId]->renderNextBlock (blockSize, valuesOutput);
         }
     }
 };
@@ -1,5 +1,16 @@
 #pragma once
 
+#include "dsp/hart_biquad.hpp"
+#include "dsp/hart_bpf.hpp"
+#include "dsp/hart_convolver.hpp"
+#include "dsp/hart_delay.hpp"
 #include "dsp/hart_gaindb.hpp"
 #include "dsp/hart_gainlinear.hpp"
 #include "dsp/hart_hardclip.hpp"
+#include "dsp/hart_high_shelf.hpp"
+#include "dsp/hart_hpf.hpp"
+#include "dsp/hart_low_shelf.hpp"
+#include "dsp/hart_lpf.hpp"
+#include "dsp/hart_matrix.hpp"
+#include "dsp/hart_oversampled.hpp"
+#include "dsp/hart_peaking_eq.hpp"
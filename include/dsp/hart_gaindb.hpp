@@ -49,6 +49,19 @@ public:
         const bool hasGainEnvelope = ! envelopeBuffers.empty() && contains (envelopeBuffers, (int) Params::gainDb);
         const bool multiplexerMode = numInputChannels != numOutputChannels;
 
+        // Silence stays silent no matter the gain, and a constant stays constant unless the gain is automated
+        if (input.isSilent())
+        {
+            output.fillSilence();
+            return;
+        }
+
+        if (input.isConstant() && ! hasGainEnvelope)
+        {
+            output.fillConstant (input.getConstantValue() * (SampleType) m_gainLinear);
+            return;
+        }
+
         if (hasGainEnvelope)
         {
             auto& gainEnvelopeValuesDb = envelopeBuffers. at(Params::gainDb);
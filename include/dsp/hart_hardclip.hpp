@@ -42,6 +42,12 @@ public:
         if (input.getNumChannels() != output.getNumChannels())
             HART_THROW_OR_RETURN_VOID (hart::ChannelLayoutError, "Unsupported channel configuration");
 
+        if (input.isConstant())
+        {
+            output.fillConstant (std::min (std::max (input.getConstantValue(), (SampleType) -m_thresholdLinear), (SampleType) m_thresholdLinear));
+            return;
+        }
+
         for (size_t channel = 0; channel < numChannels; ++channel)
             for (size_t frame = 0; frame < numFrames; ++frame)
                 output[channel][frame] = std::min (std::max (input[channel][frame], (SampleType) -m_thresholdLinear), (SampleType) m_thresholdLinear);
@@ -0,0 +1,38 @@
+#pragma once
+
+#include "dsp/hart_biquad.hpp"
+#include "hart_precision.hpp"
+
+namespace hart
+{
+
+/// @brief High shelf filter
+/// @details Boosts or cuts everything above the corner frequency
+/// @see Biquad
+/// @ingroup DSP
+template <typename SampleType>
+class HighShelf:
+    public Biquad<SampleType>
+{
+public:
+    /// @brief Constructor
+    /// @param cornerHz Corner frequency in Hz, at which the gain is half of the shelf gain in decibels
+    /// @param gainDb Shelf gain in decibels
+    /// @param q Resonance (Q factor), values above Butterworth Q make the shelf overshoot
+    HighShelf (double cornerHz = 1000.0, double gainDb = 0.0, double q = Biquad<SampleType>::butterworthQ):
+        Biquad<SampleType> (Biquad<SampleType>::Type::highShelf, cornerHz, q, gainDb)
+    {
+    }
+
+    void represent (std::ostream& stream) const override
+    {
+        stream << "HighShelf ("
+            << hzPrecision << this->m_initialFrequencyHz << "_Hz, "
+            << dbPrecision << this->m_initialGainDb << "_dB, "
+            << linPrecision << this->m_initialQ << ")";
+    }
+
+    HART_DSP_DEFINE_COPY_AND_MOVE (HighShelf);
+};
+
+}  // namespace hart
@@ -0,0 +1,37 @@
+#pragma once
+
+#include "dsp/hart_biquad.hpp"
+#include "hart_precision.hpp"
+
+namespace hart
+{
+
+/// @brief Low pass filter
+/// @details Second order filter by default, with Q of a Butterworth filter, which can be changed with @ref Biquad::q.
+/// Higher orders make a Butterworth filter, with a slope of 6dB/octave per order.
+/// @see Biquad
+/// @ingroup DSP
+template <typename SampleType>
+class LPF:
+    public Biquad<SampleType>
+{
+public:
+    /// @brief Constructor
+    /// @param cutoffHz Cutoff frequency in Hz
+    /// @param order Filter order, the slope is 6dB/octave per order
+    LPF (double cutoffHz = 1000.0, size_t order = 2):
+        Biquad<SampleType> (Biquad<SampleType>::Type::lowPass, cutoffHz, Biquad<SampleType>::butterworthQ, 0.0, order)
+    {
+    }
+
+    void represent (std::ostream& stream) const override
+    {
+        stream << "LPF ("
+            << hzPrecision << this->m_initialFrequencyHz << "_Hz, "
+            << this->m_order << ")";
+    }
+
+    HART_DSP_DEFINE_COPY_AND_MOVE (LPF);
+};
+
+}  // namespace hart
@@ -0,0 +1,244 @@
+#pragma once
+
+#include <algorithm>  // copy(), fill()
+#include <vector>
+
+#include "hart_dsp.hpp"
+#include "hart_exceptions.hpp"
+#include "hart_precision.hpp"
+#include "hart_utils.hpp"
+
+namespace hart
+{
+
+/// @brief Mixes the input channels into the output channels with a matrix of gains
+/// @details Handy for downmixing, upmixing, swapping or muting channels. Each output channel is a sum of
+/// input channels, each multiplied by its own linear gain. Every gain in the matrix is a parameter that can be set
+/// or automated on its own, see @ref getParamId(). Fixed zero gains are skipped entirely, and fixed unity gains are
+/// just copied over, so pure routing matrices with lots of channels cost next to nothing.
+/// @ingroup DSP
+template <typename SampleType>
+class Matrix:
+    public hart::DSP<SampleType>
+{
+public:
+    /// @brief Constructor
+    /// @param gainsLinear Linear gains for each output channel, for each input channel, like
+    /// @code {{1.0, 0.0}, {0.0, 1.0}} @endcode for a stereo pass-through. All the rows must be the same size.
+    Matrix (const std::vector<std::vector<double>>& gainsLinear):
+        m_numOutputChannels (gainsLinear.size()),
+        m_numInputChannels (gainsLinear.empty() ? 0 : gainsLinear[0].size()),
+        m_inputCopy (m_numInputChannels)
+    {
+        if (m_numOutputChannels == 0 || m_numInputChannels == 0)
+            HART_THROW_OR_RETURN_VOID (hart::ValueError, "Matrix must have at least one input and one output channel");
+
+        for (const std::vector<double>& row : gainsLinear)
+        {
+            if (row.size() != m_numInputChannels)
+                HART_THROW_OR_RETURN_VOID (hart::ValueError, "All rows of the matrix must have the same number of input channels");
+
+            m_gainsLinear.insert (m_gainsLinear.end(), row.begin(), row.end());
+        }
+
+        m_initialGainsLinear = m_gainsLinear;
+        updateRoutes();
+    }
+
+    /// @brief Returns the parameter id of a single gain in the matrix
+    /// @details Use it for @ref setValue() or @ref withEnvelope(), the values are linear gains
+    /// @param outputChannel Output channel (row)
+    /// @param inputChannel Input channel (column)
+    int getParamId (size_t outputChannel, size_t inputChannel) const
+    {
+        return static_cast<int> (outputChannel * m_numInputChannels + inputChannel);
+    }
+
+    void prepare (double /* sampleRateHz */, size_t /* numInputChannels */, size_t /* numOutputChannels */, size_t maxBlockSizeFrames) override
+    {
+        m_inputCopy.resize (maxBlockSizeFrames);
+        updateRoutes();
+    }
+
+    void process (const AudioBuffer<SampleType>& input, AudioBuffer<SampleType>& output, const EnvelopeBuffers& envelopeBuffers) override
+    {
+        const size_t numFrames = input.getNumFrames();
+        hassert (output.getNumFrames() == numFrames);
+
+        if (! supportsChannelLayout (input.getNumChannels(), output.getNumChannels()))
+            HART_THROW_OR_RETURN_VOID (hart::ChannelLayoutError, "Unsupported channel configuration");
+
+        if (input.isSilent())
+        {
+            output.fillSilence();
+            return;
+        }
+
+        // Output channels get overwritten one by one, but each of them may need all the input channels
+        const AudioBuffer<SampleType>* source = &input;
+
+        if (&input == &output)
+        {
+            m_inputCopy.resize (numFrames);
+            m_inputCopy.copyFrom (input, 0);
+            source = &m_inputCopy;
+        }
+
+        for (size_t outputChannel = 0; outputChannel < m_numOutputChannels; ++outputChannel)
+        {
+            SampleType* outputFrames = output[outputChannel];
+            const std::vector<Route>& routes = m_routes[outputChannel];
+
+            if (routes.empty())
+            {
+                std::fill (outputFrames, outputFrames + numFrames, (SampleType) 0);
+                continue;
+            }
+
+            for (size_t i = 0; i < routes.size(); ++i)
+            {
+                const Route& route = routes[i];
+                const SampleType* inputFrames = (*source)[route.inputChannel];
+                const bool isFirstRoute = i == 0;
+
+                if (route.isAutomated)
+                    mixAutomated (inputFrames, outputFrames, numFrames, envelopeBuffers.at (getParamId (outputChannel, route.inputChannel)), isFirstRoute);
+                else
+                    mix (inputFrames, outputFrames, numFrames, (SampleType) route.gainLinear, isFirstRoute);
+            }
+        }
+    }
+
+    void reset() override {}
+
+    /// @param id Id of the gain, see @ref getParamId()
+    /// @param value Linear gain
+    void setValue (int id, double value) override
+    {
+        if (isValidParamId (id))
+        {
+            m_gainsLinear[id] = value;
+            updateRoutes();
+        }
+    }
+
+    /// @param id Id of the gain, see @ref getParamId()
+    /// @retval (value) Linear gain
+    double getValue (int id) const override
+    {
+        if (isValidParamId (id))
+            return m_gainsLinear[id];
+
+        return 0.0;
+    }
+
+    /// @details Supports only the channel layout of the matrix
+    bool supportsChannelLayout (size_t numInputChannels, size_t numOutputChannels) const override
+    {
+        return numInputChannels == m_numInputChannels && numOutputChannels == m_numOutputChannels;
+    }
+
+    void represent (std::ostream& stream) const override
+    {
+        stream << linPrecision << "Matrix ({";
+
+        for (size_t outputChannel = 0; outputChannel < m_numOutputChannels; ++outputChannel)
+        {
+            stream << (outputChannel == 0 ? "{" : ", {");
+
+            for (size_t inputChannel = 0; inputChannel < m_numInputChannels; ++inputChannel)
+                stream << (inputChannel == 0 ? "" : ", ") << m_initialGainsLinear[getParamId (outputChannel, inputChannel)];
+
+            stream << '}';
+        }
+
+        stream << "})";
+    }
+
+    /// @details Every gain in the matrix can be automated
+    bool supportsEnvelopeFor (int id) const override
+    {
+        return isValidParamId (id);
+    }
+
+    HART_DSP_DEFINE_COPY_AND_MOVE (Matrix);
+
+private:
+    /// @brief Input channel that goes into an output channel
+    struct Route
+    {
+        size_t inputChannel;
+        double gainLinear;
+        bool isAutomated;
+    };
+
+    size_t m_numOutputChannels;
+    size_t m_numInputChannels;
+    AudioBuffer<SampleType> m_inputCopy;
+    std::vector<double> m_initialGainsLinear;
+    std::vector<double> m_gainsLinear;
+
+    /// @brief Routes for each output channel, without the ones that are always muted
+    std::vector<std::vector<Route>> m_routes;
+
+    bool isValidParamId (int id) const
+    {
+        return id >= 0 && static_cast<size_t> (id) < m_gainsLinear.size();
+    }
+
+    void updateRoutes()
+    {
+        m_routes.assign (m_numOutputChannels, std::vector<Route>());
+
+        for (size_t outputChannel = 0; outputChannel < m_numOutputChannels; ++outputChannel)
+        {
+            for (size_t inputChannel = 0; inputChannel < m_numInputChannels; ++inputChannel)
+            {
+                const int paramId = getParamId (outputChannel, inputChannel);
+                const bool isAutomated = this->hasEnvelopeFor (paramId);
+
+                if (isAutomated || m_gainsLinear[paramId] != 0.0)
+                    m_routes[outputChannel].push_back ({ inputChannel, m_gainsLinear[paramId], isAutomated });
+            }
+        }
+    }
+
+    static void mix (const SampleType* input, SampleType* output, size_t numFrames, SampleType gainLinear, bool shouldOverwrite)
+    {
+        if (shouldOverwrite && gainLinear == (SampleType) 1)
+        {
+            std::copy (input, input + numFrames, output);
+        }
+        else if (shouldOverwrite)
+        {
+            for (size_t frame = 0; frame < numFrames; ++frame)
+                output[frame] = input[frame] * gainLinear;
+        }
+        else if (gainLinear == (SampleType) 1)
+        {
+            for (size_t frame = 0; frame < numFrames; ++frame)
+                output[frame] += input[frame];
+        }
+        else
+        {
+            for (size_t frame = 0; frame < numFrames; ++frame)
+                output[frame] += input[frame] * gainLinear;
+        }
+    }
+
+    static void mixAutomated (const SampleType* input, SampleType* output, size_t numFrames, const std::vector<double>& gainsLinear, bool shouldOverwrite)
+    {
+        if (shouldOverwrite)
+        {
+            for (size_t frame = 0; frame < numFrames; ++frame)
+                output[frame] = input[frame] * (SampleType) gainsLinear[frame];
+        }
+        else
+        {
+            for (size_t frame = 0; frame < numFrames; ++frame)
+                output[frame] += input[frame] * (SampleType) gainsLinear[frame];
+        }
+    }
+};
+
+}  // namespace hart
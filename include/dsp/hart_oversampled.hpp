@@ -0,0 +1,252 @@
+#pragma once
+
+#include <algorithm>  // copy(), swap()
+#include <memory>
+#include <type_traits>
+#include <utility>  // forward(), move()
+#include <vector>
+
+#include "hart_dsp.hpp"
+#include "hart_exceptions.hpp"
+#include "hart_halfband_filter.hpp"
+#include "hart_utils.hpp"  // make_unique()
+
+namespace hart
+{
+
+/// @brief Runs another DSP effect at a multiple of the sample rate
+/// @details Upsamples the input, processes it with the wrapped effect at the higher sample rate, and downsamples
+/// the result back, so that nonlinear effects like @ref HardClip alias a lot less. The resampling is done in 2x steps,
+/// each with a polyphase half-band FIR filter, the first of which is the steepest one, as it's the one that has to cut
+/// right below the original Nyquist frequency. The wrapped effect is prepared with the multiplied sample rate and block
+/// size, and its automation envelopes get rendered at the higher sample rate too, so attach them to the wrapped effect
+/// itself. Parameter values are passed through to the wrapped effect as well.
+/// @note The filters delay the signal, see @ref getLatencyFrames()
+/// @ingroup DSP
+template <typename SampleType>
+class Oversampled:
+    public hart::DSP<SampleType>
+{
+public:
+    /// @brief Wraps a copy of the effect
+    /// @param dsp Effect to run at the higher sample rate
+    /// @param factor Oversampling factor: 2, 4, 8 or 16
+    Oversampled (const DSP<SampleType>& dsp, size_t factor = 2):
+        Oversampled (dsp.copy(), factor)
+    {
+    }
+
+    /// @brief Wraps the effect by moving it
+    /// @param dsp Effect to run at the higher sample rate
+    /// @param factor Oversampling factor: 2, 4, 8 or 16
+    template <
+        typename DerivedDSP,
+        typename = typename std::enable_if<
+            std::is_base_of<DSP<SampleType>, typename std::decay<DerivedDSP>::type>::value
+            && ! std::is_same<Oversampled, typename std::decay<DerivedDSP>::type>::value
+            >::type
+        >
+    Oversampled (DerivedDSP&& dsp, size_t factor = 2):
+        Oversampled (hart::make_unique<typename std::decay<DerivedDSP>::type> (std::forward<DerivedDSP> (dsp)), factor)
+    {
+    }
+
+    /// @brief Wraps the effect by taking over the pointer
+    /// @param dsp Effect to run at the higher sample rate
+    /// @param factor Oversampling factor: 2, 4, 8 or 16
+    Oversampled (std::unique_ptr<DSP<SampleType>> dsp, size_t factor = 2):
+        m_dsp (std::move (dsp)),
+        m_factor (factor)
+    {
+        if (m_dsp == nullptr)
+            HART_THROW_OR_RETURN_VOID (hart::ValueError, "Oversampled effect can't be null");
+
+        if (factor < 2 || factor > 16 || (factor & (factor - 1)) != 0)
+            HART_THROW_OR_RETURN_VOID (hart::ValueError, "Oversampling factor must be 2, 4, 8 or 16");
+
+        for (size_t stageFactor = 2; stageFactor <= factor; stageFactor *= 2)
+            ++m_numStages;
+    }
+
+    Oversampled (const Oversampled& other):
+        DSP<SampleType> (other),
+        m_dsp (other.m_dsp->copy()),
+        m_factor (other.m_factor),
+        m_numStages (other.m_numStages)
+    {
+    }
+
+    Oversampled (Oversampled&& other) = default;
+
+    Oversampled& operator= (const Oversampled& other)
+    {
+        if (this != &other)
+        {
+            DSP<SampleType>::operator= (other);
+            m_dsp = other.m_dsp->copy();
+            m_factor = other.m_factor;
+            m_numStages = other.m_numStages;
+            m_upsamplers.clear();
+            m_downsamplers.clear();
+        }
+
+        return *this;
+    }
+
+    Oversampled& operator= (Oversampled&& other) = default;
+
+    void prepare (double sampleRateHz, size_t numInputChannels, size_t numOutputChannels, size_t maxBlockSizeFrames) override
+    {
+        const size_t maxOversampledBlockSizeFrames = maxBlockSizeFrames * m_factor;
+        m_dsp->prepareWithEnvelopes (sampleRateHz * m_factor, numInputChannels, numOutputChannels, maxOversampledBlockSizeFrames);
+
+        m_oversampledInput = hart::make_unique<AudioBuffer<SampleType>> (numInputChannels, maxOversampledBlockSizeFrames);
+        m_oversampledOutput = hart::make_unique<AudioBuffer<SampleType>> (numOutputChannels, maxOversampledBlockSizeFrames);
+        m_framesA.resize (maxOversampledBlockSizeFrames);
+        m_framesB.resize (maxOversampledBlockSizeFrames);
+        m_upsamplers.assign (numInputChannels, makeStages());
+        m_downsamplers.assign (numOutputChannels, makeStages());
+    }
+
+    void process (const AudioBuffer<SampleType>& input, AudioBuffer<SampleType>& output, const EnvelopeBuffers& /* envelopeBuffers */) override
+    {
+        const size_t numFrames = input.getNumFrames();
+        const size_t numOversampledFrames = numFrames * m_factor;
+        hassert (output.getNumFrames() == numFrames);
+        hassert (numOversampledFrames <= m_framesA.size());
+
+        m_oversampledInput->resize (numOversampledFrames);
+        m_oversampledOutput->resize (numOversampledFrames);
+
+        for (size_t channel = 0; channel < input.getNumChannels(); ++channel)
+        {
+            std::copy (input[channel], input[channel] + numFrames, m_framesA.begin());
+            size_t numStageFrames = numFrames;
+
+            for (HalfBandFilter& stage : m_upsamplers[channel])
+            {
+                stage.upsample (m_framesA.data(), m_framesB.data(), numStageFrames);
+                std::swap (m_framesA, m_framesB);
+                numStageFrames *= 2;
+            }
+
+            std::copy (m_framesA.begin(), m_framesA.begin() + numOversampledFrames, (*m_oversampledInput)[channel]);
+        }
+
+        m_dsp->processWithEnvelopes (*m_oversampledInput, *m_oversampledOutput);
+
+        for (size_t channel = 0; channel < output.getNumChannels(); ++channel)
+        {
+            const SampleType* oversampledFrames = (*m_oversampledOutput)[channel];
+            std::copy (oversampledFrames, oversampledFrames + numOversampledFrames, m_framesA.begin());
+            size_t numStageFrames = numOversampledFrames;
+
+            // Same stages in reverse, from the highest sample rate down
+            for (size_t stage = m_numStages; stage > 0; --stage)
+            {
+                numStageFrames /= 2;
+                m_downsamplers[channel][stage - 1].downsample (m_framesA.data(), m_framesB.data(), numStageFrames);
+                std::swap (m_framesA, m_framesB);
+            }
+
+            for (size_t frame = 0; frame < numFrames; ++frame)
+                output[channel][frame] = static_cast<SampleType> (m_framesA[frame]);
+        }
+    }
+
+    void reset() override
+    {
+        m_dsp->resetWithEnvelopes();
+
+        for (std::vector<HalfBandFilter>& stages : m_upsamplers)
+            for (HalfBandFilter& stage : stages)
+                stage.reset();
+
+        for (std::vector<HalfBandFilter>& stages : m_downsamplers)
+            for (HalfBandFilter& stage : stages)
+                stage.reset();
+    }
+
+    /// @details Sets the value of the wrapped effect
+    void setValue (int id, double value) override
+    {
+        m_dsp->setValue (id, value);
+    }
+
+    /// @details Gets the value of the wrapped effect
+    double getValue (int id) const override
+    {
+        return m_dsp->getValue (id);
+    }
+
+    /// @details Supports the same channel layouts as the wrapped effect
+    bool supportsChannelLayout (size_t numInputChannels, size_t numOutputChannels) const override
+    {
+        return m_dsp->supportsChannelLayout (numInputChannels, numOutputChannels);
+    }
+
+    /// @details Supports the sample rates that the wrapped effect supports after multiplying them by the oversampling factor
+    bool supportsSampleRate (double sampleRateHz) const override
+    {
+        return m_dsp->supportsSampleRate (sampleRateHz * m_factor);
+    }
+
+    void represent (std::ostream& stream) const override
+    {
+        stream << "Oversampled (" << *m_dsp << ", " << m_factor << ')';
+    }
+
+    /// @brief Returns the delay added by the resampling filters
+    /// @details Doesn't include the latency of the wrapped effect itself. With more than 2x oversampling,
+    /// it's not a whole number of frames, as the filters of the later stages run at higher sample rates.
+    /// @return Latency in frames at the original sample rate
+    double getLatencyFrames() const
+    {
+        double latencyFrames = 0.0;
+        double stageFactor = 1.0;
+
+        for (size_t stage = 0; stage < m_numStages; ++stage)
+        {
+            stageFactor *= 2.0;
+            const HalfBandFilter filter (getNumDenseTaps (stage));
+            latencyFrames += 2.0 * filter.getLatencyFrames() / stageFactor;
+        }
+
+        return latencyFrames;
+    }
+
+    HART_DSP_DEFINE_COPY_AND_MOVE (Oversampled);
+
+private:
+    std::unique_ptr<DSP<SampleType>> m_dsp;
+    size_t m_factor;
+    size_t m_numStages = 0;
+
+    std::unique_ptr<AudioBuffer<SampleType>> m_oversampledInput;
+    std::unique_ptr<AudioBuffer<SampleType>> m_oversampledOutput;
+    std::vector<double> m_framesA;
+    std::vector<double> m_framesB;
+
+    /// @brief Resampling filters per channel, per stage, starting from the original sample rate
+    std::vector<std::vector<HalfBandFilter>> m_upsamplers;
+    std::vector<std::vector<HalfBandFilter>> m_downsamplers;
+
+    /// @details The first stage does all the heavy lifting, as it has to cut right below the original Nyquist frequency.
+    /// The later ones only have to get rid of the images above it, and there's lots of room for their transition bands.
+    static size_t getNumDenseTaps (size_t stage)
+    {
+        return stage == 0 ? 32 : 12;
+    }
+
+    std::vector<HalfBandFilter> makeStages() const
+    {
+        std::vector<HalfBandFilter> stages;
+
+        for (size_t stage = 0; stage < m_numStages; ++stage)
+            stages.emplace_back (getNumDenseTaps (stage));
+
+        return stages;
+    }
+};
+
+}  // namespace hart
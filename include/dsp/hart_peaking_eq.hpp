@@ -0,0 +1,38 @@
+#pragma once
+
+#include "dsp/hart_biquad.hpp"
+#include "hart_precision.hpp"
+
+namespace hart
+{
+
+/// @brief Peaking EQ (bell) filter
+/// @details Boosts or cuts the band around the center frequency, leaving the rest of the spectrum as is
+/// @see Biquad
+/// @ingroup DSP
+template <typename SampleType>
+class PeakingEQ:
+    public Biquad<SampleType>
+{
+public:
+    /// @brief Constructor
+    /// @param centerHz Center frequency in Hz
+    /// @param gainDb Gain at the center frequency in decibels
+    /// @param q Resonance (Q factor), higher values make the band narrower
+    PeakingEQ (double centerHz = 1000.0, double gainDb = 0.0, double q = Biquad<SampleType>::butterworthQ):
+        Biquad<SampleType> (Biquad<SampleType>::Type::peak, centerHz, q, gainDb)
+    {
+    }
+
+    void represent (std::ostream& stream) const override
+    {
+        stream << "PeakingEQ ("
+            << hzPrecision << this->m_initialFrequencyHz << "_Hz, "
+            << dbPrecision << this->m_initialGainDb << "_dB, "
+            << linPrecision << this->m_initialQ << ")";
+    }
+
+    HART_DSP_DEFINE_COPY_AND_MOVE (PeakingEQ);
+};
+
+}  // namespace hart
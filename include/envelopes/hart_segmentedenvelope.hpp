@@ -187,7 +187,8 @@ private:
             }
         }
 
-        if (m_currentSegmentIndex >= m_segments.size())
+        // An envelope with no segments just holds its start value
+        if (m_currentSegmentIndex >= m_segments.size() && ! m_segments.empty())
             m_currentValue = m_segments.back().targetValue;
     }
 };
@@ -12,6 +12,8 @@
 #include "envelopes/hart_envelopes_all.hpp"
 #include "hart_exceptions.hpp"
 #include "hart_expectation_failure_messages.hpp"
+#include "hart_fixture.hpp"
+#include "hart_fuzzer.hpp"
 #include "matchers/hart_matchers_all.hpp"
 #include "hart_process_audio.hpp"
 #include "signals/hart_signals_all.hpp"
@@ -48,15 +50,23 @@ namespace hart
     static void HART_UNIQUE_ID(HART_RunTask)()
 
 /// @brief Declares a test case with tags
-/// @warning Tags aren't supported yet
+/// @details Supported tags:
+/// - `[timeout=<seconds>]` overrides the `--timeout` CLI argument for this task, 0 disables the timeout
+/// - `[produces=<path>]` declares a file written by this task
+/// - `[consumes=<path>]` declares a file read by this task, so it only starts after all the tasks that produce it are done
+/// @warning Filtering by tags isn't supported yet
 /// @param name Name for the test case
 /// @param tags Tags like "[my-tag-1][my-tag-2]"
 /// @ingroup TestRunner
 #define HART_TEST_WITH_TAGS(name, tags) HART_ITEM_WITH_TAGS(name, tags, hart::TaskCategory::test)
 
 /// @brief Declares a generator with tags
-/// @details Pretty much the same as a usual test case, but will be called only if the `--run-generators` CLI flag is set
-/// @warning Tags aren't supported yet
+/// @details Pretty much the same as a usual test case, but will be called only if the `--run-generators` CLI flag is set.
+/// Supported tags:
+/// - `[timeout=<seconds>]` overrides the `--timeout` CLI argument for this task, 0 disables the timeout
+/// - `[produces=<path>]` declares a file written by this task
+/// - `[consumes=<path>]` declares a file read by this task, so it only starts after all the tasks that produce it are done
+/// @warning Filtering by tags isn't supported yet
 /// @param name Name for the generator
 /// @param tags Tags like "[my-tag-1][my-tag-2]"
 /// @ingroup TestRunner
@@ -73,6 +83,15 @@ namespace hart
 /// @ingroup TestRunner
 #define HART_GENERATE(name) HART_GENERATE_WITH_TAGS(name, "")
 
+/// @brief Declares a shared read-only fixture
+/// @details Use it like a ```struct``` declaration: do the expensive setup (decoding wav files, building impulse responses,
+/// etc.) in the constructor, and teardown, if needed, in the destructor. Then call ```MyFixture::get()``` inside of your tests
+/// to get a const reference to it. The fixture is set up on first use, exactly once, even when tests run in parallel,
+/// and gets torn down at the end of the test run.
+/// @param name Name for the fixture type
+/// @ingroup TestRunner
+#define HART_FIXTURE(name) struct name: public hart::Fixture<name>
+
 #if HART_DO_NOT_THROW_EXCEPTIONS
 /// @brief Put it at the beginning of your tese case if it requires a properly set data path
 /// @details For example, when using relative paths to the wav files. The test will instantly fail is the path is not set.
@@ -92,6 +111,7 @@ namespace hart
     do \
     { \
         hart::CLIConfig::getInstance().initCommandLineArgs(); \
+        hart::CLIConfig::getInstance().setExecutablePath (argv[0]); \
         CLI11_PARSE (hart::CLIConfig::getInstance().getCLIApp(), argc, argv); \
         return hart::TestRegistry::getInstance().runAll(); \
     } \
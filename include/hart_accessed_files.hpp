@@ -0,0 +1,35 @@
+#pragma once
+
+#include <string>
+#include <vector>
+
+namespace hart
+{
+
+/// @brief Keeps track of files accessed by the currently running test
+/// @details Every path resolved by @ref toAbsolutePath() ends up here, so that the result cache
+/// can tell when a test needs to be re-run because some of its data files have changed.
+/// @private
+class AccessedFiles {
+public:
+    static std::vector<std::string>& get()
+    {
+        thread_local std::vector<std::string> filePaths;
+        return filePaths;
+    }
+
+    static void add (const std::string& filePath)
+    {
+        get().emplace_back (filePath);
+    }
+
+    static void clear()
+    {
+        get().clear();
+    }
+
+private:
+    AccessedFiles() = default;
+};
+
+} // namespace hart
@@ -14,8 +14,11 @@ public:
     AudioBuffer (size_t numChannels = 0, size_t numFrames = 0) :
         m_numChannels (numChannels),
         m_numFrames (numFrames),
+        m_capacityFrames (numFrames),
         m_frames (m_numChannels * m_numFrames),
-        m_channelPointers (m_numChannels)
+        m_channelPointers (m_numChannels),
+        m_isConstant (true),
+        m_constantValue ((SampleType) 0)
     {
         updateChannelPointers();
     }
@@ -23,8 +26,11 @@ public:
     AudioBuffer(const AudioBuffer& other) :
         m_numChannels (other.m_numChannels),
         m_numFrames (other.m_numFrames),
+        m_capacityFrames (other.m_capacityFrames),
         m_frames (other.m_frames),
-        m_channelPointers (m_numChannels)
+        m_channelPointers (m_numChannels),
+        m_isConstant (other.m_isConstant),
+        m_constantValue (other.m_constantValue)
     {
         updateChannelPointers();
     }
@@ -32,8 +38,11 @@ public:
     AudioBuffer (AudioBuffer&& other) :
         m_numChannels (other.m_numChannels),
         m_numFrames (other.m_numFrames),
+        m_capacityFrames (other.m_capacityFrames),
         m_frames (std::move (other.m_frames)),
-        m_channelPointers (std::move (other.m_channelPointers))
+        m_channelPointers (std::move (other.m_channelPointers)),
+        m_isConstant (other.m_isConstant),
+        m_constantValue (other.m_constantValue)
     {
         other.clear();
     }
@@ -49,9 +58,12 @@ public:
             HART_THROW_OR_RETURN (hart::ChannelLayoutError, "Can't copy from a buffer with different number of channels", *this);
 
         m_numFrames = other.m_numFrames;
+        m_capacityFrames = other.m_capacityFrames;
         m_frames = other.m_frames;
         m_channelPointers.resize (m_numChannels);
         updateChannelPointers();
+        m_isConstant = other.m_isConstant;
+        m_constantValue = other.m_constantValue;
 
         return *this;
     }
@@ -65,8 +77,11 @@ public:
             HART_THROW_OR_RETURN (hart::ChannelLayoutError, "Can't move from a buffer with different number of channels", *this);
 
         m_numFrames = other.m_numFrames;
+        m_capacityFrames = other.m_capacityFrames;
         m_frames = std::move (other.m_frames);
         m_channelPointers = std::move (other.m_channelPointers);
+        m_isConstant = other.m_isConstant;
+        m_constantValue = other.m_constantValue;
         other.clear();
 
         return *this;
@@ -77,8 +92,11 @@ public:
         return static_cast<const SampleType* const*> (m_channelPointers.data());
     }
 
+    /// @brief Gives write access to all the channels
+    /// @details Unmarks the buffer as constant, see @ref isConstant()
     SampleType* const* getArrayOfWritePointers() 
     {
+        m_isConstant = false;
         return m_channelPointers.data();
     }
 
@@ -90,8 +108,11 @@ public:
     size_t getNumChannels() const { return m_numChannels; }
     size_t getNumFrames() const { return m_numFrames; }
 
+    /// @brief Gives write access to a channel
+    /// @details Unmarks the buffer as constant, see @ref isConstant()
     SampleType* operator[] (size_t channel)
     {
+        m_isConstant = false;
         return m_channelPointers[channel];
     }
 
@@ -119,14 +140,112 @@ public:
 
         m_frames = std::move (combinedFrames);
         m_numFrames += otherNumFrames;
+        m_capacityFrames = m_numFrames;
+        m_isConstant = isConstantLike (otherBuffer);
 
         updateChannelPointers();
     }
 
+    /// @brief Copies all frames of another buffer into this one, starting at a given frame
+    /// @details Unlike @ref appendFrom(), this never reallocates memory, so it's the way to go for filling
+    /// a buffer preallocated for the whole signal one block at a time.
+    /// @param otherBuffer Buffer to copy from, must have the same number of channels
+    /// @param startFrame Frame of this buffer to put the first frame of the other buffer to
+    void copyFrom (const AudioBuffer<SampleType>& otherBuffer, size_t startFrame)
+    {
+        if (otherBuffer.getNumChannels() != m_numChannels)
+            HART_THROW_OR_RETURN_VOID (hart::ChannelLayoutError, "Channel count mismatch");
+
+        if (startFrame + otherBuffer.getNumFrames() > m_numFrames)
+            HART_THROW_OR_RETURN_VOID (hart::IndexError, "Invalid frame range");
+
+        for (size_t channel = 0; channel < m_numChannels; ++channel)
+            std::copy (otherBuffer[channel], otherBuffer[channel] + otherBuffer.getNumFrames(), m_channelPointers[channel] + startFrame);
+
+        m_isConstant = isConstantLike (otherBuffer);
+    }
+
+    /// @brief Changes the number of frames in the buffer
+    /// @details Shrinking, or growing back within the previously allocated capacity, never reallocates memory,
+    /// so a buffer allocated once for the largest block size can be reused for blocks of any smaller size.
+    /// Existing frames are preserved, and the frames exposed by growing the buffer are filled with zeros.
+    /// @param numFrames New number of frames
+    void resize (size_t numFrames)
+    {
+        // Frames exposed by growing are zeros, so only silence stays constant
+        if (numFrames > m_numFrames && m_constantValue != (SampleType) 0)
+            m_isConstant = false;
+
+        if (numFrames > m_capacityFrames)
+        {
+            std::vector<SampleType> resizedFrames (m_numChannels * numFrames);
+
+            for (size_t channel = 0; channel < m_numChannels; ++channel)
+                std::copy (m_channelPointers[channel], m_channelPointers[channel] + m_numFrames, &resizedFrames[channel * numFrames]);
+
+            m_frames = std::move (resizedFrames);
+            m_capacityFrames = numFrames;
+            m_numFrames = numFrames;
+            updateChannelPointers();
+            return;
+        }
+
+        if (numFrames > m_numFrames)
+        {
+            for (size_t channel = 0; channel < m_numChannels; ++channel)
+                std::fill (m_channelPointers[channel] + m_numFrames, m_channelPointers[channel] + numFrames, (SampleType) 0);
+        }
+
+        m_numFrames = numFrames;
+    }
+
+    /// @brief Returns the number of frames the buffer can hold without reallocating memory
+    size_t getCapacityFrames() const { return m_capacityFrames; }
+
+    /// @brief Fills all the channels with the same value, and marks the buffer as constant
+    /// @details The marking lets signals, effects and matchers that are aware of it take shortcuts, like dealing with
+    /// a single value instead of the whole block. If the buffer is already marked as holding this very value, nothing
+    /// gets written at all, which makes long silent tails nearly free to render, process and check.
+    /// @param value Value for all the frames
+    void fillConstant (SampleType value)
+    {
+        if (m_isConstant && m_constantValue == value)
+            return;
+
+        for (size_t channel = 0; channel < m_numChannels; ++channel)
+            std::fill (m_channelPointers[channel], m_channelPointers[channel] + m_numFrames, value);
+
+        m_isConstant = true;
+        m_constantValue = value;
+    }
+
+    /// @brief Fills all the channels with zeros, and marks the buffer as silent
+    /// @see fillConstant()
+    void fillSilence()
+    {
+        fillConstant ((SampleType) 0);
+    }
+
+    /// @brief Checks if all the frames in all the channels are known to hold the same value
+    /// @details A buffer gets marked as constant by @ref fillConstant(), and when it's newly allocated (and holds zeros).
+    /// It gets unmarked as soon as its frames are accessed for writing, e.g. with non-const operator[].
+    /// So @c false doesn't mean that the frames differ, only that nobody has vouched for them being the same.
+    bool isConstant() const { return m_isConstant; }
+
+    /// @brief Checks if the buffer is known to hold nothing but zeros
+    /// @see isConstant()
+    bool isSilent() const { return m_isConstant && m_constantValue == (SampleType) 0; }
+
+    /// @brief Gets the value of all the frames of a constant buffer
+    /// @details Only meaningful if @ref isConstant() returns true
+    SampleType getConstantValue() const { return m_constantValue; }
+
     void clear()
     {
         m_numFrames = 0;
+        m_capacityFrames = 0;
         m_frames.clear();
+        m_isConstant = false;
 
         // If m_channelPointers was std::move'd, its size will be zero
         if (m_channelPointers.size() != m_numChannels)
@@ -143,6 +262,9 @@ public:
         if (startFrame + numFrames > m_numFrames || numFrames == 0)
             HART_THROW_OR_RETURN (hart::IndexError, "Invalid frame range", (SampleType) 0);
 
+        if (m_isConstant)
+            return std::abs (m_constantValue);
+
         const SampleType* start = m_channelPointers[channel] + startFrame;
         const SampleType* peakSample = std::max_element (
             start,
@@ -158,6 +280,9 @@ public:
         if (startFrame + numFrames > m_numFrames || numFrames == 0)
                 HART_THROW_OR_RETURN (hart::IndexError, "Invalid frame range", (SampleType) 0);
 
+        if (m_isConstant)
+            return std::abs (m_constantValue);
+
         SampleType peakSampleAcrossAllChannels = (SampleType) 0;
 
         for (size_t channel = 0; channel < m_numChannels; ++channel)
@@ -174,18 +299,25 @@ public:
         return peakSampleAcrossAllChannels;
     }
 
-    // TODO: Implement resize() and copyFrom() to avoid repeated memory re-allocations caused by spamming appendFrom()
-
 private:
     const size_t m_numChannels = 0;
     size_t m_numFrames = 0;
+    size_t m_capacityFrames = 0;
     std::vector<SampleType> m_frames;
     std::vector<SampleType*> m_channelPointers;
+    bool m_isConstant = false;
+    SampleType m_constantValue = (SampleType) 0;
+
+    /// @brief Checks if this buffer stays constant after getting frames from another one
+    bool isConstantLike (const AudioBuffer<SampleType>& otherBuffer) const
+    {
+        return m_isConstant && otherBuffer.m_isConstant && m_constantValue == otherBuffer.m_constantValue;
+    }
 
     void updateChannelPointers()
     {
         for (size_t channel = 0; channel < m_numChannels; ++channel)
-            m_channelPointers[channel] = m_numFrames > 0 ? &m_frames[channel * m_numFrames] : nullptr;
+            m_channelPointers[channel] = m_capacityFrames > 0 ? &m_frames[channel * m_capacityFrames] : nullptr;
     }
 };
 
@@ -0,0 +1,125 @@
+#pragma once
+
+#include <atomic>
+#include <thread>
+#include <vector>
+
+#include "hart_audio_buffer.hpp"
+
+namespace hart
+{
+
+/// @brief Passes audio blocks between the render, process and check threads of a pipelined test
+/// @details Used by @ref TestPlan when @ref AudioTestBuilder::withPipelining() is set. The blocks are preallocated
+/// slots in a ring, and each slot goes through the stages in order: the input gets rendered into it, then processed
+/// into its output, then checked, after which the slot is free to render the next input again. Each stage runs on
+/// its own thread and owns a counter of the slots it has finished, which only the neighbouring stages read,
+/// so it's essentially a chain of lock-free single producer, single consumer rings sharing the same slots.
+///
+/// A stage closes when it's done, whether it has finished all the blocks or given up halfway. The stages after it
+/// still get all the slots it has finished, so failures get reported exactly as if the blocks were run one by one,
+/// while the stages before it stop right away, as nobody is going to use what they make anyway.
+/// @private
+template <typename SampleType>
+class BlockPipeline
+{
+public:
+    enum class Stage
+    {
+        render,
+        process,
+        check
+    };
+
+    struct Slot
+    {
+        AudioBuffer<SampleType> input;
+        AudioBuffer<SampleType> output;
+        size_t offsetFrames = 0;
+
+        Slot (size_t numInputChannels, size_t numOutputChannels, size_t maxBlockSizeFrames):
+            input (numInputChannels, maxBlockSizeFrames),
+            output (numOutputChannels, maxBlockSizeFrames)
+        {
+        }
+    };
+
+    /// @param numSlots Number of blocks in flight, should be at least the number of stages for them to run in parallel
+    BlockPipeline (size_t numSlots, size_t numInputChannels, size_t numOutputChannels, size_t maxBlockSizeFrames)
+    {
+        m_slots.reserve (numSlots);
+
+        for (size_t i = 0; i < numSlots; ++i)
+            m_slots.emplace_back (numInputChannels, numOutputChannels, maxBlockSizeFrames);
+
+        reset();
+    }
+
+    /// @brief Gets the pipeline ready for a new run
+    /// @details Must not be called while any of the stages are running
+    void reset()
+    {
+        for (size_t stage = 0; stage < numStages; ++stage)
+        {
+            m_numFinishedSlots[stage].store (0);
+            m_isClosed[stage].store (false);
+        }
+    }
+
+    /// @brief Waits until the next slot is ready for the stage
+    /// @return Slot to work on, or nullptr if the stage should stop
+    Slot* waitForSlot (Stage stage)
+    {
+        const size_t stageIndex = static_cast<size_t> (stage);
+
+        while (true)
+        {
+            for (size_t laterStageIndex = stageIndex + 1; laterStageIndex < numStages; ++laterStageIndex)
+                if (m_isClosed[laterStageIndex].load (std::memory_order_acquire))
+                    return nullptr;
+
+            // Closing happens after finishing the last slot, so the slots get checked again after seeing a closed stage
+            const bool isPreviousStageClosed = stageIndex > 0 && m_isClosed[stageIndex - 1].load (std::memory_order_acquire);
+
+            if (isSlotReady (stageIndex))
+                return &m_slots[m_numFinishedSlots[stageIndex].load (std::memory_order_relaxed) % m_slots.size()];
+
+            if (isPreviousStageClosed)
+                return nullptr;
+
+            std::this_thread::yield();
+        }
+    }
+
+    /// @brief Hands the slot returned by the last @ref waitForSlot() call to the next stage
+    void release (Stage stage)
+    {
+        m_numFinishedSlots[static_cast<size_t> (stage)].fetch_add (1, std::memory_order_release);
+    }
+
+    /// @brief Tells the other stages that this stage won't finish any more slots
+    void close (Stage stage)
+    {
+        m_isClosed[static_cast<size_t> (stage)].store (true, std::memory_order_release);
+    }
+
+private:
+    static constexpr size_t numStages = 3;
+
+    std::vector<Slot> m_slots;
+    std::atomic<size_t> m_numFinishedSlots[numStages];
+    std::atomic<bool> m_isClosed[numStages];
+
+    bool isSlotReady (size_t stageIndex) const
+    {
+        const size_t numFinishedSlots = m_numFinishedSlots[stageIndex].load (std::memory_order_relaxed);
+
+        // Rendering needs a slot that has been checked, or has never been used
+        if (stageIndex == 0)
+            return numFinishedSlots - m_numFinishedSlots[numStages - 1].load (std::memory_order_acquire) < m_slots.size();
+
+        return numFinishedSlots < m_numFinishedSlots[stageIndex - 1].load (std::memory_order_acquire);
+    }
+};
+
+}  // namespace hart
@@ -0,0 +1,81 @@
+#pragma once
+
+#include <atomic>
+#include <string>
+
+namespace hart
+{
+
+/// @brief Reason why a running test was asked to stop
+/// @private
+enum class CancellationReason
+{
+    none,
+    timeout,
+    failFast
+};
+
+/// @brief Lets the test runner ask a running test to stop
+/// @details The test runner makes one for each task it runs, and sets it as current for the task's thread.
+/// Long loops like the one in @ref TestPlan::run() poll it at block boundaries and bail out with a test failure
+/// once it's cancelled, so a hanging test can't stall the whole run. Cancelling is thread-safe, polling is cheap.
+/// @private
+class CancellationToken
+{
+public:
+    /// @brief Asks the test to stop
+    /// @details Only the first reason is kept if called several times
+    void cancel (CancellationReason reason)
+    {
+        int expected = static_cast<int> (CancellationReason::none);
+        m_reason.compare_exchange_strong (expected, static_cast<int> (reason));
+    }
+
+    /// @brief Checks whether the test was asked to stop
+    bool isCancelled() const
+    {
+        return m_reason.load (std::memory_order_relaxed) != static_cast<int> (CancellationReason::none);
+    }
+
+    CancellationReason getReason() const
+    {
+        return static_cast<CancellationReason> (m_reason.load());
+    }
+
+    /// @brief Describes why the test was stopped, for the failure report
+    std::string describeReason() const
+    {
+        switch (getReason())
+        {
+            case CancellationReason::timeout: return "Test timed out";
+            case CancellationReason::failFast: return "Test was cancelled due to --fail-fast";
+            case CancellationReason::none: break;
+        }
+
+        return "Test was cancelled";
+    }
+
+    /// @brief Gets the token of the task running on this thread
+    /// @return Pointer to the token, or nullptr if there's none (e.g. when called outside of the test runner)
+    static CancellationToken* getCurrent()
+    {
+        return currentTokenSlot();
+    }
+
+    /// @brief Sets the token of the task running on this thread
+    static void setCurrent (CancellationToken* token)
+    {
+        currentTokenSlot() = token;
+    }
+
+private:
+    std::atomic<int> m_reason { static_cast<int> (CancellationReason::none) };
+
+    static CancellationToken*& currentTokenSlot()
+    {
+        thread_local CancellationToken* currentToken = nullptr;
+        return currentToken;
+    }
+};
+
+}  // namespace hart
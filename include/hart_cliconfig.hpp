@@ -52,7 +52,16 @@ public:
             )->default_val (1);
 
         app.add_flag ("--run-generators,-g", m_runGeneratorsNotTests, "Run generators instead of tests");
+        app.add_flag ("--run-all,-a", m_runAll, "Run generators and tests together. Tasks that consume files start as soon as the tasks that produce them are done.");
+        app.add_option ("--jobs,-j", m_numJobs, "Number of tasks to run in parallel")->default_val (1)->check (CLI::PositiveNumber);
         app.add_flag ("--shuffle", m_shuffle, "Shuffle task order. Obeys --seed value.");
+        app.add_option ("--cache-dir", m_cacheDir, "Directory for caching test results. Tests that have passed before are skipped, unless the test binary or their data files have changed.");
+        app.add_flag ("--no-cache", m_noCache, "Run all tests, even if their results are cached. The cache still gets updated.");
+        app.add_option ("--timeout", m_timeoutSeconds, "Default timeout for each test in seconds, 0 for no timeout. Can be overridden per test with a \"[timeout=<seconds>]\" tag.")->default_val (0);
+        app.add_option ("--duration-scale", m_durationScale, "Multiplies durations set with withDuration() in all tests, e.g. 0.1 for a smoke run or 10 for a soak run")->default_val (1)->check (CLI::PositiveNumber);
+        app.add_option ("--max-duration", m_maxDurationSeconds, "Upper limit in seconds for durations set with withDuration() in all tests, applied after --duration-scale. 0 for no limit.")->default_val (0)->check (CLI::NonNegativeNumber);
+        app.add_flag ("--fail-fast", m_failFast, "Stop after the first failed task. Tasks that are already running get cancelled at the next block boundary.");
+        app.add_option ("--repeat", m_numRepeats, "Run each task this many times, and report pass rate and duration statistics")->default_val (1)->check (CLI::PositiveNumber);
     }
 
     CLI::App& getCLIApp() { return app; }
@@ -76,8 +85,31 @@ public:
     int getRadDecimals() { return m_radDecimals; }
 
     bool shouldRunGenerators() { return m_runGeneratorsNotTests; }
+    bool shouldRunAll() { return m_runAll; }
+    size_t getNumJobs() { return m_numJobs; }
     bool shouldShuffleTasks() { return m_shuffle; }
 
+    /// @brief Directory for the result cache, empty if caching is disabled
+    std::string getCacheDir() { return m_cacheDir; }
+    bool shouldUseCachedResults() { return ! m_noCache; }
+
+    /// @brief Default timeout for each task, 0 if there's no timeout
+    double getTimeoutSeconds() { return m_timeoutSeconds; }
+
+    bool shouldFailFast() { return m_failFast; }
+
+    /// @see AudioTestBuilder::withDuration()
+    double getDurationScale() { return m_durationScale; }
+
+    /// @brief Upper limit for the scaled durations, 0 if there's no limit
+    /// @see AudioTestBuilder::withDuration()
+    double getMaxDurationSeconds() { return m_maxDurationSeconds; }
+    size_t getNumRepeats() { return m_numRepeats; }
+
+    /// @brief Path to the test binary, as it was invoked
+    std::string getExecutablePath() { return m_executablePath; }
+    void setExecutablePath (const std::string& executablePath) { m_executablePath = executablePath; }
+
 private:
     CLI::App app { "HART" };
 
@@ -85,7 +117,17 @@ private:
     std::string m_tags = "";
     uint_fast32_t m_seed = 0;
     bool m_runGeneratorsNotTests = false;
+    bool m_runAll = false;
+    size_t m_numJobs = 1;
     bool m_shuffle = false;
+    std::string m_cacheDir = "";
+    bool m_noCache = false;
+    std::string m_executablePath = "";
+    double m_timeoutSeconds = 0.0;
+    bool m_failFast = false;
+    double m_durationScale = 1.0;
+    double m_maxDurationSeconds = 0.0;
+    size_t m_numRepeats = 1;
 
     int m_linDecimals = 0;
     int m_dbDecimals = 0;
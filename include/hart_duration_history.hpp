@@ -0,0 +1,85 @@
+#pragma once
+
+#include <fstream>
+#include <iomanip>
+#include <limits>
+#include <string>
+#include <unordered_map>
+
+namespace hart
+{
+
+/// @brief Remembers how long each task took during the previous runs
+/// @details Used by @ref TestRegistry to start the longest tasks first when running them in parallel,
+/// which keeps a few long soak tests from being started last and dominating the total run time.
+/// The history is a plain text file with one "<seconds> <task key>" line per task.
+/// @private
+class DurationHistory
+{
+public:
+    /// @brief Loads the history file, if there is one
+    /// @param historyFilePath Path to the file to load the durations from and save them to
+    void load (const std::string& historyFilePath)
+    {
+        m_historyFilePath = historyFilePath;
+        m_durationsSeconds.clear();
+
+        std::ifstream file (historyFilePath);
+
+        if (! file.is_open())
+            return;
+
+        double durationSeconds = 0.0;
+
+        while (file >> durationSeconds)
+        {
+            file.ignore (1);  // Separator
+            std::string taskKey;
+
+            if (! std::getline (file, taskKey))
+                break;
+
+            m_durationsSeconds[taskKey] = durationSeconds;
+        }
+    }
+
+    /// @brief Gets the duration of the task from the previous runs
+    /// @return Duration in seconds, or a negative value if the task is not in the history
+    double getDurationSeconds (const std::string& taskKey) const
+    {
+        const auto it = m_durationsSeconds.find (taskKey);
+        return it == m_durationsSeconds.end() ? -1.0 : it->second;
+    }
+
+    /// @brief Stores the duration of the task from the current run
+    void record (const std::string& taskKey, double durationSeconds)
+    {
+        m_durationsSeconds[taskKey] = durationSeconds;
+    }
+
+    /// @brief Writes the history to the file it was loaded from
+    /// @return true if the file was written successfully, false otherwise
+    bool save() const
+    {
+        if (m_historyFilePath.empty())
+            return false;
+
+        std::ofstream file (m_historyFilePath, std::ios::trunc);
+
+        if (! file.is_open())
+            return false;
+
+        file << std::setprecision (std::numeric_limits<double>::max_digits10);
+
+        for (const auto& item : m_durationsSeconds)
+            file << item.second << ' ' << item.first << '\n';
+
+        return file.good();
+    }
+
+private:
+    std::string m_historyFilePath;
+    std::unordered_map<std::string, double> m_durationsSeconds;
+};
+
+}  // namespace hart
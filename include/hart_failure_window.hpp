@@ -0,0 +1,211 @@
+#pragma once
+
+#include <algorithm>  // copy(), min()
+
+#include "hart_audio_buffer.hpp"
+
+namespace hart
+{
+
+/// @brief Keeps the audio around the first failure of a test
+/// @details Used by @ref TestPlan when @ref AudioTestBuilder::withFailureWindow() is set. Instead of keeping the whole
+/// signal, it keeps a ring with the last few blocks of input, output and reference audio. Once the first failure is
+/// reported, it takes the frames preceding it out of the ring, and then collects the frames following it as they get
+/// rendered. All the memory is allocated once, in the constructor.
+/// @private
+template <typename SampleType>
+class FailureWindow
+{
+public:
+    /// @param numInputChannels Number of input channels
+    /// @param numOutputChannels Number of output channels, also used for the reference audio
+    /// @param maxBlockSizeFrames Largest block that will be pushed
+    /// @param preFrames Number of frames to keep before the failed frame
+    /// @param postFrames Number of frames to keep after the failed frame
+    FailureWindow (size_t numInputChannels, size_t numOutputChannels, size_t maxBlockSizeFrames, size_t preFrames, size_t postFrames):
+        m_preFrames (preFrames),
+        m_postFrames (postFrames),
+        m_inputHistory (numInputChannels, preFrames + maxBlockSizeFrames),
+        m_outputHistory (numOutputChannels, preFrames + maxBlockSizeFrames),
+        m_referenceHistory (numOutputChannels, preFrames + maxBlockSizeFrames),
+        m_inputWindow (numInputChannels, preFrames + postFrames + 1),
+        m_outputWindow (numOutputChannels, preFrames + postFrames + 1),
+        m_referenceWindow (numOutputChannels, preFrames + postFrames + 1)
+    {
+        reset();
+    }
+
+    /// @brief Forgets everything captured so far
+    void reset()
+    {
+        m_state = State::waitingForFailure;
+        m_numFramesPushed = 0;
+        m_failureFrame = 0;
+        m_windowStartFrame = 0;
+        m_windowEndFrame = 0;
+        m_hasReference = false;
+        m_inputWindow.resize (0);
+        m_outputWindow.resize (0);
+        m_referenceWindow.resize (0);
+    }
+
+    /// @brief Reports a failure
+    /// @details Only the first failure counts, the rest are ignored
+    /// @param failureFrame Index of the failed frame, counting from the start of the signal
+    void markFailure (size_t failureFrame)
+    {
+        if (m_state != State::waitingForFailure)
+            return;
+
+        m_failureFrame = failureFrame;
+        m_windowStartFrame = failureFrame > m_preFrames ? failureFrame - m_preFrames : 0;
+        m_windowEndFrame = failureFrame + m_postFrames + 1;
+        m_state = State::failurePending;
+    }
+
+    /// @brief Takes the next block of audio
+    /// @details Should be called after the checks for that block have reported their failures, if any
+    /// @param input Input block
+    /// @param output Output block
+    /// @param reference Reference block, or nullptr if the test has no reference signal
+    void pushBlock (const AudioBuffer<SampleType>& input, const AudioBuffer<SampleType>& output, const AudioBuffer<SampleType>* reference)
+    {
+        const size_t blockStartFrame = m_numFramesPushed;
+        const size_t blockSizeFrames = output.getNumFrames();
+        m_numFramesPushed += blockSizeFrames;
+
+        if (m_state == State::collecting)
+        {
+            const size_t numFrames = std::min (blockSizeFrames, m_windowEndFrame - blockStartFrame);
+            appendToWindow (m_inputWindow, input, 0, numFrames);
+            appendToWindow (m_outputWindow, output, 0, numFrames);
+
+            if (m_hasReference)
+                appendToWindow (m_referenceWindow, *reference, 0, numFrames);
+
+            updateState();
+            return;
+        }
+
+        if (m_state == State::complete)
+            return;
+
+        m_hasReference = reference != nullptr;
+        writeToHistory (m_inputHistory, input, blockStartFrame);
+        writeToHistory (m_outputHistory, output, blockStartFrame);
+
+        if (m_hasReference)
+            writeToHistory (m_referenceHistory, *reference, blockStartFrame);
+
+        if (m_state == State::failurePending)
+        {
+            const size_t numFrames = std::min (m_numFramesPushed, m_windowEndFrame) - m_windowStartFrame;
+            readFromHistory (m_inputWindow, m_inputHistory, numFrames);
+            readFromHistory (m_outputWindow, m_outputHistory, numFrames);
+
+            if (m_hasReference)
+                readFromHistory (m_referenceWindow, m_referenceHistory, numFrames);
+
+            m_state = State::collecting;
+            updateState();
+        }
+    }
+
+    /// @brief Cuts the window out of the full signal
+    /// @details For failures reported after the whole signal has been rendered, like the ones from
+    /// the matchers that can't operate per block. Does nothing if the window has already been captured.
+    void cutFrom (const AudioBuffer<SampleType>& fullInput, const AudioBuffer<SampleType>& fullOutput)
+    {
+        if (m_state != State::failurePending)
+            return;
+
+        m_hasReference = false;
+        const size_t numFrames = std::min (fullOutput.getNumFrames(), m_windowEndFrame) - m_windowStartFrame;
+        m_inputWindow.resize (0);
+        m_outputWindow.resize (0);
+        appendToWindow (m_inputWindow, fullInput, m_windowStartFrame, numFrames);
+        appendToWindow (m_outputWindow, fullOutput, m_windowStartFrame, numFrames);
+        m_state = State::complete;
+    }
+
+    /// @brief Checks if the window has been fully captured, so there's no need to push any more blocks
+    bool isComplete() const { return m_state == State::complete; }
+
+    /// @brief Checks if there's any captured audio
+    bool hasCapture() const { return m_state == State::collecting || m_state == State::complete; }
+
+    /// @brief Checks if the reference audio was captured
+    bool hasReference() const { return m_hasReference; }
+
+    /// @brief Gets the index of the first frame of the window, counting from the start of the signal
+    size_t getStartFrame() const { return m_windowStartFrame; }
+
+    /// @brief Gets the index of the first failed frame, counting from the start of the signal
+    size_t getFailureFrame() const { return m_failureFrame; }
+
+    const AudioBuffer<SampleType>& getInput() const { return m_inputWindow; }
+    const AudioBuffer<SampleType>& getOutput() const { return m_outputWindow; }
+    const AudioBuffer<SampleType>& getReference() const { return m_referenceWindow; }
+
+private:
+    enum class State
+    {
+        waitingForFailure,
+        failurePending,
+        collecting,
+        complete
+    };
+
+    const size_t m_preFrames;
+    const size_t m_postFrames;
+    State m_state = State::waitingForFailure;
+    size_t m_numFramesPushed = 0;
+    size_t m_failureFrame = 0;
+    size_t m_windowStartFrame = 0;
+    size_t m_windowEndFrame = 0;
+    bool m_hasReference = false;
+
+    AudioBuffer<SampleType> m_inputHistory;
+    AudioBuffer<SampleType> m_outputHistory;
+    AudioBuffer<SampleType> m_referenceHistory;
+    AudioBuffer<SampleType> m_inputWindow;
+    AudioBuffer<SampleType> m_outputWindow;
+    AudioBuffer<SampleType> m_referenceWindow;
+
+    void updateState()
+    {
+        if (m_numFramesPushed >= m_windowEndFrame)
+            m_state = State::complete;
+    }
+
+    /// @brief Writes a block into the ring, each frame goes to its position in the signal modulo the ring size
+    static void writeToHistory (AudioBuffer<SampleType>& history, const AudioBuffer<SampleType>& block, size_t blockStartFrame)
+    {
+        const size_t historySizeFrames = history.getNumFrames();
+
+        for (size_t channel = 0; channel < block.getNumChannels(); ++channel)
+            for (size_t frame = 0; frame < block.getNumFrames(); ++frame)
+                history[channel][(blockStartFrame + frame) % historySizeFrames] = block[channel][frame];
+    }
+
+    void readFromHistory (AudioBuffer<SampleType>& window, const AudioBuffer<SampleType>& history, size_t numFrames) const
+    {
+        const size_t historySizeFrames = history.getNumFrames();
+        window.resize (numFrames);
+
+        for (size_t channel = 0; channel < history.getNumChannels(); ++channel)
+            for (size_t frame = 0; frame < numFrames; ++frame)
+                window[channel][frame] = history[channel][(m_windowStartFrame + frame) % historySizeFrames];
+    }
+
+    static void appendToWindow (AudioBuffer<SampleType>& window, const AudioBuffer<SampleType>& source, size_t sourceStartFrame, size_t numFrames)
+    {
+        const size_t windowSizeFrames = window.getNumFrames();
+        window.resize (windowSizeFrames + numFrames);
+
+        for (size_t channel = 0; channel < source.getNumChannels(); ++channel)
+            std::copy (source[channel] + sourceStartFrame, source[channel] + sourceStartFrame + numFrames, window[channel] + windowSizeFrames);
+    }
+};
+
+}  // namespace hart
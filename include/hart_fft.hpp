@@ -0,0 +1,200 @@
+#pragma once
+
+#include <cmath>
+#include <complex>
+#include <utility>  // swap()
+#include <vector>
+
+#include "hart_exceptions.hpp"
+#include "hart_utils.hpp"
+
+namespace hart
+{
+
+/// @brief Checks if the value is a power of two
+/// @private
+inline bool isPowerOfTwo (size_t value)
+{
+    return value != 0 && (value & (value - 1)) == 0;
+}
+
+/// @brief Returns the smallest power of two that is not less than the value
+/// @private
+inline size_t nextPowerOfTwo (size_t value)
+{
+    size_t powerOfTwo = 1;
+
+    while (powerOfTwo < value)
+        powerOfTwo <<= 1;
+
+    return powerOfTwo;
+}
+
+/// @brief Radix-2 complex FFT of a fixed size
+/// @details All the twiddle factors and the bit reversal table are calculated once, in the constructor,
+/// so the transforms themselves don't allocate anything. Transforms can be run from several threads at once.
+/// @private
+class FFT
+{
+public:
+    /// @param size Number of points, must be a power of two
+    FFT (size_t size):
+        m_size (size)
+    {
+        if (! isPowerOfTwo (size))
+            HART_THROW_OR_RETURN_VOID (hart::SizeError, "FFT size must be a power of two");
+
+        m_twiddles.resize (size / 2);
+
+        for (size_t i = 0; i < size / 2; ++i)
+            m_twiddles[i] = std::polar (1.0, -hart::twoPi * i / size);
+
+        m_bitReversedIndices.resize (size);
+        size_t numBits = 0;
+
+        while ((size_t (1) << numBits) < size)
+            ++numBits;
+
+        for (size_t i = 0; i < size; ++i)
+        {
+            size_t reversed = 0;
+
+            for (size_t bit = 0; bit < numBits; ++bit)
+                if ((i >> bit) & 1)
+                    reversed |= size_t (1) << (numBits - 1 - bit);
+
+            m_bitReversedIndices[i] = reversed;
+        }
+    }
+
+    size_t getSize() const { return m_size; }
+
+    /// @brief Forward transform, in place
+    void forward (std::complex<double>* data) const
+    {
+        transform (data, false);
+    }
+
+    /// @brief Inverse transform, in place, scaled by 1/size so that it undoes @ref forward()
+    void inverse (std::complex<double>* data) const
+    {
+        transform (data, true);
+        const double scale = 1.0 / m_size;
+
+        for (size_t i = 0; i < m_size; ++i)
+            data[i] *= scale;
+    }
+
+private:
+    size_t m_size;
+    std::vector<std::complex<double>> m_twiddles;
+    std::vector<size_t> m_bitReversedIndices;
+
+    void transform (std::complex<double>* data, bool isInverse) const
+    {
+        for (size_t i = 0; i < m_size; ++i)
+            if (i < m_bitReversedIndices[i])
+                std::swap (data[i], data[m_bitReversedIndices[i]]);
+
+        for (size_t length = 2; length <= m_size; length <<= 1)
+        {
+            const size_t halfLength = length / 2;
+            const size_t twiddleStep = m_size / length;
+
+            for (size_t start = 0; start < m_size; start += length)
+            {
+                for (size_t i = 0; i < halfLength; ++i)
+                {
+                    const std::complex<double> twiddle = isInverse ? std::conj (m_twiddles[i * twiddleStep]) : m_twiddles[i * twiddleStep];
+                    const std::complex<double> even = data[start + i];
+                    const std::complex<double> odd = data[start + i + halfLength] * twiddle;
+                    data[start + i] = even + odd;
+                    data[start + i + halfLength] = even - odd;
+                }
+            }
+        }
+    }
+};
+
+/// @brief FFT of real signals
+/// @details Packs the even and odd samples into a complex FFT of half the size, so it's about twice as fast as
+/// transforming real signals with @ref FFT. Only the non-negative frequencies are stored, as the rest mirror them.
+/// @private
+class RealFFT
+{
+public:
+    /// @param size Number of real points, must be a power of two, and at least 2
+    RealFFT (size_t size):
+        m_size (size),
+        m_halfSizeFFT (size / 2)
+    {
+        if (size < 2 || ! isPowerOfTwo (size))
+            HART_THROW_OR_RETURN_VOID (hart::SizeError, "FFT size must be a power of two");
+
+        m_twiddles.resize (size / 2 + 1);
+
+        for (size_t i = 0; i <= size / 2; ++i)
+            m_twiddles[i] = std::polar (1.0, -hart::twoPi * i / size);
+
+        m_scratch.resize (size / 2);
+    }
+
+    size_t getSize() const { return m_size; }
+
+    /// @brief Number of bins in the spectrum: size / 2 + 1
+    size_t getNumBins() const { return m_size / 2 + 1; }
+
+    /// @brief Forward transform
+    /// @param input @ref getSize() real samples
+    /// @param output @ref getNumBins() complex bins, from DC to Nyquist
+    void forward (const double* input, std::complex<double>* output)
+    {
+        const size_t halfSize = m_size / 2;
+
+        for (size_t i = 0; i < halfSize; ++i)
+            m_scratch[i] = std::complex<double> (input[2 * i], input[2 * i + 1]);
+
+        m_halfSizeFFT.forward (m_scratch.data());
+
+        for (size_t bin = 0; bin <= halfSize; ++bin)
+        {
+            const std::complex<double> z = m_scratch[bin % halfSize];
+            const std::complex<double> mirroredZ = std::conj (m_scratch[(halfSize - bin) % halfSize]);
+            const std::complex<double> even = 0.5 * (z + mirroredZ);
+            const std::complex<double> odd = std::complex<double> (0.0, -0.5) * (z - mirroredZ);
+            output[bin] = even + m_twiddles[bin] * odd;
+        }
+    }
+
+    /// @brief Inverse transform, scaled so that it undoes @ref forward()
+    /// @param input @ref getNumBins() complex bins, from DC to Nyquist
+    /// @param output @ref getSize() real samples
+    void inverse (const std::complex<double>* input, double* output)
+    {
+        const size_t halfSize = m_size / 2;
+
+        for (size_t bin = 0; bin < halfSize; ++bin)
+        {
+            const std::complex<double> mirroredX = std::conj (input[halfSize - bin]);
+            const std::complex<double> even = 0.5 * (input[bin] + mirroredX);
+            const std::complex<double> odd = 0.5 * (input[bin] - mirroredX) * std::conj (m_twiddles[bin]);
+            m_scratch[bin] = even + std::complex<double> (0.0, 1.0) * odd;
+        }
+
+        m_halfSizeFFT.inverse (m_scratch.data());
+
+        for (size_t i = 0; i < halfSize; ++i)
+        {
+            output[2 * i] = m_scratch[i].real();
+            output[2 * i + 1] = m_scratch[i].imag();
+        }
+    }
+
+private:
+    size_t m_size;
+    FFT m_halfSizeFFT;
+    std::vector<std::complex<double>> m_twiddles;
+    std::vector<std::complex<double>> m_scratch;
+};
+
+}  // namespace hart
@@ -0,0 +1,84 @@
+#pragma once
+
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace hart
+{
+
+/// @brief Keeps track of the fixtures that have been set up
+/// @details For internal use by HART. Fixtures get torn down at the end of the test run, in reverse order of setting up.
+/// @private
+class FixtureRegistry
+{
+public:
+    static FixtureRegistry& getInstance()
+    {
+        static FixtureRegistry registry;
+        return registry;
+    }
+
+    void addTeardown (std::function<void()> teardown)
+    {
+        std::lock_guard<std::mutex> lock (m_mutex);
+        m_teardowns.push_back (std::move (teardown));
+    }
+
+    void tearDownAll()
+    {
+        std::lock_guard<std::mutex> lock (m_mutex);
+
+        for (auto it = m_teardowns.rbegin(); it != m_teardowns.rend(); ++it)
+            (*it)();
+
+        m_teardowns.clear();
+    }
+
+private:
+    std::mutex m_mutex;
+    std::vector<std::function<void()>> m_teardowns;
+
+    FixtureRegistry() = default;  // Private ctor for singleton
+};
+
+/// @brief Base class for shared read-only test fixtures
+/// @details Don't inherit from it directly, use @ref HART_FIXTURE() instead.
+/// A fixture gets constructed on first call to @ref get(), exactly once, even if several tests running in parallel
+/// ask for it at the same time. It gets destroyed at the end of the test run, so its destructor is the place for teardown.
+/// @ingroup TestRunner
+template <typename Derived>
+class Fixture
+{
+public:
+    /// @brief Gets the fixture, setting it up if needed
+    static const Derived& get()
+    {
+        std::call_once (getOnceFlag(), []
+        {
+            getInstance().reset (new Derived());
+            FixtureRegistry::getInstance().addTeardown ([] { getInstance().reset(); });
+        });
+
+        return *getInstance();
+    }
+
+protected:
+    Fixture() = default;
+
+private:
+    static std::unique_ptr<Derived>& getInstance()
+    {
+        static std::unique_ptr<Derived> instance;
+        return instance;
+    }
+
+    static std::once_flag& getOnceFlag()
+    {
+        static std::once_flag onceFlag;
+        return onceFlag;
+    }
+};
+
+}  // namespace hart
@@ -0,0 +1,811 @@
+#pragma once
+
+#include <algorithm>  // min(), max()
+#include <atomic>
+#include <cmath>  // round()
+#include <cstdint>
+#include <exception>
+#include <iomanip>
+#include <limits>
+#include <memory>
+#include <random>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "hart_audio_buffer.hpp"
+#include "hart_cancellation.hpp"
+#include "hart_cliconfig.hpp"
+#include "dsp/hart_dsp.hpp"
+#include "envelopes/hart_segmentedenvelope.hpp"
+#include "hart_exceptions.hpp"
+#include "hart_expectation_failure_messages.hpp"
+#include "matchers/hart_isfinite.hpp"
+#include "matchers/hart_matcher.hpp"
+#include "hart_precision.hpp"
+#include "signals/hart_signal.hpp"
+#include "signals/hart_whitenoise.hpp"
+#include "hart_utils.hpp"  // make_unique()
+
+namespace hart {
+
+/// @brief Throws random parameter values, automation envelopes and block sizes at a DSP
+/// @details Renders a lot of short randomized test cases in parallel, checking each of them with per-block
+/// matchers like @ref IsFinite or @ref PeaksBelow. If any case fails, it gets shrunk down to a minimal
+/// failing case, which is then reported as a ready-to-paste @ref processAudioWith() snippet.
+/// All the cases are derived from the `--seed` CLI argument, so any failure is reproducible.
+/// Each worker thread owns a prepared copy of the DSP, input signal and matchers, as well as
+/// preallocated audio buffers, and reuses them for all the cases it renders.
+/// @ingroup TestRunner
+template <typename SampleType>
+class Fuzzer
+{
+public:
+    /// @brief Copies the DSP instance into the fuzzer
+    /// @param dsp Your DSP instance. It is used as a prototype, and gets copied for each worker thread.
+    template <typename DSPType>
+    Fuzzer (DSPType&& dsp,
+        typename std::enable_if<
+            std::is_lvalue_reference<DSPType&&>::value &&
+            std::is_base_of<DSP<SampleType>, typename std::decay<DSPType>::type>::value
+        >::type* = 0)
+    : m_processor (dsp.copy())
+    {
+    }
+
+    /// @brief Moves the DSP instance into the fuzzer
+    /// @param dsp Your DSP instance. It is used as a prototype, and gets copied for each worker thread.
+    template <typename DSPType>
+    Fuzzer (DSPType&& dsp,
+        typename std::enable_if<
+            ! std::is_lvalue_reference<DSPType&&>::value &&
+            std::is_base_of<DSP<SampleType>, typename std::decay<DSPType>::type>::value
+        >::type* = 0)
+    : m_processor (std::forward<DSPType> (dsp).move())
+    {
+    }
+
+    /// @brief Transfers the DSP smart pointer into the fuzzer
+    /// @note The DSP still needs to support copying, as each worker thread gets its own copy
+    /// @param dsp A smart pointer to your DSP instance
+    Fuzzer (std::unique_ptr<DSP<SampleType>> dsp)
+    : m_processor (std::move (dsp))
+    {
+    }
+
+    /// @brief Sets the sample rate for all the cases
+    /// @param sampleRateHz Sample rate in Hz. You can use frequency-related literails from @ref Units.
+    Fuzzer& withSampleRate (double sampleRateHz)
+    {
+        if (sampleRateHz <= 0)
+            HART_THROW_OR_RETURN (hart::ValueError, "Sample rate should be a positive value in Hz", *this);
+
+        if (! m_processor->supportsSampleRate (sampleRateHz))
+            HART_THROW_OR_RETURN (hart::SampleRateError, "Sample rate is not supported by the tested DSP", *this);
+
+        m_sampleRateHz = sampleRateHz;
+        return *this;
+    }
+
+    /// @brief Sets the range of block sizes to pick from
+    /// @details Each case gets processed with a block size randomly picked from this range, inclusive
+    /// @param minBlockSizeFrames Smallest block size in frames (samples)
+    /// @param maxBlockSizeFrames Largest block size in frames (samples)
+    Fuzzer& withBlockSizeRange (size_t minBlockSizeFrames, size_t maxBlockSizeFrames)
+    {
+        if (minBlockSizeFrames == 0 || maxBlockSizeFrames < minBlockSizeFrames)
+            HART_THROW_OR_RETURN (hart::SizeError, "Illegal block size range", *this);
+
+        m_minBlockSizeFrames = minBlockSizeFrames;
+        m_maxBlockSizeFrames = maxBlockSizeFrames;
+        return *this;
+    }
+
+    /// @brief Sets the duration of each case
+    /// @details Keep it short - the point is to render as many different cases as possible
+    /// @param durationSeconds Duration of the signal in seconds. You can use time-related literails from @ref Units.
+    Fuzzer& withDuration (double durationSeconds)
+    {
+        if (durationSeconds <= 0)
+            HART_THROW_OR_RETURN (hart::ValueError, "Case duration should be a positive value in seconds", *this);
+
+        m_durationSeconds = durationSeconds;
+        return *this;
+    }
+
+    /// @brief Sets the input signal for all the cases by copying it
+    /// @details If not set, @ref WhiteNoise is used
+    /// @param signal Input signal, see @ref Signals
+    Fuzzer& withInputSignal (const Signal<SampleType>& signal)
+    {
+        m_inputSignal = signal.copy();
+        return *this;
+    }
+
+    /// @brief Sets the input signal for all the cases by moving it
+    /// @details If not set, @ref WhiteNoise is used
+    /// @param signal Input signal, see @ref Signals
+    Fuzzer& withInputSignal (Signal<SampleType>&& signal)
+    {
+        m_inputSignal = signal.move();
+        return *this;
+    }
+
+    /// @brief Sets arbitrary number of input channels
+    /// @param numInputChannels Number of input channels
+    Fuzzer& withInputChannels (size_t numInputChannels)
+    {
+        if (numInputChannels == 0)
+            HART_THROW_OR_RETURN (SizeError, "There should be at least one (mono) audio channel", *this);
+
+        m_numInputChannels = numInputChannels;
+        return *this;
+    }
+
+    /// @brief Sets arbitrary number of output channels
+    /// @param numOutputChannels Number of output channels
+    Fuzzer& withOutputChannels (size_t numOutputChannels)
+    {
+        if (numOutputChannels == 0)
+            HART_THROW_OR_RETURN (SizeError, "There should be at least one (mono) audio channel", *this);
+
+        m_numOutputChannels = numOutputChannels;
+        return *this;
+    }
+
+    /// @brief Sets number of input and output channels to one
+    Fuzzer& inMono()
+    {
+        return this->withInputChannels (1).withOutputChannels (1);
+    }
+
+    /// @brief Sets number of input and output channels to two
+    Fuzzer& inStereo()
+    {
+        return this->withInputChannels (2).withOutputChannels (2);
+    }
+
+    /// @brief Randomizes a parameter value
+    /// @details Each case sets this parameter with @ref DSP::setValue() to a value randomly picked from the range.
+    /// The range boundaries are picked more often than the values in between.
+    /// @param id Parameter ID (see @ref DSP::setValue())
+    /// @param minValue Lowest value
+    /// @param maxValue Highest value
+    Fuzzer& withRandomValue (int id, double minValue, double maxValue)
+    {
+        if (maxValue < minValue)
+            HART_THROW_OR_RETURN (hart::ValueError, "Illegal parameter value range", *this);
+
+        m_randomValues.emplace_back (RandomRange { id, minValue, maxValue });
+        return *this;
+    }
+
+    /// @brief Randomizes an automation envelope for a parameter
+    /// @details Each case attaches a @ref SegmentedEnvelope with a few random ramps within the range
+    /// @param id Parameter ID (see @ref DSP::supportsEnvelopeFor())
+    /// @param minValue Lowest value
+    /// @param maxValue Highest value
+    Fuzzer& withRandomEnvelope (int id, double minValue, double maxValue)
+    {
+        if (maxValue < minValue)
+            HART_THROW_OR_RETURN (hart::ValueError, "Illegal parameter value range", *this);
+
+        if (! m_processor->supportsEnvelopeFor (id))
+            HART_THROW_OR_RETURN (hart::UnsupportedError, std::string ("DSP doesn't support envelopes for param ID: ") + std::to_string (id), *this);
+
+        m_randomEnvelopes.emplace_back (RandomRange { id, minValue, maxValue });
+        return *this;
+    }
+
+    /// @brief Sets the number of random cases to render
+    Fuzzer& withNumCases (size_t numCases)
+    {
+        m_numCases = numCases;
+        return *this;
+    }
+
+    /// @brief Sets the number of worker threads
+    /// @details By default, all available hardware threads are used
+    Fuzzer& withNumThreads (size_t numThreads)
+    {
+        if (numThreads == 0)
+            HART_THROW_OR_RETURN (hart::ValueError, "There should be at least one worker thread", *this);
+
+        m_numThreads = numThreads;
+        return *this;
+    }
+
+    /// @brief Adds an "expect" check to every case
+    /// @details If no checks are added, @ref IsFinite is used
+    /// @param matcher Matcher to perform the check. Only matchers that can operate per block are supported.
+    Fuzzer& expectTrue (const Matcher<SampleType>& matcher)
+    {
+        addCheck (matcher, false);
+        return *this;
+    }
+
+    /// @brief Adds an "assert" check to every case
+    /// @param matcher Matcher to perform the check. Only matchers that can operate per block are supported.
+    Fuzzer& assertTrue (const Matcher<SampleType>& matcher)
+    {
+        addCheck (matcher, true);
+        return *this;
+    }
+
+    /// @brief Adds a label to the fuzzing session
+    /// @param testLabel Any text, to be used as a label in the failure report
+    Fuzzer& withLabel (const std::string& testLabel)
+    {
+        m_testLabel = testLabel;
+        return *this;
+    }
+
+    /// @brief Renders all the cases
+    /// @details If any of the cases fails, the first one (in case order, regardless of threading) gets
+    /// shrunk and reported, just like a failed @ref AudioTestBuilder::process() would.
+    void run()
+    {
+        if (m_checks.empty())
+            addCheck (IsFinite<SampleType>(), false);
+
+        if (m_inputSignal == nullptr)
+            m_inputSignal = hart::make_unique<WhiteNoise<SampleType>> (m_randomSeed);
+
+        if (m_numCases == 0)
+            return;
+
+        const size_t numThreads = std::min (m_numThreads, m_numCases);
+        std::vector<std::unique_ptr<Worker>> workers;
+
+        // Copying the prototypes is left to the calling thread, as user's copy() may not be thread-safe
+        for (size_t i = 0; i < numThreads; ++i)
+            workers.push_back (hart::make_unique<Worker> (*this));
+
+        std::atomic<size_t> nextCaseIndex (0);
+        std::atomic<size_t> firstFailedCaseIndex (noFailure);
+        std::exception_ptr workerException;
+        std::atomic<bool> hasWorkerException (false);
+        const CancellationToken* cancellationToken = CancellationToken::getCurrent();
+        std::atomic<size_t> numCasesRendered (0);
+
+        auto workerLoop = [&] (Worker& worker)
+        {
+            FuzzCase fuzzCase;
+
+            try
+            {
+                while (! hasWorkerException)
+                {
+                    const size_t caseIndex = nextCaseIndex++;
+
+                    if (caseIndex >= m_numCases || caseIndex > firstFailedCaseIndex)
+                        return;
+
+                    if (cancellationToken != nullptr && cancellationToken->isCancelled())
+                        return;
+
+                    generateCase (caseIndex, fuzzCase);
+                    const bool caseFailed = worker.run (fuzzCase).failed;
+                    ++numCasesRendered;
+
+                    if (! caseFailed)
+                        continue;
+
+                    size_t knownFailedCaseIndex = firstFailedCaseIndex;
+
+                    while (caseIndex < knownFailedCaseIndex && ! firstFailedCaseIndex.compare_exchange_weak (knownFailedCaseIndex, caseIndex))
+                        ;
+                }
+            }
+            catch (...)
+            {
+                if (! hasWorkerException.exchange (true))
+                    workerException = std::current_exception();
+            }
+        };
+
+        std::vector<std::thread> threads;
+
+        for (size_t i = 1; i < numThreads; ++i)
+            threads.emplace_back (workerLoop, std::ref (*workers[i]));
+
+        workerLoop (*workers[0]);
+
+        for (auto& thread : threads)
+            thread.join();
+
+        if (hasWorkerException)
+            std::rethrow_exception (workerException);
+
+        if (firstFailedCaseIndex == noFailure && cancellationToken != nullptr && cancellationToken->isCancelled())
+        {
+            std::stringstream stream;
+            stream << cancellationToken->describeReason() << " while fuzzing";
+
+            if (! m_testLabel.empty())
+                stream << " at \"" << m_testLabel << "\"";
+
+            stream << " after " << numCasesRendered << " of " << m_numCases << " cases";
+            throw hart::TestAssertException (stream.str());
+        }
+
+        if (firstFailedCaseIndex == noFailure)
+            return;
+
+        FuzzCase failedCase;
+        generateCase (firstFailedCaseIndex, failedCase);
+        CaseResult result = runFreshCase (failedCase);
+        hassert (result.failed && "Fuzzing case failed on a worker thread, but passed when rendered again");
+        shrink (failedCase, result);
+        reportFailure (failedCase, result);
+    }
+
+private:
+    struct RandomRange
+    {
+        int id;
+        double minValue;
+        double maxValue;
+    };
+
+    struct ParamValue
+    {
+        int id;
+        double value;
+    };
+
+    struct Ramp
+    {
+        double targetValue;
+        double durationSeconds;
+        SegmentedEnvelope::Shape shape;
+    };
+
+    struct EnvelopeValues
+    {
+        int id;
+        double startValue;
+        std::vector<Ramp> ramps;
+    };
+
+    struct FuzzCase
+    {
+        size_t index = 0;
+        size_t blockSizeFrames = 0;
+        double durationSeconds = 0.0;
+        std::vector<ParamValue> paramValues;
+        std::vector<EnvelopeValues> envelopes;
+    };
+
+    struct CaseResult
+    {
+        bool failed = false;
+        size_t checkIndex = 0;
+        size_t blockOffsetFrames = 0;
+        SampleType sampleValue = (SampleType) 0;
+        MatcherFailureDetails details;
+    };
+
+    struct Check
+    {
+        std::unique_ptr<Matcher<SampleType>> matcher;
+        bool isAssertion;
+    };
+
+    /// @brief Owns everything needed to render cases on one thread
+    class Worker
+    {
+    public:
+        Worker (const Fuzzer& fuzzer):
+            m_fuzzer (fuzzer),
+            m_processor (fuzzer.m_processor->copy()),
+            m_inputSignal (fuzzer.m_inputSignal->copy()),
+            m_inputBlock (fuzzer.m_numInputChannels, fuzzer.m_maxBlockSizeFrames),
+            m_outputBlock (fuzzer.m_numOutputChannels, fuzzer.m_maxBlockSizeFrames)
+        {
+            for (const Check& check : fuzzer.m_checks)
+                m_matchers.push_back (check.matcher->copy());
+
+            // Copies share the DSP chains and envelopes with the prototypes until reset, so this is where they really get copied
+            m_processor->resetWithEnvelopes();
+            m_inputSignal->resetWithDSPChain();
+        }
+
+        CaseResult run (const FuzzCase& fuzzCase)
+        {
+            const double sampleRateHz = m_fuzzer.m_sampleRateHz;
+            const size_t numInputChannels = m_fuzzer.m_numInputChannels;
+            const size_t numOutputChannels = m_fuzzer.m_numOutputChannels;
+            const size_t blockSizeFrames = fuzzCase.blockSizeFrames;
+
+            for (const EnvelopeValues& envelopeValues : fuzzCase.envelopes)
+                m_processor->withEnvelope (envelopeValues.id, makeEnvelope (envelopeValues, fuzzCase.durationSeconds));
+
+            m_processor->reset();
+            m_processor->prepareWithEnvelopes (sampleRateHz, numInputChannels, numOutputChannels, blockSizeFrames);
+
+            for (const ParamValue& paramValue : fuzzCase.paramValues)
+                m_processor->setValue (paramValue.id, paramValue.value);
+
+            m_inputSignal->resetWithDSPChain();
+            m_inputSignal->prepareWithDSPChain (sampleRateHz, numInputChannels, blockSizeFrames);
+
+            for (auto& matcher : m_matchers)
+            {
+                matcher->prepare (sampleRateHz, numOutputChannels, blockSizeFrames);
+                matcher->reset();
+            }
+
+            const size_t durationFrames = (size_t) std::round (sampleRateHz * fuzzCase.durationSeconds);
+            CaseResult result;
+            size_t offsetFrames = 0;
+
+            while (offsetFrames < durationFrames)
+            {
+                const size_t numFrames = std::min (blockSizeFrames, durationFrames - offsetFrames);
+                m_inputBlock.resize (numFrames);
+                m_outputBlock.resize (numFrames);
+                m_inputSignal->renderNextBlockWithDSPChain (m_inputBlock);
+                m_processor->processWithEnvelopes (m_inputBlock, m_outputBlock);
+
+                for (size_t checkIndex = 0; checkIndex < m_matchers.size(); ++checkIndex)
+                {
+                    if (m_matchers[checkIndex]->match (m_outputBlock))
+                        continue;
+
+                    result.failed = true;
+                    result.checkIndex = checkIndex;
+                    result.blockOffsetFrames = offsetFrames;
+                    result.details = m_matchers[checkIndex]->getFailureDetails();
+                    result.sampleValue = m_outputBlock[result.details.channel][result.details.frame];
+                    return result;
+                }
+
+                offsetFrames += numFrames;
+            }
+
+            return result;
+        }
+
+    private:
+        const Fuzzer& m_fuzzer;
+        std::unique_ptr<DSP<SampleType>> m_processor;
+        std::unique_ptr<Signal<SampleType>> m_inputSignal;
+        std::vector<std::unique_ptr<Matcher<SampleType>>> m_matchers;
+        AudioBuffer<SampleType> m_inputBlock;
+        AudioBuffer<SampleType> m_outputBlock;
+    };
+
+    static constexpr size_t noFailure = std::numeric_limits<size_t>::max();
+    static constexpr double edgeValueProbability = 0.1;
+    static constexpr size_t maxNumRamps = 3;
+
+    std::unique_ptr<DSP<SampleType>> m_processor;
+    std::unique_ptr<Signal<SampleType>> m_inputSignal;
+    double m_sampleRateHz = (double) 44100;
+    size_t m_minBlockSizeFrames = 1;
+    size_t m_maxBlockSizeFrames = 1024;
+    size_t m_numInputChannels = 1;
+    size_t m_numOutputChannels = 1;
+    double m_durationSeconds = 0.01;
+    size_t m_numCases = 1000;
+    size_t m_numThreads = std::max (1u, std::thread::hardware_concurrency());
+    uint_fast32_t m_randomSeed = CLIConfig::getInstance().getRandomSeed();
+    std::string m_testLabel = {};
+
+    std::vector<RandomRange> m_randomValues;
+    std::vector<RandomRange> m_randomEnvelopes;
+    std::vector<Check> m_checks;
+
+    void addCheck (const Matcher<SampleType>& matcher, bool isAssertion)
+    {
+        std::unique_ptr<Matcher<SampleType>> matcherCopy = matcher.copy();
+
+        if (! matcherCopy->canOperatePerBlock())
+            HART_THROW_OR_RETURN_VOID (hart::UnsupportedError, "Fuzzer only supports matchers that can operate per block");
+
+        m_checks.emplace_back (Check { std::move (matcherCopy), isAssertion });
+    }
+
+    /// @brief Deterministically derives a case from the random seed and the case index
+    void generateCase (size_t caseIndex, FuzzCase& fuzzCase) const
+    {
+        std::seed_seq seedSequence { (uint_fast32_t) m_randomSeed, (uint_fast32_t) caseIndex };
+        std::mt19937 rng (seedSequence);
+        std::uniform_int_distribution<size_t> blockSizeDistribution (m_minBlockSizeFrames, m_maxBlockSizeFrames);
+        std::uniform_int_distribution<size_t> numRampsDistribution (1, maxNumRamps);
+        std::uniform_int_distribution<int> shapeDistribution (0, 2);
+        std::uniform_real_distribution<double> unitDistribution (0.0, 1.0);
+
+        fuzzCase.index = caseIndex;
+        fuzzCase.durationSeconds = m_durationSeconds;
+        fuzzCase.blockSizeFrames = blockSizeDistribution (rng);
+        fuzzCase.paramValues.clear();
+        fuzzCase.envelopes.resize (m_randomEnvelopes.size());
+
+        for (const RandomRange& range : m_randomValues)
+            fuzzCase.paramValues.push_back (ParamValue { range.id, pickValue (rng, range) });
+
+        for (size_t i = 0; i < m_randomEnvelopes.size(); ++i)
+        {
+            EnvelopeValues& envelopeValues = fuzzCase.envelopes[i];
+            const size_t numRamps = numRampsDistribution (rng);
+            envelopeValues.id = m_randomEnvelopes[i].id;
+            envelopeValues.startValue = pickValue (rng, m_randomEnvelopes[i]);
+            envelopeValues.ramps.clear();
+
+            for (size_t ramp = 0; ramp < numRamps; ++ramp)
+            {
+                envelopeValues.ramps.push_back (Ramp {
+                    pickValue (rng, m_randomEnvelopes[i]),
+                    unitDistribution (rng) * m_durationSeconds / (double) numRamps,
+                    static_cast<SegmentedEnvelope::Shape> (shapeDistribution (rng))
+                    });
+            }
+        }
+    }
+
+    static double pickValue (std::mt19937& rng, const RandomRange& range)
+    {
+        std::uniform_real_distribution<double> unitDistribution (0.0, 1.0);
+        const double dice = unitDistribution (rng);
+
+        if (dice < edgeValueProbability)
+            return range.minValue;
+
+        if (dice < 2.0 * edgeValueProbability)
+            return range.maxValue;
+
+        return range.minValue + (range.maxValue - range.minValue) * unitDistribution (rng);
+    }
+
+    static SegmentedEnvelope makeEnvelope (const EnvelopeValues& envelopeValues, double durationSeconds)
+    {
+        SegmentedEnvelope envelope (envelopeValues.startValue);
+
+        if (envelopeValues.ramps.empty())
+            envelope.hold (durationSeconds);
+
+        for (const Ramp& ramp : envelopeValues.ramps)
+            envelope.rampTo (ramp.targetValue, ramp.durationSeconds, ramp.shape);
+
+        return envelope;
+    }
+
+    /// @brief Renders a case with brand new copies of all the prototypes
+    /// @details Used for shrinking, so that removing a value or an envelope from a case actually
+    /// leaves the DSP with its initial value, rather than with one left over from the previous case
+    CaseResult runFreshCase (const FuzzCase& fuzzCase) const
+    {
+        Worker worker (*this);
+        return worker.run (fuzzCase);
+    }
+
+    bool stillFails (const FuzzCase& candidate, const CaseResult& originalResult, CaseResult& candidateResult) const
+    {
+        candidateResult = runFreshCase (candidate);
+        return candidateResult.failed && candidateResult.checkIndex == originalResult.checkIndex;
+    }
+
+    /// @brief Simplifies a failing case while it still fails the same check
+    void shrink (FuzzCase& fuzzCase, CaseResult& result) const
+    {
+        CaseResult candidateResult;
+
+        auto tryCandidate = [&] (const FuzzCase& candidate)
+        {
+            if (! stillFails (candidate, result, candidateResult))
+                return false;
+
+            fuzzCase = candidate;
+            result = candidateResult;
+            return true;
+        };
+
+        auto shortenToFailure = [&]()
+        {
+            FuzzCase candidate = fuzzCase;
+            candidate.durationSeconds = (double) (result.blockOffsetFrames + result.details.frame + 1) / m_sampleRateHz;
+            tryCandidate (candidate);
+        };
+
+        shortenToFailure();
+
+        for (size_t i = fuzzCase.envelopes.size(); i > 0; --i)
+        {
+            FuzzCase candidate = fuzzCase;
+            candidate.envelopes.erase (candidate.envelopes.begin() + (i - 1));
+
+            if (tryCandidate (candidate))
+                continue;
+
+            candidate = fuzzCase;
+            candidate.envelopes[i - 1].ramps.clear();
+            tryCandidate (candidate);
+        }
+
+        for (size_t i = fuzzCase.paramValues.size(); i > 0; --i)
+        {
+            FuzzCase candidate = fuzzCase;
+            candidate.paramValues.erase (candidate.paramValues.begin() + (i - 1));
+            tryCandidate (candidate);
+        }
+
+        for (size_t i = 0; i < fuzzCase.paramValues.size(); ++i)
+        {
+            for (int decimals = 0; decimals <= 3; ++decimals)
+            {
+                const double scale = std::pow (10.0, decimals);
+                FuzzCase candidate = fuzzCase;
+                candidate.paramValues[i].value = std::round (fuzzCase.paramValues[i].value * scale) / scale;
+
+                if (floatsEqual (candidate.paramValues[i].value, fuzzCase.paramValues[i].value, 1e-12) || tryCandidate (candidate))
+                    break;
+            }
+        }
+
+        const size_t durationFrames = (size_t) std::round (m_sampleRateHz * fuzzCase.durationSeconds);
+        const size_t simpleBlockSizes[] = { durationFrames, 1024, 512, 256, 128, 64 };
+
+        for (const size_t blockSizeFrames : simpleBlockSizes)
+        {
+            if (blockSizeFrames == fuzzCase.blockSizeFrames)
+                break;
+
+            if (blockSizeFrames < m_minBlockSizeFrames || blockSizeFrames > m_maxBlockSizeFrames)
+                continue;
+
+            FuzzCase candidate = fuzzCase;
+            candidate.blockSizeFrames = blockSizeFrames;
+
+            if (tryCandidate (candidate))
+                break;
+        }
+
+        shortenToFailure();
+
+        const size_t shortenedDurationFrames = (size_t) std::round (m_sampleRateHz * fuzzCase.durationSeconds);
+
+        if (fuzzCase.blockSizeFrames > shortenedDurationFrames && shortenedDurationFrames >= m_minBlockSizeFrames)
+        {
+            FuzzCase candidate = fuzzCase;
+            candidate.blockSizeFrames = shortenedDurationFrames;
+            tryCandidate (candidate);
+        }
+    }
+
+    static void writeExactValue (std::ostream& stream, double value)
+    {
+        std::stringstream valueStream;
+        valueStream << std::setprecision (std::numeric_limits<double>::max_digits10) << value;
+        std::string text = valueStream.str();
+
+        if (text.find_first_of (".einf") == std::string::npos)
+            text += ".0";
+
+        stream << text;
+    }
+
+    void writeReproduction (std::ostream& stream, const FuzzCase& fuzzCase, const Check& failedCheck) const
+    {
+        stream << "processAudioWith (" << *m_processor;
+
+        for (const EnvelopeValues& envelopeValues : fuzzCase.envelopes)
+        {
+            stream << ".withEnvelope (" << envelopeValues.id << ", SegmentedEnvelope (";
+            writeExactValue (stream, envelopeValues.startValue);
+            stream << ")";
+
+            if (envelopeValues.ramps.empty())
+            {
+                stream << ".hold (";
+                writeExactValue (stream, fuzzCase.durationSeconds);
+                stream << ")";
+            }
+
+            for (const Ramp& ramp : envelopeValues.ramps)
+            {
+                stream << ".rampTo (";
+                writeExactValue (stream, ramp.targetValue);
+                stream << ", ";
+                writeExactValue (stream, ramp.durationSeconds);
+                stream << ", SegmentedEnvelope::Shape::"
+                    << (ramp.shape == SegmentedEnvelope::Shape::linear ? "linear" : ramp.shape == SegmentedEnvelope::Shape::exponential ? "exponential" : "sCurve")
+                    << ")";
+            }
+
+            stream << ")";
+        }
+
+        stream << ")" << std::endl;
+        stream << "    .withSampleRate (";
+        writeExactValue (stream, m_sampleRateHz);
+        stream << ")" << std::endl;
+        stream << "    .withBlockSize (" << fuzzCase.blockSizeFrames << ")" << std::endl;
+
+        if (m_numInputChannels != 1)
+            stream << "    .withInputChannels (" << m_numInputChannels << ")" << std::endl;
+
+        if (m_numOutputChannels != 1)
+            stream << "    .withOutputChannels (" << m_numOutputChannels << ")" << std::endl;
+
+        stream << "    .withDuration (";
+        writeExactValue (stream, fuzzCase.durationSeconds);
+        stream << ")" << std::endl;
+        stream << "    .withInputSignal (" << *m_inputSignal << ")" << std::endl;
+
+        for (const ParamValue& paramValue : fuzzCase.paramValues)
+        {
+            stream << "    .withValue (" << paramValue.id << ", ";
+            writeExactValue (stream, paramValue.value);
+            stream << ")" << std::endl;
+        }
+
+        stream << "    " << (failedCheck.isAssertion ? ".assertTrue (" : ".expectTrue (") << *failedCheck.matcher << ")" << std::endl;
+        stream << "    .process();";
+    }
+
+    void reportFailure (const FuzzCase& fuzzCase, const CaseResult& result) const
+    {
+        const Check& failedCheck = m_checks[result.checkIndex];
+        const size_t failedFrame = result.blockOffsetFrames + result.details.frame;
+        const double timestampSeconds = static_cast<double> (failedFrame) / m_sampleRateHz;
+
+        std::stringstream stream;
+        stream << (failedCheck.isAssertion ? "assertTrue() failed" : "expectTrue() failed") << " while fuzzing";
+
+        if (! m_testLabel.empty())
+            stream << " at \"" << m_testLabel << "\"";
+
+        stream << std::endl << "Condition: " << *failedCheck.matcher << std::endl
+            << "Case: " << fuzzCase.index << " of " << m_numCases << ", seed: " << m_randomSeed << std::endl
+            << "Channel: " << result.details.channel << std::endl
+            << "Frame: " << failedFrame << std::endl
+            << secPrecision << "Timestamp: " << timestampSeconds << " seconds" << std::endl
+            << linPrecision << "Sample value: " << result.sampleValue
+            << dbPrecision << " (" << ratioToDecibels (std::abs (result.sampleValue)) << " dB)" << std::endl
+            << result.details.description << std::endl
+            << "Minimal failing case:" << std::endl;
+        writeReproduction (stream, fuzzCase, failedCheck);
+
+        if (failedCheck.isAssertion)
+            throw hart::TestAssertException (std::string (stream.str()));
+
+        hart::ExpectationFailureMessages::get().emplace_back (stream.str());
+    }
+};
+
+template <typename SampleType>
+constexpr size_t Fuzzer<SampleType>::noFailure;
+
+template <typename SampleType>
+constexpr double Fuzzer<SampleType>::edgeValueProbability;
+
+template <typename SampleType>
+constexpr size_t Fuzzer<SampleType>::maxNumRamps;
+
+/// @brief Call this to start building a fuzzing session
+/// @param dsp Instance of your DSP effect
+/// @return @ref Fuzzer instance - you can chain a bunch of fuzzing parameters with it.
+/// @ingroup TestRunner
+/// @relates Fuzzer
+template <typename DSPType>
+Fuzzer<typename std::decay<DSPType>::type::SampleTypePublicAlias> fuzzAudioWith (DSPType&& dsp)
+{
+    return Fuzzer<typename std::decay<DSPType>::type::SampleTypePublicAlias> (std::forward<DSPType> (dsp));
+}
+
+/// @brief Call this to start building a fuzzing session
+/// @param dsp Instance of your DSP effect wrapped in a smart pointer
+/// @return @ref Fuzzer instance - you can chain a bunch of fuzzing parameters with it.
+/// @ingroup TestRunner
+/// @relates Fuzzer
+template <typename DSPType>
+Fuzzer<typename DSPType::SampleTypePublicAlias> fuzzAudioWith (std::unique_ptr<DSPType>&& dsp)
+{
+    using SampleType = typename DSPType::SampleTypePublicAlias;
+    return Fuzzer<SampleType> (std::unique_ptr<DSP<SampleType>> (dsp.release()));
+}
+
+}  // namespace hart
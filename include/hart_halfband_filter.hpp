@@ -0,0 +1,148 @@
+#pragma once
+
+#include <algorithm>  // fill()
+#include <cmath>
+#include <cstddef>  // ptrdiff_t
+#include <vector>
+
+#include "hart_exceptions.hpp"
+#include "hart_utils.hpp"
+
+namespace hart
+{
+
+/// @brief Polyphase half-band FIR filter for upsampling or downsampling by a factor of two
+/// @details Every other tap of a half-band filter is zero, except for the center one, which is 0.5. So one of the
+/// two polyphase branches is a plain delay, and only the other one needs multiplying, which makes it about four
+/// times cheaper than a regular FIR running at the higher sample rate. The taps are a Kaiser-windowed sinc.
+/// One instance holds the state for a single channel going in a single direction, either up or down.
+///
+/// The history is stored twice in a row, so the taps can always run over a contiguous block of memory
+/// without wrapping around, no matter where the write position is.
+/// @private
+class HalfBandFilter
+{
+public:
+    /// @param numDenseTaps Number of non-zero taps besides the center one; the more, the steeper the filter
+    HalfBandFilter (size_t numDenseTaps = 32):
+        m_taps (numDenseTaps),
+        m_denseHistory (2 * numDenseTaps),
+        m_delayHistory (2 * numDenseTaps)
+    {
+        hassert (numDenseTaps >= 2 && numDenseTaps % 2 == 0);
+
+        // Whole filter has (2 * numDenseTaps - 1) taps, and the non-zero ones are an odd distance away from the center
+        const double beta = 8.0;  // about 80 dB of stopband attenuation
+
+        for (size_t i = 0; i < numDenseTaps; ++i)
+        {
+            const double distance = 2.0 * i - (numDenseTaps - 1.0);
+            const double x = 2.0 * i / (numDenseTaps - 1.0) - 1.0;
+            const double window = besselI0 (beta * std::sqrt (1.0 - x * x)) / besselI0 (beta);
+            m_taps[i] = 0.5 * std::sin (hart::halfPi * distance) / (hart::halfPi * distance) * window;
+        }
+    }
+
+    /// @brief Latency in frames at the higher sample rate
+    size_t getLatencyFrames() const
+    {
+        return m_taps.size() - 1;
+    }
+
+    void reset()
+    {
+        std::fill (m_denseHistory.begin(), m_denseHistory.end(), 0.0);
+        std::fill (m_delayHistory.begin(), m_delayHistory.end(), 0.0);
+        m_position = 0;
+    }
+
+    /// @brief Doubles the sample rate
+    /// @param input @c numFrames frames at the lower sample rate
+    /// @param output @c 2*numFrames frames at the higher sample rate
+    void upsample (const double* input, double* output, size_t numFrames)
+    {
+        const size_t numTaps = m_taps.size();
+        const size_t delayFrames = numTaps / 2 - 1;
+
+        for (size_t frame = 0; frame < numFrames; ++frame)
+        {
+            const double* newest = push (m_denseHistory, input[frame]);
+
+            // Zero stuffing halves the level, so the taps get doubled
+            output[2 * frame] = 2.0 * applyTaps (newest);
+            output[2 * frame + 1] = newest[- static_cast<std::ptrdiff_t> (delayFrames)];
+            advance();
+        }
+    }
+
+    /// @brief Halves the sample rate
+    /// @param input @c 2*numFrames frames at the higher sample rate
+    /// @param output @c numFrames frames at the lower sample rate
+    void downsample (const double* input, double* output, size_t numFrames)
+    {
+        const size_t numTaps = m_taps.size();
+        const size_t delayFrames = numTaps / 2;
+
+        for (size_t frame = 0; frame < numFrames; ++frame)
+        {
+            const double* newest = push (m_denseHistory, input[2 * frame]);
+            const double* newestDelayed = push (m_delayHistory, input[2 * frame + 1]);
+            output[frame] = applyTaps (newest) + 0.5 * newestDelayed[- static_cast<std::ptrdiff_t> (delayFrames)];
+            advance();
+        }
+    }
+
+private:
+    std::vector<double> m_taps;
+    std::vector<double> m_denseHistory;
+    std::vector<double> m_delayHistory;
+    size_t m_position = 0;
+
+    /// @return Pointer to the newest frame, with the older ones right before it
+    const double* push (std::vector<double>& history, double value)
+    {
+        const size_t numTaps = m_taps.size();
+        history[m_position] = value;
+        history[m_position + numTaps] = value;
+        return &history[m_position + numTaps];
+    }
+
+    void advance()
+    {
+        if (++m_position == m_taps.size())
+            m_position = 0;
+    }
+
+    double applyTaps (const double* newest) const
+    {
+        const size_t numTaps = m_taps.size();
+        const double* oldest = newest - numTaps + 1;
+        double sum = 0.0;
+
+        // Taps are symmetrical, so it doesn't matter which way they go
+        for (size_t i = 0; i < numTaps; ++i)
+            sum += m_taps[i] * oldest[i];
+
+        return sum;
+    }
+
+    /// @brief Modified Bessel function of the first kind, order zero
+    static double besselI0 (double x)
+    {
+        double sum = 1.0;
+        double term = 1.0;
+
+        for (int k = 1; k < 50; ++k)
+        {
+            term *= (x / (2.0 * k)) * (x / (2.0 * k));
+            sum += term;
+
+            if (term < sum * 1e-16)
+                break;
+        }
+
+        return sum;
+    }
+};
+
+}  // namespace hart
@@ -0,0 +1,270 @@
+#pragma once
+
+#include <algorithm>  // copy(), fill(), min()
+#include <cmath>
+#include <complex>
+#include <vector>
+
+#include "hart_exceptions.hpp"
+#include "hart_fft.hpp"
+#include "hart_utils.hpp"
+
+namespace hart
+{
+
+/// @brief Streaming estimator of the fundamental frequency, based on the YIN algorithm
+/// @details The frames are pushed one by one into a ring buffer, and every hop the latest analysis window gets
+/// analysed. The window holds one integration period and one maximum lag, both as long as the period of the lowest
+/// frequency. The difference function of the window is calculated from its autocorrelation, which is done with an
+/// FFT, and then the running energy of the window, so the analysis costs O(N log N) per hop rather than O(N^2).
+/// Then the first dip of the cumulative mean normalized difference function below the threshold is taken for
+/// the period, and refined with a parabolic interpolation.
+///
+/// Even a short stretch of silence at the edge of the window throws the estimate off by a few cents, so the windows
+/// that have any silence in them are reported as silent, and not analysed at all. This way the onsets and tails
+/// of the signal don't get mistaken for the signal without any clear pitch.
+/// Used by the matchers like @ref FundamentalFrequencyAt.
+/// @private
+class PitchDetector
+{
+public:
+    /// @param minFrequencyHz Lowest detectable frequency in Hz, determines the length of the analysis window
+    /// @param maxFrequencyHz Highest detectable frequency in Hz
+    /// @param hopSeconds Time between two estimates in seconds
+    PitchDetector (double minFrequencyHz, double maxFrequencyHz, double hopSeconds = 0.005):
+        m_minFrequencyHz (minFrequencyHz),
+        m_maxFrequencyHz (maxFrequencyHz),
+        m_hopSeconds (hopSeconds)
+    {
+        if (minFrequencyHz <= 0 || maxFrequencyHz <= minFrequencyHz)
+            HART_THROW_OR_RETURN_VOID (hart::ValueError, "Invalid frequency range for pitch detection");
+
+        if (hopSeconds <= 0)
+            HART_THROW_OR_RETURN_VOID (hart::ValueError, "Hop time must be positive");
+    }
+
+    void prepare (double sampleRateHz)
+    {
+        m_sampleRateHz = sampleRateHz;
+        m_maxLagFrames = std::max<size_t> (4, (size_t) std::ceil (sampleRateHz / m_minFrequencyHz));
+        m_minLagFrames = clamp<size_t> ((size_t) std::floor (sampleRateHz / m_maxFrequencyHz), 2, m_maxLagFrames - 1);
+        m_integrationFrames = m_maxLagFrames;
+        m_windowFrames = m_integrationFrames + m_maxLagFrames;
+        m_hopFrames = std::max<size_t> (1, roundToSizeT (m_hopSeconds * sampleRateHz));
+
+        const size_t ringSize = nextPowerOfTwo (m_windowFrames);
+        m_ring.assign (ringSize, 0.0);
+        m_ringMask = ringSize - 1;
+
+        // Autocorrelation of up to the max lag doesn't wrap around in a transform of the whole window
+        const size_t fftSize = nextPowerOfTwo (m_windowFrames);
+        m_fft = RealFFT (fftSize);
+        m_window.assign (fftSize, 0.0);
+        m_head.assign (fftSize, 0.0);
+        m_windowSpectrum.resize (m_fft.getNumBins());
+        m_headSpectrum.resize (m_fft.getNumBins());
+        m_runningEnergy.resize (m_windowFrames + 1);
+        m_difference.resize (m_maxLagFrames + 1);
+        m_normalizedDifference.resize (m_maxLagFrames + 1);
+
+        reset();
+    }
+
+    void reset()
+    {
+        std::fill (m_ring.begin(), m_ring.end(), 0.0);
+        m_writePosition = 0;
+        m_numSilentFramesInRow = 0;
+        m_numFramesSinceSilence = 0;
+        m_framesUntilHop = m_hopFrames;
+        m_isSilent = true;
+        m_isPitched = false;
+        m_frequencyHz = 0.0;
+        m_aperiodicity = 1.0;
+    }
+
+    /// @brief Pushes the next frame
+    /// @return true if a new estimate has just been made, false otherwise
+    bool push (double sample)
+    {
+        m_numSilentFramesInRow = std::abs (sample) < silenceThreshold ? m_numSilentFramesInRow + 1 : 0;
+
+        if (m_numSilentFramesInRow >= minSilenceFrames)
+            m_numFramesSinceSilence = 0;
+        else if (m_numFramesSinceSilence < m_windowFrames)
+            ++m_numFramesSinceSilence;
+
+        m_ring[m_writePosition] = sample;
+        m_writePosition = (m_writePosition + 1) & m_ringMask;
+
+        --m_framesUntilHop;
+
+        if (m_framesUntilHop > 0)
+            return false;
+
+        m_framesUntilHop = m_hopFrames;
+
+        // The frames before the first one count as silence too, so the window gets filled up first
+        m_isSilent = m_numFramesSinceSilence < m_windowFrames;
+
+        m_estimateAgeFrames = m_windowFrames / 2;
+
+        if (m_isSilent)
+        {
+            m_isPitched = false;
+            m_frequencyHz = 0.0;
+            m_aperiodicity = 1.0;
+        }
+        else
+        {
+            analyse();
+        }
+
+        return true;
+    }
+
+    /// @brief Tells if the last analysis window had any silence in it, so it wasn't analysed
+    bool isSilent() const { return m_isSilent; }
+
+    /// @brief Tells if the last analysis window had a clear fundamental frequency
+    bool isPitched() const { return m_isPitched; }
+
+    /// @brief Returns the last estimated fundamental frequency in Hz, or zero if there was no clear pitch
+    double getFrequencyHz() const { return m_frequencyHz; }
+
+    /// @brief Returns the aperiodicity of the last analysis window, from 0 for a periodic signal to about 1 for noise
+    double getAperiodicity() const { return m_aperiodicity; }
+
+    /// @brief Returns the length of the analysis window in frames
+    size_t getWindowFrames() const { return m_windowFrames; }
+
+    /// @brief Returns how many frames before the latest pushed one the last estimate is for
+    /// @details The difference function compares the first half of the window to the frames one period later, so
+    /// a pitched estimate is for the middle of the first half, shifted by half a period, not for the middle of the window
+    size_t getEstimateAgeFrames() const { return m_estimateAgeFrames; }
+
+    /// @brief Returns the number of frames between two estimates
+    size_t getHopFrames() const { return m_hopFrames; }
+
+private:
+    double m_minFrequencyHz;
+    double m_maxFrequencyHz;
+    double m_hopSeconds;
+
+    double m_sampleRateHz = 0.0;
+    size_t m_minLagFrames = 0;
+    size_t m_maxLagFrames = 0;
+    size_t m_integrationFrames = 0;
+    size_t m_windowFrames = 0;
+    size_t m_hopFrames = 1;
+
+    std::vector<double> m_ring;
+    size_t m_ringMask = 0;
+    size_t m_writePosition = 0;
+    size_t m_framesUntilHop = 1;
+    size_t m_numSilentFramesInRow = 0;
+    size_t m_numFramesSinceSilence = 0;
+
+    RealFFT m_fft {2};
+    std::vector<double> m_window;
+    std::vector<double> m_head;
+    std::vector<std::complex<double>> m_windowSpectrum;
+    std::vector<std::complex<double>> m_headSpectrum;
+    std::vector<double> m_runningEnergy;
+    std::vector<double> m_difference;
+    std::vector<double> m_normalizedDifference;
+
+    bool m_isSilent = true;
+    bool m_isPitched = false;
+    double m_frequencyHz = 0.0;
+    double m_aperiodicity = 1.0;
+    size_t m_estimateAgeFrames = 0;
+
+    /// @brief Dips of the normalized difference below this value count as periods
+    static constexpr double periodicityThreshold = 0.2;
+
+    /// @brief Samples below this level (-80 dB) count as silent
+    static constexpr double silenceThreshold = 1e-4;
+
+    /// @brief This many silent samples in a row count as silence rather than a zero crossing
+    static constexpr size_t minSilenceFrames = 32;
+
+    void analyse()
+    {
+        // Unroll the ring, oldest frame first
+        const size_t startPosition = (m_writePosition - m_windowFrames) & m_ringMask;
+
+        for (size_t i = 0; i < m_windowFrames; ++i)
+            m_window[i] = m_ring[(startPosition + i) & m_ringMask];
+
+        m_runningEnergy[0] = 0.0;
+
+        for (size_t i = 0; i < m_windowFrames; ++i)
+            m_runningEnergy[i + 1] = m_runningEnergy[i] + m_window[i] * m_window[i];
+
+        m_isSilent = false;
+        m_isPitched = false;
+        m_frequencyHz = 0.0;
+        m_aperiodicity = 1.0;
+
+        const double headEnergy = m_runningEnergy[m_integrationFrames];
+
+        // Cross-correlation of the integration period with the whole window: sum of head[j] * window[j + lag]
+        std::copy (m_window.begin(), m_window.begin() + m_integrationFrames, m_head.begin());
+        m_fft.forward (m_window.data(), m_windowSpectrum.data());
+        m_fft.forward (m_head.data(), m_headSpectrum.data());
+
+        for (size_t bin = 0; bin < m_windowSpectrum.size(); ++bin)
+            m_windowSpectrum[bin] *= std::conj (m_headSpectrum[bin]);
+
+        m_fft.inverse (m_windowSpectrum.data(), m_head.data());
+
+        // Difference function and its cumulative mean normalized version
+        m_difference[0] = 0.0;
+        m_normalizedDifference[0] = 1.0;
+        double differenceSum = 0.0;
+
+        for (size_t lag = 1; lag <= m_maxLagFrames; ++lag)
+        {
+            const double lagEnergy = m_runningEnergy[lag + m_integrationFrames] - m_runningEnergy[lag];
+            m_difference[lag] = std::max (0.0, headEnergy + lagEnergy - 2.0 * m_head[lag]);
+            differenceSum += m_difference[lag];
+            m_normalizedDifference[lag] = differenceSum > 0.0 ? m_difference[lag] * lag / differenceSum : 1.0;
+        }
+
+        // Transform buffers get reused, so the zero padding of the head has to be restored
+        std::fill (m_head.begin() + m_integrationFrames, m_head.end(), 0.0);
+
+        size_t periodFrames = 0;
+
+        for (size_t lag = m_minLagFrames; lag < m_maxLagFrames; ++lag)
+        {
+            if (m_normalizedDifference[lag] < periodicityThreshold)
+            {
+                while (lag + 1 < m_maxLagFrames && m_normalizedDifference[lag + 1] < m_normalizedDifference[lag])
+                    ++lag;
+
+                periodFrames = lag;
+                break;
+            }
+        }
+
+        if (periodFrames == 0)
+            return;
+
+        m_isPitched = true;
+        m_aperiodicity = m_normalizedDifference[periodFrames];
+
+        // Parabolic interpolation of the raw difference, which is closer to a parabola around its dips
+        const double previous = m_difference[periodFrames - 1];
+        const double current = m_difference[periodFrames];
+        const double next = m_difference[periodFrames + 1];
+        const double curvature = previous - 2.0 * current + next;
+        const double offset = curvature > 0.0 ? clamp (0.5 * (previous - next) / curvature, -0.5, 0.5) : 0.0;
+
+        m_frequencyHz = m_sampleRateHz / (periodFrames + offset);
+        m_estimateAgeFrames = m_windowFrames - (m_integrationFrames + periodFrames) / 2;
+    }
+};
+
+}  // namespace hart
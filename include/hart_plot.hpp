@@ -4,17 +4,20 @@
 #include "../dependencies/signalsmith/plot.h"
 #include "../dependencies/choc/platform/choc_ReenableAllWarnings.h"
 
+#include <cmath>  // floor()
+#include <string>
+
 #include "hart_audio_buffer.hpp"
 
 namespace hart {
 
 /// @brief Plots audio buffers as an svg file
+/// @param startTimeSeconds Time of the first frame of the buffers, for plotting a piece cut out of a longer signal
 /// @private
 template <typename SampleType>
-void plotData (const AudioBuffer<SampleType>& input, const AudioBuffer<SampleType>& output, double sampleRateHz, const std::string& plotFilePath)
+void plotData (const AudioBuffer<SampleType>& input, const AudioBuffer<SampleType>& output, double sampleRateHz, const std::string& plotFilePath, double startTimeSeconds = 0.0)
 {
-    const double bufferSizeSeconds = static_cast <double> (output.getNumFrames()) / sampleRateHz;
-    const double timeIncrementSeconds = 1.0 / sampleRateHz;
+    const double endTimeSeconds = startTimeSeconds + static_cast <double> (output.getNumFrames()) / sampleRateHz;
 
     signalsmith::plot::Figure figure;
     auto& inputSignalPlot = figure (0, 0).plot (1200, 200);
@@ -32,42 +35,32 @@ void plotData (const AudioBuffer<SampleType>& input, const AudioBuffer<SampleTyp
     const SampleType outputSamplePeak = output.getMagnitude (0, output.getNumFrames());
     outputSignalPlot.y.minor (outputSamplePeak).minor (-outputSamplePeak);
 
-    for (double t = 0.1; t < bufferSizeSeconds + 1e-6; t += 0.1)
+    for (double t = std::floor (startTimeSeconds * 10.0) / 10.0 + 0.1; t < endTimeSeconds + 1e-6; t += 0.1)
     {
         inputSignalPlot.x.minor (t);
         outputSignalPlot.x.minor (t);
     }
 
-    for (double t = 1.0; t < bufferSizeSeconds + 1e-6; t += 1.0)
+    for (double t = std::floor (startTimeSeconds) + 1.0; t < endTimeSeconds + 1e-6; t += 1.0)
     {
         inputSignalPlot.x.major (t);
         outputSignalPlot.x.major (t);
     }
 
-    double timeSeconds = 0.0;
-
     for (size_t channel = 0; channel < input.getNumChannels(); ++channel)
     {
         auto &inputSignalLine = inputSignalPlot.line();
 
         for (size_t frame = 0; frame < input.getNumFrames(); ++frame)
-        {
-            inputSignalLine.add (timeSeconds, input[channel][frame]);
-            timeSeconds += timeIncrementSeconds;
-        }
+            inputSignalLine.add (startTimeSeconds + static_cast<double> (frame) / sampleRateHz, input[channel][frame]);
     }
 
-    timeSeconds = 0.0;
-
     for (size_t channel = 0; channel < output.getNumChannels(); ++channel)
     {
         auto &outputSignalLine = outputSignalPlot.line();
 
         for (size_t frame = 0; frame < output.getNumFrames(); ++frame)
-        {
-            outputSignalLine.add (timeSeconds, output[channel][frame]);
-            timeSeconds += timeIncrementSeconds;
-        }
+            outputSignalLine.add (startTimeSeconds + static_cast<double> (frame) / sampleRateHz, output[channel][frame]);
     }
 
     figure.write (plotFilePath);
@@ -0,0 +1,133 @@
+#pragma once
+
+#include <algorithm>  // fill()
+#include <cmath>
+#include <complex>
+#include <vector>
+
+#include "hart_exceptions.hpp"
+#include "hart_fft.hpp"
+#include "hart_utils.hpp"
+
+namespace hart
+{
+
+/// @brief Streaming short-time power spectrum of a single channel
+/// @details The frames are pushed one by one into a ring buffer, and every half of the frame, the latest frame gets
+/// windowed and transformed. The window is a 4-term Blackman-Harris one, so the side lobes of a pure tone stay about
+/// 92 dB below it, and its main lobe is 4 bins wide on either side. The transform and all the buffers are allocated
+/// in @ref prepare(), and reused for every frame after that.
+///
+/// An onset or a tail within the frame spreads all over the spectrum, so the frames that have any silence in them
+/// are skipped, and not transformed at all.
+/// Used by the matchers like @ref AliasingBelow.
+/// @private
+class PowerSpectrogram
+{
+public:
+    /// @brief Number of bins on either side of a pure tone that hold most of its energy
+    /// @details That's the main lobe of the window, plus its two highest side lobes. The rest of the side lobes
+    /// add up to about 90 dB below the tone.
+    static constexpr size_t toneHalfWidthBins = 6;
+
+    /// @param frameSize Number of frames per transform, must be a power of two, and at least 2
+    void prepare (size_t frameSize)
+    {
+        if (frameSize < 2 || ! isPowerOfTwo (frameSize))
+            HART_THROW_OR_RETURN_VOID (hart::SizeError, "Frame size must be a power of two");
+
+        m_frameSize = frameSize;
+        m_hopFrames = frameSize / 2;
+        m_fft = RealFFT (frameSize);
+
+        m_window.resize (frameSize);
+
+        for (size_t i = 0; i < frameSize; ++i)
+        {
+            const double phase = hart::twoPi * i / frameSize;
+            m_window[i] = 0.35875 - 0.48829 * std::cos (phase) + 0.14128 * std::cos (2.0 * phase) - 0.01168 * std::cos (3.0 * phase);
+        }
+
+        m_ring.assign (frameSize, 0.0);
+        m_windowedFrame.resize (frameSize);
+        m_spectrum.resize (m_fft.getNumBins());
+        m_powerSpectrum.resize (m_fft.getNumBins());
+        reset();
+    }
+
+    void reset()
+    {
+        std::fill (m_ring.begin(), m_ring.end(), 0.0);
+        std::fill (m_powerSpectrum.begin(), m_powerSpectrum.end(), 0.0);
+        m_numFramesPushed = 0;
+        m_numSilentFramesInRow = 0;
+        m_numFramesSinceSilence = 0;
+    }
+
+    /// @brief Adds a frame
+    /// @return true if a new power spectrum is ready, see @ref getPowerSpectrum()
+    bool push (double sample)
+    {
+        m_ring[m_numFramesPushed & (m_frameSize - 1)] = sample;
+        ++m_numFramesPushed;
+
+        m_numSilentFramesInRow = std::abs (sample) < silenceThreshold ? m_numSilentFramesInRow + 1 : 0;
+
+        if (m_numSilentFramesInRow >= minSilenceFrames)
+            m_numFramesSinceSilence = 0;
+        else if (m_numFramesSinceSilence < m_frameSize)
+            ++m_numFramesSinceSilence;
+
+        // The frames before the first one count as silence too, so the frame gets filled up first
+        if (m_numFramesPushed % m_hopFrames != 0 || m_numFramesSinceSilence < m_frameSize)
+            return false;
+
+        analyse();
+        return true;
+    }
+
+    size_t getFrameSize() const { return m_frameSize; }
+
+    size_t getNumBins() const { return m_powerSpectrum.size(); }
+
+    /// @brief Returns the index of the first frame of the latest transform, counting from the first frame pushed
+    size_t getFrameStart() const { return m_numFramesPushed - m_frameSize; }
+
+    /// @brief Returns the power of each bin of the latest transform, from DC to Nyquist
+    const std::vector<double>& getPowerSpectrum() const { return m_powerSpectrum; }
+
+private:
+    size_t m_frameSize = 2;
+    size_t m_hopFrames = 1;
+    RealFFT m_fft { 2 };
+    std::vector<double> m_window;
+    std::vector<double> m_ring;
+    std::vector<double> m_windowedFrame;
+    std::vector<std::complex<double>> m_spectrum;
+    std::vector<double> m_powerSpectrum;
+    size_t m_numFramesPushed = 0;
+    size_t m_numSilentFramesInRow = 0;
+    size_t m_numFramesSinceSilence = 0;
+
+    /// @brief Samples below this level (-80 dB) count as silent
+    static constexpr double silenceThreshold = 1e-4;
+
+    /// @brief This many silent samples in a row count as silence rather than a zero crossing
+    static constexpr size_t minSilenceFrames = 32;
+
+    void analyse()
+    {
+        // The oldest frame is the next one to be overwritten
+        const size_t mask = m_frameSize - 1;
+
+        for (size_t i = 0; i < m_frameSize; ++i)
+            m_windowedFrame[i] = m_ring[(m_numFramesPushed + i) & mask] * m_window[i];
+
+        m_fft.forward (m_windowedFrame.data(), m_spectrum.data());
+
+        for (size_t bin = 0; bin < m_spectrum.size(); ++bin)
+            m_powerSpectrum[bin] = std::norm (m_spectrum[bin]);
+    }
+};
+
+}  // namespace hart
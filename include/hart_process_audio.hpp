@@ -5,17 +5,16 @@
 #include <cmath>
 #include <iomanip>
 #include <memory>
-#include <sstream>
 #include <vector>
 
-#include "hart_audio_buffer.hpp"
+#include "hart_block_pipeline.hpp"
+#include "hart_cliconfig.hpp"
 #include "dsp/hart_dsp_all.hpp"
-#include "hart_expectation_failure_messages.hpp"
+#include "hart_failure_window.hpp"
 #include "matchers/hart_matcher.hpp"
-#include "hart_plot.hpp"
-#include "hart_precision.hpp"
-#include "hart_wavwriter.hpp"
+#include "hart_process_future.hpp"
 #include "signals/hart_signals_all.hpp"
+#include "hart_test_plan.hpp"
 #include "hart_utils.hpp"  // make_unique()
 
 namespace hart {
@@ -23,15 +22,6 @@ namespace hart {
 /// @defgroup TestRunner Test Runner
 /// @brief Runs the tests
 
-/// @brief Determines when to save a file
-/// @ingroup TestRunner
-enum class Save
-{
-    always,  ///< File will be saved always, after the test is performed
-    whenFails,  ///< File will be saved only when the test has failed
-    never  ///< File will not be saved
-};
-
 /// @brief A DSP host used for building and running tests inside a test case
 /// @ingroup TestRunner
 template <typename SampleType>
@@ -106,11 +96,14 @@ public:
     AudioTestBuilder& withValue (int id, double value)
     {
         // TODO: Handle cases when processor already has an envelope for this id
-        paramValues.emplace_back (ParamValue { id, value });
+        m_paramValues.emplace_back (ParamValue { id, value });
         return *this;
     }
 
     /// @brief Sets the total duration of the input signal to be processed
+    /// @details The duration gets multiplied by the `--duration-scale` CLI argument, and then
+    /// limited by the `--max-duration` CLI argument, so that the same test can run as a short smoke test
+    /// or as a long soak test. Use @ref withFixedDuration() if the test relies on an exact duration.
     /// @param Duration of the signal in seconds. You can use time-related literails from @ref Units.
     AudioTestBuilder& withDuration (double durationSeconds)
     {
@@ -118,15 +111,43 @@ public:
             HART_THROW_OR_RETURN(hart::ValueError, "Signal duration should be a non-negative value in Hz", *this);
 
         m_durationSeconds = durationSeconds;
+        m_isDurationFixed = false;
         return *this;
     }
 
-    /// @brief Sets the input signal for the test
+    /// @brief Sets the total duration of the input signal to be processed, ignoring the duration scaling
+    /// @details Unlike @ref withDuration(), it is not affected by the `--duration-scale` and `--max-duration` CLI arguments.
+    /// Use it when the test relies on an exact duration, e.g. when comparing to a reference wav file.
+    /// @param Duration of the signal in seconds. You can use time-related literails from @ref Units.
+    AudioTestBuilder& withFixedDuration (double durationSeconds)
+    {
+        withDuration (durationSeconds);
+        m_isDurationFixed = true;
+        return *this;
+    }
+
+    /// @brief Sets the input signal for the test by copying it
     /// @param signal Input signal, see @ref Signals
     AudioTestBuilder& withInputSignal (const Signal<SampleType>& signal)
     {
-        // TODO: Implement moving/transfering a signal instance as well
-        m_inputSignal = std::move (signal.copy());
+        m_inputSignal = signal.copy();
+        return *this;
+    }
+
+    /// @brief Sets the input signal for the test by moving it
+    /// @param signal Input signal, see @ref Signals
+    AudioTestBuilder& withInputSignal (Signal<SampleType>&& signal)
+    {
+        m_inputSignal = signal.move();
+        return *this;
+    }
+
+    /// @brief Sets the input signal for the test by transfering a smart pointer
+    /// @details Use this if your signal does not support copying or moving
+    /// @param signal Input signal, see @ref Signals
+    AudioTestBuilder& withInputSignal (std::unique_ptr<Signal<SampleType>> signal)
+    {
+        m_inputSignal = std::move (signal);
         return *this;
     }
 
@@ -318,6 +339,36 @@ public:
         return *this;
     }
 
+    /// @brief Cuts the files saved on failure down to a window around the first failed frame
+    /// @details Affects the output file set by @ref saveOutputTo() and the plot set by @ref savePlotTo(), as long as
+    /// they're saved with @ref Save::whenFails. Along with the output, the input is saved to a file with "_input" suffix,
+    /// and if the test has an @ref EqualsTo check, its reference signal is saved to a file with "_reference" suffix.
+    /// For example, "render.wav" gets accompanied by "render_input.wav" and "render_reference.wav".
+    /// Instead of keeping the whole signal, only a few recent blocks are kept, which makes a big difference for long tests.
+    /// @param preSeconds Time to keep before the failed frame, in seconds
+    /// @param postSeconds Time to keep after the failed frame, in seconds
+    AudioTestBuilder& withFailureWindow (double preSeconds, double postSeconds)
+    {
+        if (preSeconds < 0 || postSeconds < 0)
+            HART_THROW_OR_RETURN (hart::ValueError, "Failure window can't be negative", *this);
+
+        m_hasFailureWindow = true;
+        m_failureWindowPreSeconds = preSeconds;
+        m_failureWindowPostSeconds = postSeconds;
+        return *this;
+    }
+
+    /// @brief Renders the input, runs the DSP and does the checks on separate threads
+    /// @details Useful when the input signal or the checks are expensive enough to keep the DSP waiting for them.
+    /// The DSP still gets all the blocks on one thread, the one that calls @ref process(), and the failures are
+    /// reported exactly as they would be without pipelining. The input signal and the matchers are used from
+    /// other threads though, so they must not share any state with the DSP.
+    AudioTestBuilder& withPipelining()
+    {
+        m_isPipelined = true;
+        return *this;
+    }
+
     /// @brief Adds a label to the test
     /// @details Useful when you call @ref process() multiple times in one test case - the label
     /// will be put into test failure report to indicate exactly which test has failed.
@@ -328,101 +379,86 @@ public:
         return *this;
     }
 
-    /// @brief Perfoems the test
-    /// @details Call this after setting all the test parameters
-    std::unique_ptr<DSP<SampleType>> process()
+    /// @brief Prepares the test without running it
+    /// @details Hands the DSP, the input signal and all the checks over to a @ref TestPlan, which can then
+    /// be run as many times as needed, without re-preparing or re-allocating anything. Useful for benchmarks
+    /// and soak tests. The builder can't be used after this call.
+    /// @return Prepared test plan
+    TestPlan<SampleType> compile()
     {
-        m_durationFrames = (size_t) std::round (m_sampleRateHz * m_durationSeconds);
+        if (m_processor == nullptr)
+            HART_THROW_OR_RETURN (hart::StateError, "The tested DSP has already been handed over - call process() or compile() only once", TestPlan<SampleType> (nullptr));
 
-        if (m_durationFrames == 0)
-            HART_THROW_OR_RETURN (hart::SizeError, "Nothing to process", std::move (m_processor));
+        const double durationSeconds = m_isDurationFixed ? m_durationSeconds : scaleDuration (m_durationSeconds);
+        const size_t durationFrames = (size_t) std::round (m_sampleRateHz * durationSeconds);
 
-        for (auto& check : perBlockChecks)
-        {
-            check.matcher->prepare (m_sampleRateHz, m_numOutputChannels, m_blockSizeFrames);
-            check.matcher->reset();
-            check.shouldSkip = false;
-        }
-
-        for (auto& check : fullSignalChecks)
-        {
-            check.matcher->prepare (m_sampleRateHz, m_numOutputChannels, m_blockSizeFrames);
-            check.matcher->reset();
-            check.shouldSkip = false;
-        }
-
-        // TODO: Ckeck supportsChannelLayout() here
-        m_processor->reset();
-        m_processor->prepareWithEnvelopes (m_sampleRateHz, m_numInputChannels, m_numOutputChannels, m_blockSizeFrames);
-
-        for (const ParamValue& paramValue : paramValues)
-        {
-            // TODO: Add true/false return to indicate if setting the parameter was successful
-            m_processor->setValue (paramValue.id, paramValue.value);
-        }
+        if (durationFrames == 0)
+            HART_THROW_OR_RETURN (hart::SizeError, "Nothing to process", TestPlan<SampleType> (std::move (m_processor)));
 
         if (m_inputSignal == nullptr)
-            HART_THROW_OR_RETURN (hart::StateError, "No input signal - call withInputSignal() first!", std::move (m_processor));
+            HART_THROW_OR_RETURN (hart::StateError, "No input signal - call withInputSignal() first!", TestPlan<SampleType> (std::move (m_processor)));
 
-        m_inputSignal->resetWithDSPChain();
-        m_inputSignal->prepareWithDSPChain (m_sampleRateHz, m_numInputChannels, m_blockSizeFrames);
-        offsetFrames = 0;
+        // With a failure window, files saved on failure don't need the full signal, but the failures
+        // of full-signal checks still need the full input to cut the window out of
+        const bool savesFullPlot = m_savePlotMode == Save::always || (m_savePlotMode == Save::whenFails && ! m_hasFailureWindow);
+        const bool savesFullOutput = m_saveOutputMode == Save::always || (m_saveOutputMode == Save::whenFails && ! m_hasFailureWindow);
+        const bool keepsFullInput = savesFullPlot || (m_hasFailureWindow && ! m_fullSignalChecks.empty());
+        const bool keepsFullOutput = savesFullPlot || savesFullOutput || ! m_fullSignalChecks.empty();
 
-        AudioBuffer<SampleType> fullInputBuffer (m_numInputChannels);
-        AudioBuffer<SampleType> fullOutputBuffer (m_numOutputChannels);
-        bool atLeastOneCheckFailed = false;
+        TestPlan<SampleType> plan (std::move (m_processor), m_numInputChannels, m_numOutputChannels, m_blockSizeFrames, durationFrames, keepsFullInput, keepsFullOutput);
 
-        while (offsetFrames < m_durationFrames)
+        if (m_isPipelined)
         {
-            // TODO: Do not continue if there are no checks, or all checks should skip and there's no input and output file to write
-
-            const size_t blockSizeFrames = std::min (m_blockSizeFrames, m_durationFrames - offsetFrames);
-
-            hart::AudioBuffer<SampleType> inputBlock (m_numInputChannels, blockSizeFrames);
-            hart::AudioBuffer<SampleType> outputBlock (m_numOutputChannels, blockSizeFrames);
-            m_inputSignal->renderNextBlockWithDSPChain (inputBlock);
-            m_processor->processWithEnvelopes (inputBlock, outputBlock);
-
-            const bool allChecksPassed = processChecks (perBlockChecks, outputBlock);
-            atLeastOneCheckFailed |= ! allChecksPassed;
-            fullInputBuffer.appendFrom (inputBlock);
-            fullOutputBuffer.appendFrom (outputBlock);
-
-            offsetFrames += blockSizeFrames;
+            // A block for each of the three stages to work on, plus one to keep the render from waiting for the checks
+            const size_t numPipelineSlots = 4;
+            plan.m_pipeline = hart::make_unique<BlockPipeline<SampleType>> (numPipelineSlots, m_numInputChannels, m_numOutputChannels, m_blockSizeFrames);
         }
 
-        const bool allChecksPassed = processChecks (fullSignalChecks, fullOutputBuffer);
-        atLeastOneCheckFailed |= ! allChecksPassed;
-
-        if (m_saveOutputMode == Save::always || (m_saveOutputMode == Save::whenFails && atLeastOneCheckFailed))
-            WavWriter<SampleType>::writeBuffer (fullOutputBuffer, m_saveOutputPath, m_sampleRateHz, m_saveOutputWavFormat);
-    
-        if (m_savePlotMode == Save::always || (m_savePlotMode == Save::whenFails && atLeastOneCheckFailed))
-            plotData (fullInputBuffer, fullOutputBuffer, m_sampleRateHz, m_savePlotPath);
+        if (m_hasFailureWindow)
+        {
+            const size_t preFrames = (size_t) std::round (m_sampleRateHz * m_failureWindowPreSeconds);
+            const size_t postFrames = (size_t) std::round (m_sampleRateHz * m_failureWindowPostSeconds);
+            plan.m_failureWindow = hart::make_unique<FailureWindow<SampleType>> (m_numInputChannels, m_numOutputChannels, m_blockSizeFrames, preFrames, postFrames);
+        }
 
-        return std::move (m_processor);
+        plan.m_inputSignal = std::move (m_inputSignal);
+        plan.m_sampleRateHz = m_sampleRateHz;
+        plan.m_paramValues = std::move (m_paramValues);
+        plan.m_testLabel = m_testLabel;
+        plan.m_perBlockChecks = std::move (m_perBlockChecks);
+        plan.m_fullSignalChecks = std::move (m_fullSignalChecks);
+        plan.m_saveOutputPath = m_saveOutputPath;
+        plan.m_saveOutputMode = m_saveOutputMode;
+        plan.m_saveOutputWavFormat = m_saveOutputWavFormat;
+        plan.m_savePlotPath = m_savePlotPath;
+        plan.m_savePlotMode = m_savePlotMode;
+        plan.prepare();
+        return plan;
     }
 
-private:
-    struct ParamValue
+    /// @brief Perfoems the test
+    /// @details Call this after setting all the test parameters
+    std::unique_ptr<DSP<SampleType>> process()
     {
-        int id;
-        double value;
-    };
+        TestPlan<SampleType> plan = compile();
+        plan.run();
+        return plan.releaseProcessor();
+    }
 
-    enum class SignalAssertionLevel
+    /// @brief Perfoems the test on a shared thread pool
+    /// @details Lets a single test case launch many independent renders, and then wait for all of them.
+    /// The DSP, the signals and the matchers are copied and prepared on the calling thread, only the render itself happens
+    /// on the pool, so they don't need to be thread-safe, as long as different builders don't share any state.
+    /// @return Future that returns the DSP instance, see @ref ProcessFuture::get()
+    ProcessFuture<SampleType> processAsync()
     {
-        expect,
-        assert,
-    };
+        return ProcessFuture<SampleType> (compile());
+    }
 
-    struct Check
-    {
-        std::unique_ptr<Matcher<SampleType>> matcher;
-        SignalAssertionLevel signalAssertionLevel;
-        bool shouldSkip;
-        bool shouldPass;
-    };
+private:
+    using ParamValue = typename TestPlan<SampleType>::ParamValue;
+    using SignalAssertionLevel = typename TestPlan<SampleType>::SignalAssertionLevel;
+    using Check = typename TestPlan<SampleType>::Check;
 
     std::unique_ptr<DSP<SampleType>> m_processor;
     std::unique_ptr<Signal<SampleType>> m_inputSignal;
@@ -430,14 +466,13 @@ private:
     size_t m_blockSizeFrames = 1024;
     size_t m_numInputChannels = 1;
     size_t m_numOutputChannels = 1;
-    std::vector<ParamValue> paramValues;
+    std::vector<ParamValue> m_paramValues;
     double m_durationSeconds = 0.1;
-    size_t m_durationFrames = static_cast<size_t> (m_durationSeconds * m_sampleRateHz);
-    size_t offsetFrames = 0;
+    bool m_isDurationFixed = false;
     std::string m_testLabel = {};
 
-    std::vector<Check> perBlockChecks;
-    std::vector<Check> fullSignalChecks;
+    std::vector<Check> m_perBlockChecks;
+    std::vector<Check> m_fullSignalChecks;
 
     std::string m_saveOutputPath;
     Save m_saveOutputMode = Save::never;
@@ -446,14 +481,31 @@ private:
     std::string m_savePlotPath;
     Save m_savePlotMode = Save::never;
 
+    bool m_isPipelined = false;
+
+    bool m_hasFailureWindow = false;
+    double m_failureWindowPreSeconds = 0.0;
+    double m_failureWindowPostSeconds = 0.0;
+
+    static double scaleDuration (double durationSeconds)
+    {
+        const double scaledDurationSeconds = durationSeconds * CLIConfig::getInstance().getDurationScale();
+        const double maxDurationSeconds = CLIConfig::getInstance().getMaxDurationSeconds();
+
+        if (maxDurationSeconds > 0)
+            return std::min (scaledDurationSeconds, maxDurationSeconds);
+
+        return scaledDurationSeconds;
+    }
+
     void addCheck (const Matcher<SampleType>& matcher, SignalAssertionLevel signalAssertionLevel, bool shouldPass)
     {
         const bool forceFullSignal = ! shouldPass;  // No per-block checks for inverted matchers
         auto& checksGroup =
             (matcher.canOperatePerBlock() && ! forceFullSignal)
-                ? perBlockChecks
-                : fullSignalChecks;
-        checksGroup.emplace_back (AudioTestBuilder::Check {
+                ? m_perBlockChecks
+                : m_fullSignalChecks;
+        checksGroup.emplace_back (Check {
             matcher.copy(),
             signalAssertionLevel,
             false,  // shouldSkip
@@ -472,87 +524,15 @@ private:
         const bool forceFullSignal = ! shouldPass;  // No per-block checks for inverted matchers
         auto& checksGroup =
             (matcher.canOperatePerBlock() && ! forceFullSignal)
-                ? perBlockChecks
-                : fullSignalChecks;
-        checksGroup.emplace_back (AudioTestBuilder::Check {
+                ? m_perBlockChecks
+                : m_fullSignalChecks;
+        checksGroup.emplace_back (Check {
             hart::make_unique<DecayedType> (std::forward<MatcherType> (matcher)),
             signalAssertionLevel,
             false,  // shouldSkip
             shouldPass
         });
     }
-
-    bool processChecks (std::vector<Check>& checksGroup, AudioBuffer<SampleType>& outputBlock)
-    {
-        for (auto& check : checksGroup)
-        {
-            if (check.shouldSkip)
-                continue;
-
-            auto& assertionLevel = check.signalAssertionLevel;
-            auto& matcher = check.matcher;
-
-            const bool matchPassed = matcher->match (outputBlock);
-
-            if (matchPassed != check.shouldPass)
-            {
-                check.shouldSkip = true;
-                // TODO: Add optional label for each test
-
-                if (assertionLevel == SignalAssertionLevel::assert)
-                {
-                    std::stringstream stream;
-                    stream << (check.shouldPass ? "assertTrue() failed" : "assertFalse() failed");
-
-                    if (! m_testLabel.empty())
-                        stream << " at \"" << m_testLabel << "\"";
-
-                    stream << std::endl << "Condition: " << *matcher;
-
-                    if (check.shouldPass)
-                        appendFailureDetails (stream, matcher->getFailureDetails(), outputBlock);
-
-                    throw hart::TestAssertException (std::string (stream.str()));
-                }
-                else
-                {
-                    std::stringstream stream;
-                    stream << (check.shouldPass ? "expectTrue() failed" : "expectFalse() failed");
-
-                    if (!m_testLabel.empty())
-                        stream << " at \"" << m_testLabel << "\"";
-
-                    stream << std::endl << "Condition: " << * matcher;
-
-                    if (check.shouldPass)
-                        appendFailureDetails (stream, matcher->getFailureDetails(), outputBlock);
-
-                    hart::ExpectationFailureMessages::get().emplace_back (stream.str());
-                }
-
-                // TODO: FIXME: Do not throw indife of per-block loop if requested to write input or output to a wav file, throw after the loop instead
-                // TODO: Stop processing if expect has failed and outputting to a file wasn't requested
-                // TODO: Skip all checks if check failed, but asked to output a wav file
-                return false;
-            }
-        }
-
-        return true;
-    }
-
-    void appendFailureDetails (std::stringstream& stream, const MatcherFailureDetails& details, AudioBuffer<SampleType>& observedAudioBlock)
-    {
-        const double timestampSeconds = static_cast<double> (offsetFrames + details.frame) / m_sampleRateHz;
-        const SampleType sampleValue = observedAudioBlock[details.channel][details.frame];
-
-        stream << std::endl
-            << "Channel: " << details.channel << std::endl
-            << "Frame: " << details.frame << std::endl
-            << secPrecision << "Timestamp: " << timestampSeconds << " seconds" << std::endl
-            << linPrecision << "Sample value: " << sampleValue
-            << dbPrecision << " (" << ratioToDecibels (std::abs (sampleValue)) << " dB)" << std::endl
-            << details.description;
-    }
 };
 
 /// @brief Call this to start building your test
@@ -0,0 +1,152 @@
+#pragma once
+
+#include <condition_variable>
+#include <exception>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <utility>  // move()
+#include <vector>
+
+#include "hart_cancellation.hpp"
+#include "dsp/hart_dsp.hpp"
+#include "hart_expectation_failure_messages.hpp"
+#include "hart_test_plan.hpp"
+#include "hart_thread_pool.hpp"
+
+namespace hart {
+
+/// @brief Result of @ref AudioTestBuilder::processAsync()
+/// @details Call @ref get() to wait for the test to finish and get the DSP back, just like the one returned by
+/// @ref AudioTestBuilder::process(). Failed expectations are reported to the test that has launched the render,
+/// no matter which thread it has actually run on, and failed assertions are re-thrown by @ref get().
+/// If the future is destroyed without calling @ref get(), it still waits for the test to finish and reports
+/// the failed expectations, but the failed assertions get lost.
+/// @ingroup TestRunner
+template <typename SampleType>
+class ProcessFuture
+{
+public:
+    ProcessFuture (ProcessFuture&& other) = default;
+    ProcessFuture& operator= (ProcessFuture&& other) = default;
+
+    ~ProcessFuture()
+    {
+        if (m_state != nullptr)
+            finish();
+    }
+
+    /// @brief Waits for the test to finish
+    /// @details The calling thread helps rendering the pending tests while it waits
+    /// @return DSP instance, so you can re-use it
+    std::unique_ptr<DSP<SampleType>> get()
+    {
+        if (m_state == nullptr)
+            HART_THROW_OR_RETURN (hart::StateError, "ProcessFuture::get() can only be called once", nullptr);
+
+        std::shared_ptr<State> state = std::move (m_state);
+        finish (*state);
+
+        if (state->exception != nullptr)
+            std::rethrow_exception (state->exception);
+
+        return std::move (state->processor);
+    }
+
+private:
+    template <typename>
+    friend class AudioTestBuilder;
+
+    struct State
+    {
+        TestPlan<SampleType> plan;
+        CancellationToken* cancellationToken;
+        std::unique_ptr<DSP<SampleType>> processor;
+        std::vector<std::string> expectationFailureMessages;
+        std::exception_ptr exception;
+        bool isDone = false;
+        std::mutex mutex;
+        std::condition_variable condition;
+
+        State (TestPlan<SampleType>&& planToRun, CancellationToken* token):
+            plan (std::move (planToRun)),
+            cancellationToken (token)
+        {
+        }
+    };
+
+    std::shared_ptr<State> m_state;
+
+    /// @brief Schedules the plan on a shared thread pool
+    ProcessFuture (TestPlan<SampleType>&& plan):
+        m_state (std::make_shared<State> (std::move (plan), CancellationToken::getCurrent()))
+    {
+        std::shared_ptr<State> state = m_state;
+        ThreadPool::getSharedInstance().enqueue ([state] { render (*state); });
+    }
+
+    void finish()
+    {
+        std::shared_ptr<State> state = std::move (m_state);
+        finish (*state);
+    }
+
+    static void finish (State& state)
+    {
+        ThreadPool& threadPool = ThreadPool::getSharedInstance();
+
+        while (true)
+        {
+            {
+                std::unique_lock<std::mutex> lock (state.mutex);
+
+                if (state.isDone)
+                    break;
+
+                // Nothing to help with, so the render is running on some other thread
+                if (! threadPool.hasPendingJobs())
+                {
+                    state.condition.wait (lock, [&state] { return state.isDone; });
+                    break;
+                }
+            }
+
+            threadPool.tryRunPendingJob();
+        }
+
+        auto& messages = ExpectationFailureMessages::get();
+        messages.insert (messages.end(), state.expectationFailureMessages.begin(), state.expectationFailureMessages.end());
+        state.expectationFailureMessages.clear();
+    }
+
+    static void render (State& state)
+    {
+        // Render may happen on the thread of some test that is waiting for its own renders,
+        // so whatever belongs to that test is put aside for the time being
+        std::vector<std::string> ownerExpectationFailureMessages = std::move (ExpectationFailureMessages::get());
+        ExpectationFailureMessages::clear();
+        CancellationToken* ownerCancellationToken = CancellationToken::getCurrent();
+        CancellationToken::setCurrent (state.cancellationToken);
+
+        try
+        {
+            state.plan.run();
+        }
+        catch (...)
+        {
+            state.exception = std::current_exception();
+        }
+
+        CancellationToken::setCurrent (ownerCancellationToken);
+        std::vector<std::string> expectationFailureMessages = std::move (ExpectationFailureMessages::get());
+        ExpectationFailureMessages::get() = std::move (ownerExpectationFailureMessages);
+
+        std::lock_guard<std::mutex> lock (state.mutex);
+        state.processor = state.plan.releaseProcessor();
+        state.expectationFailureMessages = std::move (expectationFailureMessages);
+        state.isDone = true;
+        state.condition.notify_all();
+    }
+};
+
+}  // namespace hart
@@ -0,0 +1,217 @@
+#pragma once
+
+#include <cstdint>
+#include <fstream>
+#include <iomanip>
+#include <sstream>
+#include <string>
+#include <unordered_map>
+#include <utility>  // pair
+#include <vector>
+
+namespace hart
+{
+
+/// @brief Remembers which tests have passed, and under which conditions
+/// @details Each passed test is stored together with a fingerprint of the test binary, the relevant
+/// CLI config, and the contents of every data file that the test has accessed. A test is considered
+/// up-to-date if none of those have changed since, so it can be skipped. Failed tests are never cached,
+/// so that their failure reports are always there. Used by @ref TestRegistry when the `--cache-dir`
+/// CLI argument is set.
+/// @private
+class ResultCache
+{
+public:
+    /// @brief Loads the cache file, if there is one
+    /// @details All entries made by a different binary or with different config are discarded.
+    /// @param cacheFilePath Path to the file to load the entries from and save them to
+    /// @param binaryFingerprint Fingerprint of the test binary, see @ref fingerprintFile()
+    /// @param configFingerprint Fingerprint of everything else that affects results of all the tests
+    void load (const std::string& cacheFilePath, const std::string& binaryFingerprint, const std::string& configFingerprint)
+    {
+        m_cacheFilePath = cacheFilePath;
+        m_binaryFingerprint = binaryFingerprint;
+        m_configFingerprint = configFingerprint;
+        m_entries.clear();
+        m_isEnabled = true;
+
+        std::ifstream file (cacheFilePath);
+
+        if (! file.is_open())
+            return;
+
+        std::string line;
+
+        if (! std::getline (file, line) || line != fileHeader)
+            return;
+
+        if (! std::getline (file, line) || line != "binary " + binaryFingerprint)
+            return;
+
+        if (! std::getline (file, line) || line != "config " + configFingerprint)
+            return;
+
+        Entry* currentEntry = nullptr;
+
+        while (std::getline (file, line))
+        {
+            if (startsWith (line, "test "))
+            {
+                currentEntry = &m_entries[line.substr (5)];
+                currentEntry->files.clear();
+            }
+            else if (startsWith (line, "file ") && currentEntry != nullptr)
+            {
+                const size_t separatorPos = line.find (' ', 5);
+
+                if (separatorPos == std::string::npos)
+                    continue;
+
+                currentEntry->files.emplace_back (line.substr (separatorPos + 1), line.substr (5, separatorPos - 5));
+            }
+        }
+    }
+
+    /// @brief Checks whether the cache has been loaded
+    bool isEnabled() const
+    {
+        return m_isEnabled;
+    }
+
+    /// @brief Checks whether the test has passed before, and nothing has changed since
+    bool isUpToDate (const std::string& testName) const
+    {
+        if (! m_isEnabled)
+            return false;
+
+        const auto it = m_entries.find (testName);
+
+        if (it == m_entries.end())
+            return false;
+
+        for (const auto& file : it->second.files)
+        {
+            if (fingerprintFile (file.first) != file.second)
+                return false;
+        }
+
+        return true;
+    }
+
+    /// @brief Records a passed test
+    /// @param testName Name of the test
+    /// @param accessedFiles Paths of all data files the test has accessed
+    void storePassed (const std::string& testName, const std::vector<std::string>& accessedFiles)
+    {
+        if (! m_isEnabled)
+            return;
+
+        Entry& entry = m_entries[testName];
+        entry.files.clear();
+
+        for (const std::string& filePath : accessedFiles)
+            entry.files.emplace_back (filePath, fingerprintFile (filePath));
+    }
+
+    /// @brief Removes the test from the cache, so that it gets re-run next time
+    void forget (const std::string& testName)
+    {
+        m_entries.erase (testName);
+    }
+
+    /// @brief Writes all the entries to the cache file
+    /// @return true if the file was written successfully, false otherwise
+    bool save() const
+    {
+        if (! m_isEnabled)
+            return false;
+
+        std::ofstream file (m_cacheFilePath, std::ios::trunc);
+
+        if (! file.is_open())
+            return false;
+
+        file << fileHeader << '\n';
+        file << "binary " << m_binaryFingerprint << '\n';
+        file << "config " << m_configFingerprint << '\n';
+
+        for (const auto& entry : m_entries)
+        {
+            file << "test " << entry.first << '\n';
+
+            for (const auto& fileFingerprint : entry.second.files)
+                file << "file " << fileFingerprint.second << ' ' << fileFingerprint.first << '\n';
+        }
+
+        return file.good();
+    }
+
+    /// @brief Makes a fingerprint of the file contents
+    /// @return Hex string with 64-bit FNV-1a hash of the file, or "missing" if the file can't be read
+    static std::string fingerprintFile (const std::string& filePath)
+    {
+        std::ifstream file (filePath, std::ios::binary);
+
+        if (! file.is_open())
+            return "missing";
+
+        uint64_t hash = fnvOffsetBasis;
+        char chunk[8192];
+
+        while (file)
+        {
+            file.read (chunk, sizeof (chunk));
+            hash = fnv1a (chunk, static_cast<size_t> (file.gcount()), hash);
+        }
+
+        return toHex (hash);
+    }
+
+    /// @brief Makes a fingerprint of a string
+    /// @return Hex string with 64-bit FNV-1a hash of the string
+    static std::string fingerprintString (const std::string& text)
+    {
+        return toHex (fnv1a (text.data(), text.size(), fnvOffsetBasis));
+    }
+
+private:
+    struct Entry
+    {
+        std::vector<std::pair<std::string, std::string>> files;  // Path, fingerprint
+    };
+
+    static constexpr const char* fileHeader = "HART result cache v1";
+    static constexpr uint64_t fnvOffsetBasis = 14695981039346656037ull;
+    static constexpr uint64_t fnvPrime = 1099511628211ull;
+
+    std::unordered_map<std::string, Entry> m_entries;
+    std::string m_cacheFilePath;
+    std::string m_binaryFingerprint;
+    std::string m_configFingerprint;
+    bool m_isEnabled = false;
+
+    static uint64_t fnv1a (const char* data, size_t numBytes, uint64_t hash)
+    {
+        for (size_t i = 0; i < numBytes; ++i)
+        {
+            hash ^= static_cast<uint8_t> (data[i]);
+            hash *= fnvPrime;
+        }
+
+        return hash;
+    }
+
+    static std::string toHex (uint64_t hash)
+    {
+        std::stringstream stream;
+        stream << std::hex << std::setw (16) << std::setfill ('0') << hash;
+        return stream.str();
+    }
+
+    static bool startsWith (const std::string& text, const char* prefix)
+    {
+        return text.compare (0, std::char_traits<char>::length (prefix), prefix) == 0;
+    }
+};
+
+}  // namespace hart
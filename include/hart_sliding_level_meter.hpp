@@ -0,0 +1,127 @@
+#pragma once
+
+#include <algorithm>  // fill(), max()
+#include <cmath>
+#include <vector>
+
+#include "hart_fft.hpp"  // nextPowerOfTwo()
+#include "hart_utils.hpp"
+
+namespace hart
+{
+
+/// @brief Measures RMS or peak level over a sliding window, at every frame
+/// @details RMS is kept as a running sum of squares, so each frame costs O(1) no matter how long the window is.
+/// To keep the rounding errors of the running sum from building up, it gets summed from scratch once per window length,
+/// which is still O(1) per frame on average. Peak is kept with a monotonic queue of the frames that can still become
+/// the loudest one in the window, which is O(1) per frame on average too.
+/// Used by the matchers like @ref LevelTracks.
+/// @private
+class SlidingLevelMeter
+{
+public:
+    /// @param windowFrames Length of the window in frames
+    /// @param measuresPeak true for the peak level, false for the RMS level
+    void prepare (size_t windowFrames, bool measuresPeak)
+    {
+        m_windowFrames = std::max<size_t> (1, windowFrames);
+        m_measuresPeak = measuresPeak;
+
+        if (measuresPeak)
+        {
+            m_squares.clear();
+            const size_t queueSize = nextPowerOfTwo (m_windowFrames + 1);
+            m_queueFrames.resize (queueSize);
+            m_queueValues.resize (queueSize);
+            m_queueMask = queueSize - 1;
+        }
+        else
+        {
+            m_squares.resize (m_windowFrames);
+            m_queueFrames.clear();
+            m_queueValues.clear();
+        }
+
+        reset();
+    }
+
+    void reset()
+    {
+        std::fill (m_squares.begin(), m_squares.end(), 0.0);
+        m_sumOfSquares = 0.0;
+        m_squaresPosition = 0;
+        m_queueBegin = 0;
+        m_queueEnd = 0;
+        m_numFramesPushed = 0;
+    }
+
+    void push (double sample)
+    {
+        if (m_measuresPeak)
+            pushPeak (std::abs (sample));
+        else
+            pushSquare (sample * sample);
+
+        ++m_numFramesPushed;
+    }
+
+    /// @brief Tells if the window has been filled up, so that the level makes sense
+    bool isWindowFull() const { return m_numFramesPushed >= m_windowFrames; }
+
+    /// @brief Returns the level over the last window, in decibels
+    double getLevelDb() const
+    {
+        if (m_measuresPeak)
+            return ratioToDecibels (m_queueBegin == m_queueEnd ? 0.0 : m_queueValues[m_queueBegin & m_queueMask]);
+
+        return ratioToDecibels (std::sqrt (std::max (0.0, m_sumOfSquares) / m_windowFrames));
+    }
+
+private:
+    size_t m_windowFrames = 1;
+    bool m_measuresPeak = false;
+    size_t m_numFramesPushed = 0;
+
+    std::vector<double> m_squares;
+    double m_sumOfSquares = 0.0;
+    size_t m_squaresPosition = 0;
+
+    std::vector<size_t> m_queueFrames;
+    std::vector<double> m_queueValues;
+    size_t m_queueMask = 0;
+    size_t m_queueBegin = 0;
+    size_t m_queueEnd = 0;
+
+    void pushSquare (double square)
+    {
+        m_sumOfSquares += square - m_squares[m_squaresPosition];
+        m_squares[m_squaresPosition] = square;
+        ++m_squaresPosition;
+
+        if (m_squaresPosition == m_windowFrames)
+        {
+            m_squaresPosition = 0;
+            m_sumOfSquares = 0.0;
+
+            for (const double value : m_squares)
+                m_sumOfSquares += value;
+        }
+    }
+
+    void pushPeak (double magnitude)
+    {
+        // Quieter frames before a louder one can never be the peak again
+        while (m_queueEnd != m_queueBegin && m_queueValues[(m_queueEnd - 1) & m_queueMask] <= magnitude)
+            --m_queueEnd;
+
+        m_queueFrames[m_queueEnd & m_queueMask] = m_numFramesPushed;
+        m_queueValues[m_queueEnd & m_queueMask] = magnitude;
+        ++m_queueEnd;
+
+        // Frames that have left the window
+        while (m_queueFrames[m_queueBegin & m_queueMask] + m_windowFrames <= m_numFramesPushed)
+            ++m_queueBegin;
+    }
+};
+
+}  // namespace hart
@@ -0,0 +1,154 @@
+#pragma once
+
+#include <algorithm>  // max(), min()
+#include <cmath>
+
+#include "hart_exceptions.hpp"
+#include "hart_utils.hpp"
+
+namespace hart
+{
+
+/// @brief Measures the stereo image of the audio over consecutive windows
+/// @details Only keeps three running sums per window: energy of the left channel, energy of the right channel, and
+/// their cross product. Those are enough for the correlation, the balance, and the energies of the mid and side
+/// channels, so nothing else of the audio needs to be kept, and the windows can span as many blocks as needed.
+/// Used by the matchers like @ref StereoCorrelationWithin.
+/// @private
+class StereoMeter
+{
+public:
+    /// @param windowSeconds Length of each window in seconds
+    StereoMeter (double windowSeconds):
+        m_windowSeconds (windowSeconds)
+    {
+        if (windowSeconds <= 0)
+            HART_THROW_OR_RETURN_VOID (hart::ValueError, "Window duration must be positive");
+    }
+
+    void prepare (double sampleRateHz)
+    {
+        m_windowFrames = std::max<size_t> (1, roundToSizeT (m_windowSeconds * sampleRateHz));
+        reset();
+    }
+
+    void reset()
+    {
+        m_leftEnergy = 0.0;
+        m_rightEnergy = 0.0;
+        m_crossProduct = 0.0;
+        m_numFramesInWindow = 0;
+    }
+
+    /// @brief Adds the frames to the current window, up to its end
+    /// @details Start the next window with @ref startNextWindow() once it's complete
+    /// @return Number of frames taken, may be less than numFrames if the window got complete
+    template <typename SampleType>
+    size_t push (const SampleType* left, const SampleType* right, size_t numFrames)
+    {
+        const size_t numFramesToPush = std::min (numFrames, m_windowFrames - m_numFramesInWindow);
+
+        // Independent partial sums don't depend on each other's results, so the compiler can vectorize this loop
+        // and keep the pipeline busy without reordering the floating point math on its own
+        constexpr size_t numLanes = 4;
+        double leftEnergy[numLanes] = {};
+        double rightEnergy[numLanes] = {};
+        double crossProduct[numLanes] = {};
+        size_t frame = 0;
+
+        for (; frame + numLanes <= numFramesToPush; frame += numLanes)
+        {
+            for (size_t lane = 0; lane < numLanes; ++lane)
+            {
+                const double l = left[frame + lane];
+                const double r = right[frame + lane];
+                leftEnergy[lane] += l * l;
+                rightEnergy[lane] += r * r;
+                crossProduct[lane] += l * r;
+            }
+        }
+
+        for (; frame < numFramesToPush; ++frame)
+        {
+            const double l = left[frame];
+            const double r = right[frame];
+            leftEnergy[0] += l * l;
+            rightEnergy[0] += r * r;
+            crossProduct[0] += l * r;
+        }
+
+        for (size_t lane = 0; lane < numLanes; ++lane)
+        {
+            m_leftEnergy += leftEnergy[lane];
+            m_rightEnergy += rightEnergy[lane];
+            m_crossProduct += crossProduct[lane];
+        }
+
+        m_numFramesInWindow += numFramesToPush;
+        return numFramesToPush;
+    }
+
+    bool isWindowComplete() const { return m_numFramesInWindow == m_windowFrames; }
+
+    void startNextWindow() { reset(); }
+
+    size_t getWindowFrames() const { return m_windowFrames; }
+
+    /// @brief Tells if the left channel was silent (below -80 dB RMS) over the window
+    bool isLeftSilent() const { return isSilent (m_leftEnergy); }
+
+    /// @brief Tells if the right channel was silent (below -80 dB RMS) over the window
+    bool isRightSilent() const { return isSilent (m_rightEnergy); }
+
+    /// @brief Returns the correlation coefficient of the channels, from -1 for opposite polarity to 1 for identical ones
+    /// @details Makes no sense if either of the channels is silent, and returns zero in that case
+    double getCorrelation() const
+    {
+        if (isLeftSilent() || isRightSilent())
+            return 0.0;
+
+        return clamp (m_crossProduct / std::sqrt (m_leftEnergy * m_rightEnergy), -1.0, 1.0);
+    }
+
+    /// @brief Returns the level of the right channel relative to the left one in decibels, from -120 to 120 dB
+    double getBalanceDb() const
+    {
+        return energyRatioToDecibels (m_rightEnergy, m_leftEnergy);
+    }
+
+    /// @brief Returns the energy of the mid channel relative to the side channel in decibels, from -120 to 120 dB
+    /// @details Mid is (L + R) / 2, and side is (L - R) / 2
+    double getMidSideRatioDb() const
+    {
+        const double midEnergy = 0.25 * (m_leftEnergy + 2.0 * m_crossProduct + m_rightEnergy);
+        const double sideEnergy = 0.25 * (m_leftEnergy - 2.0 * m_crossProduct + m_rightEnergy);
+        return energyRatioToDecibels (std::max (0.0, midEnergy), std::max (0.0, sideEnergy));
+    }
+
+private:
+    double m_windowSeconds;
+    size_t m_windowFrames = 1;
+
+    double m_leftEnergy = 0.0;
+    double m_rightEnergy = 0.0;
+    double m_crossProduct = 0.0;
+    size_t m_numFramesInWindow = 0;
+
+    bool isSilent (double energy) const
+    {
+        return energy < 1e-8 * m_windowFrames;
+    }
+
+    static double energyRatioToDecibels (double numerator, double denominator)
+    {
+        if (numerator <= 1e-12 * denominator)
+            return -120.0;
+
+        if (denominator <= 1e-12 * numerator)
+            return 120.0;
+
+        return 10.0 * std::log10 (numerator / denominator);
+    }
+};
+
+}  // namespace hart
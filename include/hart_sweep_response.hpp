@@ -0,0 +1,235 @@
+#pragma once
+
+#include <algorithm>  // copy(), fill(), max(), min()
+#include <cmath>
+#include <complex>
+#include <vector>
+
+#include "hart_audio_buffer.hpp"
+#include "hart_exceptions.hpp"
+#include "hart_fft.hpp"
+#include "matchers/hart_response_mask.hpp"
+#include "signals/hart_sine_sweep.hpp"
+#include "hart_utils.hpp"
+
+namespace hart
+{
+
+/// @brief Measures impulse, magnitude and phase response of a DSP effect from its output for a sine sweep
+/// @details The output gets deconvolved with the sweep in frequency domain, using regularized spectral division,
+/// which gives the impulse response of the effect. With a log sweep, the harmonic distortion products end up
+/// before the linear impulse response in time (Farina method), so they're windowed out, and only the linear
+/// response gets measured, even if the effect distorts. The response is only meaningful within the frequency range
+/// of the sweep, see @ref isInSweepRange().
+///
+/// The spectrum of the sweep is calculated once, and reused for the following measurements of the same length.
+/// Used by the matchers like @ref FrequencyResponseWithin.
+/// @private
+template <typename SampleType>
+class SweepResponse
+{
+public:
+    /// @param sweep Sweep that the effect gets as an input. It can have its own DSP chain, it's all part of the stimulus.
+    SweepResponse (const SineSweep<SampleType>& sweep):
+        m_sweep (sweep)
+    {
+        if (sweep.getLoop() == SineSweep<SampleType>::Loop::yes)
+            HART_THROW_OR_RETURN_VOID (hart::ValueError, "Response can only be measured with a sweep that doesn't loop");
+
+        if (sweep.getDurationSeconds() <= 0)
+            HART_THROW_OR_RETURN_VOID (hart::ValueError, "Response can't be measured with an empty sweep");
+    }
+
+    void prepare (double sampleRateHz)
+    {
+        m_sampleRateHz = sampleRateHz;
+        m_sweepSpectrum.clear();
+    }
+
+    /// @brief Measures the response
+    /// @param observedFrames Output of the effect, starting at the same time as the sweep
+    /// @param numFrames Number of frames, should be long enough for both the sweep and the tail of the effect
+    /// @return false if the output is shorter than the sweep, true otherwise
+    bool measure (const SampleType* observedFrames, size_t numFrames)
+    {
+        const size_t sweepFrames = getSweepFrames();
+
+        if (numFrames < sweepFrames)
+            return false;
+
+        // Twice the length, so neither the tail of the effect nor the distortion products before it wrap around
+        const size_t fftSize = nextPowerOfTwo (2 * numFrames);
+
+        if (m_sweepSpectrum.empty() || m_fft.getSize() != fftSize)
+            prepareSweepSpectrum (fftSize, sweepFrames);
+
+        const size_t numBins = m_fft.getNumBins();
+        m_frames.assign (fftSize, 0.0);
+        std::copy (observedFrames, observedFrames + numFrames, m_frames.begin());
+        m_response.resize (numBins);
+        m_fft.forward (m_frames.data(), m_response.data());
+
+        for (size_t bin = 0; bin < numBins; ++bin)
+        {
+            const std::complex<double> sweepBin = m_sweepSpectrum[bin];
+            m_response[bin] *= std::conj (sweepBin) / (std::norm (sweepBin) + m_regularization);
+        }
+
+        m_fft.inverse (m_response.data(), m_frames.data());
+
+        // Negative time holds the harmonic distortion products, only a short fade-in before zero is kept
+        const size_t fadeInFrames = std::min<size_t> (64, fftSize / 4);
+        std::fill (m_frames.begin() + fftSize / 2, m_frames.end() - fadeInFrames, 0.0);
+
+        for (size_t i = 0; i < fadeInFrames; ++i)
+            m_frames[fftSize - fadeInFrames + i] *= 0.5 - 0.5 * std::cos (hart::pi * i / fadeInFrames);
+
+        m_impulseResponse.assign (m_frames.begin(), m_frames.begin() + fftSize / 2);
+        m_fft.forward (m_frames.data(), m_response.data());
+
+        m_peakMagnitude = 0.0;
+
+        for (size_t bin = 0; bin < numBins; ++bin)
+            if (isInSweepRange (bin))
+                m_peakMagnitude = std::max (m_peakMagnitude, std::abs (m_response[bin]));
+
+        return true;
+    }
+
+    /// @brief Checks the response against the mask, within the sweep range
+    /// @param mask Limits for the values
+    /// @param getValue Callable that takes a bin index and returns the value to check, like the magnitude in decibels
+    /// @param shouldSkipQuietBins If true, bins that are more than 60 dB below the peak are not checked,
+    /// which is handy for phase, as it's mostly noise there
+    /// @param[out] failedBin Bin where the value is outside of the limits
+    /// @param[out] failedBand Band with the limits that the value is outside of
+    /// @return true if all the values are within the limits, false otherwise
+    template <typename ValueGetter>
+    bool isWithin (const ResponseMask& mask, ValueGetter getValue, bool shouldSkipQuietBins, size_t& failedBin, ResponseMask::Band& failedBand) const
+    {
+        const double binWidthHz = getBinFrequencyHz (1);
+
+        for (const ResponseMask::Band& band : mask.getBands())
+        {
+            for (size_t bin = static_cast<size_t> (std::ceil (band.startHz / binWidthHz)); bin < m_response.size() && getBinFrequencyHz (bin) <= band.endHz; ++bin)
+            {
+                if (! isInSweepRange (bin) || (shouldSkipQuietBins && std::abs (m_response[bin]) < 1e-3 * m_peakMagnitude))
+                    continue;
+
+                const double value = getValue (bin);
+
+                if (value < band.minValue || value > band.maxValue)
+                {
+                    failedBin = bin;
+                    failedBand = band;
+                    return false;
+                }
+            }
+        }
+
+        return true;
+    }
+
+    /// @brief Number of frequency bins in the measured response, from DC to Nyquist
+    size_t getNumBins() const { return m_response.size(); }
+
+    double getBinFrequencyHz (size_t bin) const
+    {
+        return bin * m_sampleRateHz / m_fft.getSize();
+    }
+
+    /// @brief Tells whether the bin is within the frequency range of the sweep, outside of which the response is meaningless
+    bool isInSweepRange (size_t bin) const
+    {
+        const double frequencyHz = getBinFrequencyHz (bin);
+        const double lowestFrequencyHz = std::min (m_sweep.getStartFrequencyHz(), m_sweep.getEndFrequencyHz());
+        const double highestFrequencyHz = std::min (std::max (m_sweep.getStartFrequencyHz(), m_sweep.getEndFrequencyHz()), m_sampleRateHz / 2);
+        return frequencyHz >= lowestFrequencyHz && frequencyHz <= highestFrequencyHz;
+    }
+
+    double getMagnitudeDb (size_t bin) const
+    {
+        return ratioToDecibels (std::abs (m_response[bin]));
+    }
+
+    /// @return Phase in -pi..pi range
+    double getPhaseRadians (size_t bin) const
+    {
+        return std::arg (m_response[bin]);
+    }
+
+    /// @brief Group delay between this bin and the next one
+    double getGroupDelaySeconds (size_t bin) const
+    {
+        if (bin + 1 >= m_response.size())
+            return 0.0;
+
+        const double phaseDifferenceRadians = std::arg (m_response[bin + 1] * std::conj (m_response[bin]));
+        return - phaseDifferenceRadians / (hart::twoPi * getBinFrequencyHz (1));
+    }
+
+    /// @brief Linear impulse response, as measured by the last @ref measure() call
+    const std::vector<double>& getImpulseResponse() const { return m_impulseResponse; }
+
+    /// @brief Finds when the sweep plays the frequency
+    /// @details Handy for pointing the failure reports at the relevant part of the audio
+    size_t getFrameOfFrequency (double frequencyHz) const
+    {
+        const double startFrequencyHz = m_sweep.getStartFrequencyHz();
+        const double endFrequencyHz = m_sweep.getEndFrequencyHz();
+
+        if (floatsEqual (startFrequencyHz, endFrequencyHz) || frequencyHz <= 0)
+            return 0;
+
+        const double portion = m_sweep.getType() == SineSweep<SampleType>::SweepType::log
+            ? std::log (frequencyHz / startFrequencyHz) / std::log (endFrequencyHz / startFrequencyHz)
+            : (frequencyHz - startFrequencyHz) / (endFrequencyHz - startFrequencyHz);
+
+        return roundToSizeT (hart::clamp (portion, 0.0, 1.0) * (getSweepFrames() - 1));
+    }
+
+    const SineSweep<SampleType>& getSweep() const { return m_sweep; }
+
+private:
+    SineSweep<SampleType> m_sweep;
+    double m_sampleRateHz = 0.0;
+    RealFFT m_fft {2};
+    double m_regularization = 0.0;
+    double m_peakMagnitude = 0.0;
+    std::vector<std::complex<double>> m_sweepSpectrum;
+    std::vector<std::complex<double>> m_response;
+    std::vector<double> m_frames;
+    std::vector<double> m_impulseResponse;
+
+    size_t getSweepFrames() const
+    {
+        return roundToSizeT (m_sweep.getDurationSeconds() * m_sampleRateHz);
+    }
+
+    void prepareSweepSpectrum (size_t fftSize, size_t sweepFrames)
+    {
+        m_fft = RealFFT (fftSize);
+
+        // Sweep gets rendered the same way as the input of the effect, DSP chain and all
+        SineSweep<SampleType> sweep (m_sweep);
+        AudioBuffer<SampleType> sweepAudio (1, sweepFrames);
+        sweep.prepareWithDSPChain (m_sampleRateHz, 1, sweepFrames);
+        sweep.resetWithDSPChain();
+        sweep.renderNextBlockWithDSPChain (sweepAudio);
+
+        m_frames.assign (fftSize, 0.0);
+        std::copy (sweepAudio[0], sweepAudio[0] + sweepFrames, m_frames.begin());
+        m_sweepSpectrum.resize (m_fft.getNumBins());
+        m_fft.forward (m_frames.data(), m_sweepSpectrum.data());
+
+        // Keeps the division from blowing up outside of the sweep range, while being negligible within it
+        double maxPower = 0.0;
+
+        for (const std::complex<double>& bin : m_sweepSpectrum)
+            maxPower = std::max (maxPower, std::norm (bin));
+
+        m_regularization = 1e-8 * maxPower;
+    }
+};
+
+}  // namespace hart
@@ -0,0 +1,515 @@
+#pragma once
+
+#include <algorithm>  // min()
+#include <cmath>
+#include <exception>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "hart_audio_buffer.hpp"
+#include "hart_block_pipeline.hpp"
+#include "hart_cancellation.hpp"
+#include "dsp/hart_dsp.hpp"
+#include "hart_exceptions.hpp"
+#include "hart_expectation_failure_messages.hpp"
+#include "hart_failure_window.hpp"
+#include "matchers/hart_matcher.hpp"
+#include "hart_plot.hpp"
+#include "hart_precision.hpp"
+#include "hart_wavformat.hpp"
+#include "hart_wavwriter.hpp"
+#include "signals/hart_signal.hpp"
+#include "hart_utils.hpp"
+
+namespace hart {
+
+/// @brief Determines when to save a file
+/// @ingroup TestRunner
+enum class Save
+{
+    always,  ///< File will be saved always, after the test is performed
+    whenFails,  ///< File will be saved only when the test has failed
+    never  ///< File will not be saved
+};
+
+template <typename SampleType>
+class AudioTestBuilder;
+
+/// @brief A fully prepared test that can be run repeatedly
+/// @details Made by @ref AudioTestBuilder::compile(). By the time you get it, the DSP, the input signal and
+/// all the matchers are already prepared, and all the audio buffers are allocated. Each call to @ref run()
+/// only resets them to their initial state and renders the test again, without allocating any memory,
+/// which makes it suitable for benchmark repetitions, soak loops and such.
+/// @ingroup TestRunner
+template <typename SampleType>
+class TestPlan
+{
+public:
+    /// @brief Runs the test
+    /// @details Can be called any number of times, and each run is guaranteed to be identical to the first one,
+    /// provided that the DSP and signals properly implement their reset() callbacks.
+    /// Failed "assert" checks throw, failed "expect" checks get reported, just like with @ref AudioTestBuilder::process()
+    /// @return true if all the checks have passed, false otherwise
+    bool run()
+    {
+        if (! m_isPrepared)
+            return false;
+
+        reset();
+        const bool allBlocksPassed = m_pipeline != nullptr ? runBlocksPipelined() : runBlocks();
+        bool atLeastOneCheckFailed = ! allBlocksPassed;
+
+        const bool allChecksPassed = processChecks (m_fullSignalChecks, m_fullOutputBuffer, 0);
+        atLeastOneCheckFailed |= ! allChecksPassed;
+
+        if (m_failureWindow != nullptr)
+            m_failureWindow->cutFrom (m_fullInputBuffer, m_fullOutputBuffer);
+
+        // With a failure window, only the files saved on failure get cut down to it
+        const bool savesFailureWindow = m_failureWindow != nullptr && m_failureWindow->hasCapture();
+
+        if (m_saveOutputMode == Save::always || (m_saveOutputMode == Save::whenFails && atLeastOneCheckFailed && ! savesFailureWindow))
+            WavWriter<SampleType>::writeBuffer (m_fullOutputBuffer, m_saveOutputPath, m_sampleRateHz, m_saveOutputWavFormat);
+        else if (m_saveOutputMode == Save::whenFails && atLeastOneCheckFailed)
+            saveFailureWindowAudio();
+
+        if (m_savePlotMode == Save::always || (m_savePlotMode == Save::whenFails && atLeastOneCheckFailed && ! savesFailureWindow))
+            plotData (m_fullInputBuffer, m_fullOutputBuffer, m_sampleRateHz, m_savePlotPath);
+        else if (m_savePlotMode == Save::whenFails && atLeastOneCheckFailed)
+            plotFailureWindow();
+
+        return ! atLeastOneCheckFailed;
+    }
+
+    /// @brief Gives access to the tested DSP, e.g. to query some readings with @ref DSP::getValue() between the runs
+    DSP<SampleType>& getProcessor()
+    {
+        return *m_processor;
+    }
+
+    /// @brief Takes the tested DSP out of the plan
+    /// @details The plan can not be run anymore after that
+    std::unique_ptr<DSP<SampleType>> releaseProcessor()
+    {
+        m_isPrepared = false;
+        return std::move (m_processor);
+    }
+
+private:
+    friend class AudioTestBuilder<SampleType>;
+
+    struct ParamValue
+    {
+        int id;
+        double value;
+    };
+
+    enum class SignalAssertionLevel
+    {
+        expect,
+        assert,
+    };
+
+    struct Check
+    {
+        std::unique_ptr<Matcher<SampleType>> matcher;
+        SignalAssertionLevel signalAssertionLevel;
+        bool shouldSkip;
+        bool shouldPass;
+    };
+
+    std::unique_ptr<DSP<SampleType>> m_processor;
+    std::unique_ptr<Signal<SampleType>> m_inputSignal;
+    double m_sampleRateHz = (double) 44100;
+    size_t m_blockSizeFrames = 1024;
+    size_t m_numInputChannels = 1;
+    size_t m_numOutputChannels = 1;
+    std::vector<ParamValue> m_paramValues;
+    size_t m_durationFrames = 0;
+    std::string m_testLabel = {};
+    bool m_isPrepared = false;
+
+    std::vector<Check> m_perBlockChecks;
+    std::vector<Check> m_fullSignalChecks;
+
+    std::string m_saveOutputPath;
+    Save m_saveOutputMode = Save::never;
+    WavFormat m_saveOutputWavFormat = WavFormat::pcm24;
+
+    std::string m_savePlotPath;
+    Save m_savePlotMode = Save::never;
+
+    AudioBuffer<SampleType> m_inputBlock;
+    AudioBuffer<SampleType> m_outputBlock;
+    AudioBuffer<SampleType> m_fullInputBuffer;
+    AudioBuffer<SampleType> m_fullOutputBuffer;
+    bool m_keepsFullInput = false;
+    bool m_keepsFullOutput = false;
+
+    std::unique_ptr<BlockPipeline<SampleType>> m_pipeline;
+    std::unique_ptr<FailureWindow<SampleType>> m_failureWindow;
+    Matcher<SampleType>* m_referenceMatcher = nullptr;
+    bool m_hasReferenceMatcherRun = false;
+
+    /// @brief Makes a plan that can't be run
+    /// @details Used by the builder to hand the DSP back when it can't make a proper plan
+    TestPlan (std::unique_ptr<DSP<SampleType>> processor):
+        m_processor (std::move (processor))
+    {
+    }
+
+    TestPlan (std::unique_ptr<DSP<SampleType>> processor, size_t numInputChannels, size_t numOutputChannels, size_t blockSizeFrames, size_t durationFrames, bool keepsFullInput, bool keepsFullOutput):
+        m_processor (std::move (processor)),
+        m_blockSizeFrames (blockSizeFrames),
+        m_numInputChannels (numInputChannels),
+        m_numOutputChannels (numOutputChannels),
+        m_durationFrames (durationFrames),
+        m_inputBlock (numInputChannels, blockSizeFrames),
+        m_outputBlock (numOutputChannels, blockSizeFrames),
+        m_fullInputBuffer (numInputChannels, keepsFullInput ? durationFrames : 0),
+        m_fullOutputBuffer (numOutputChannels, keepsFullOutput ? durationFrames : 0),
+        m_keepsFullInput (keepsFullInput),
+        m_keepsFullOutput (keepsFullOutput)
+    {
+    }
+
+    void prepare()
+    {
+        for (auto& check : m_perBlockChecks)
+            check.matcher->prepare (m_sampleRateHz, m_numOutputChannels, m_blockSizeFrames);
+
+        for (auto& check : m_fullSignalChecks)
+            check.matcher->prepare (m_sampleRateHz, m_numOutputChannels, m_blockSizeFrames);
+
+        // TODO: Ckeck supportsChannelLayout() here
+        m_processor->resetWithEnvelopes();
+        m_processor->prepareWithEnvelopes (m_sampleRateHz, m_numInputChannels, m_numOutputChannels, m_blockSizeFrames);
+
+        m_inputSignal->resetWithDSPChain();
+        m_inputSignal->prepareWithDSPChain (m_sampleRateHz, m_numInputChannels, m_blockSizeFrames);
+
+        if (m_failureWindow != nullptr)
+        {
+            for (auto& check : m_perBlockChecks)
+            {
+                if (check.matcher->getReferenceAudio() != nullptr)
+                {
+                    m_referenceMatcher = check.matcher.get();
+                    break;
+                }
+            }
+        }
+
+        m_isPrepared = true;
+    }
+
+    void reset()
+    {
+        for (auto& check : m_perBlockChecks)
+        {
+            check.matcher->reset();
+            check.shouldSkip = false;
+        }
+
+        for (auto& check : m_fullSignalChecks)
+        {
+            check.matcher->reset();
+            check.shouldSkip = false;
+        }
+
+        m_processor->resetWithEnvelopes();
+
+        for (const ParamValue& paramValue : m_paramValues)
+        {
+            // TODO: Add true/false return to indicate if setting the parameter was successful
+            m_processor->setValue (paramValue.id, paramValue.value);
+        }
+
+        m_inputSignal->resetWithDSPChain();
+
+        if (m_failureWindow != nullptr)
+            m_failureWindow->reset();
+    }
+
+    /// @brief Renders, processes and checks the blocks one by one, on the calling thread
+    bool runBlocks()
+    {
+        bool allBlocksPassed = true;
+        const CancellationToken* cancellationToken = CancellationToken::getCurrent();
+        size_t blockIndex = 0;
+
+        for (size_t offsetFrames = 0; offsetFrames < m_durationFrames; offsetFrames += m_blockSizeFrames)
+        {
+            // TODO: Do not continue if there are no checks, or all checks should skip and there's no input and output file to write
+
+            if (cancellationToken != nullptr && cancellationToken->isCancelled())
+                throwCancelled (*cancellationToken, blockIndex, offsetFrames);
+
+            const size_t blockSizeFrames = std::min (m_blockSizeFrames, m_durationFrames - offsetFrames);
+            m_inputBlock.resize (blockSizeFrames);
+            m_outputBlock.resize (blockSizeFrames);
+            m_inputSignal->renderNextBlockWithDSPChain (m_inputBlock);
+            m_processor->processWithEnvelopes (m_inputBlock, m_outputBlock);
+            allBlocksPassed &= checkBlock (m_inputBlock, m_outputBlock, offsetFrames);
+            ++blockIndex;
+        }
+
+        return allBlocksPassed;
+    }
+
+    /// @brief Renders, processes and checks the blocks in parallel
+    /// @details The input gets rendered on one background thread, and the checks are done on another one,
+    /// while the DSP stays on the calling thread. Blocks are passed between the threads through a @ref BlockPipeline.
+    /// Everything happens in the same order as with @ref runBlocks(), so the failures are reported the same way too,
+    /// the only difference being that the DSP may get a few blocks ahead of a failed assertion before it stops.
+    bool runBlocksPipelined()
+    {
+        using Stage = typename BlockPipeline<SampleType>::Stage;
+        using Slot = typename BlockPipeline<SampleType>::Slot;
+
+        BlockPipeline<SampleType>& pipeline = *m_pipeline;
+        pipeline.reset();
+        const size_t numBlocks = (m_durationFrames + m_blockSizeFrames - 1) / m_blockSizeFrames;
+        std::exception_ptr renderException;
+        std::exception_ptr processException;
+        std::exception_ptr checkException;
+        std::vector<std::string> checkFailureMessages;
+        bool allBlocksPassed = true;
+
+        std::thread renderThread ([&]
+        {
+            try
+            {
+                for (size_t blockIndex = 0; blockIndex < numBlocks; ++blockIndex)
+                {
+                    Slot* slot = pipeline.waitForSlot (Stage::render);
+
+                    if (slot == nullptr)
+                        break;
+
+                    slot->offsetFrames = blockIndex * m_blockSizeFrames;
+                    const size_t blockSizeFrames = std::min (m_blockSizeFrames, m_durationFrames - slot->offsetFrames);
+                    slot->input.resize (blockSizeFrames);
+                    slot->output.resize (blockSizeFrames);
+                    m_inputSignal->renderNextBlockWithDSPChain (slot->input);
+                    pipeline.release (Stage::render);
+                }
+            }
+            catch (...)
+            {
+                renderException = std::current_exception();
+            }
+
+            pipeline.close (Stage::render);
+        });
+
+        std::thread checkThread ([&]
+        {
+            try
+            {
+                for (size_t blockIndex = 0; blockIndex < numBlocks; ++blockIndex)
+                {
+                    Slot* slot = pipeline.waitForSlot (Stage::check);
+
+                    if (slot == nullptr)
+                        break;
+
+                    allBlocksPassed &= checkBlock (slot->input, slot->output, slot->offsetFrames);
+                    pipeline.release (Stage::check);
+                }
+            }
+            catch (...)
+            {
+                checkException = std::current_exception();
+            }
+
+            pipeline.close (Stage::check);
+            checkFailureMessages = std::move (ExpectationFailureMessages::get());
+        });
+
+        const CancellationToken* cancellationToken = CancellationToken::getCurrent();
+
+        try
+        {
+            for (size_t blockIndex = 0; blockIndex < numBlocks; ++blockIndex)
+            {
+                if (cancellationToken != nullptr && cancellationToken->isCancelled())
+                    throwCancelled (*cancellationToken, blockIndex, blockIndex * m_blockSizeFrames);
+
+                Slot* slot = pipeline.waitForSlot (Stage::process);
+
+                if (slot == nullptr)
+                    break;
+
+                m_processor->processWithEnvelopes (slot->input, slot->output);
+                pipeline.release (Stage::process);
+            }
+        }
+        catch (...)
+        {
+            processException = std::current_exception();
+        }
+
+        pipeline.close (Stage::process);
+        renderThread.join();
+        checkThread.join();
+
+        auto& messages = ExpectationFailureMessages::get();
+        messages.insert (messages.end(), checkFailureMessages.begin(), checkFailureMessages.end());
+
+        // The later the stage, the earlier the block it has failed at, and the earliest failure is the one to report
+        if (checkException != nullptr)
+            std::rethrow_exception (checkException);
+
+        if (processException != nullptr)
+            std::rethrow_exception (processException);
+
+        if (renderException != nullptr)
+            std::rethrow_exception (renderException);
+
+        return allBlocksPassed;
+    }
+
+    /// @brief Checks a processed block, and keeps whatever is needed from it for the full-signal checks and saved files
+    bool checkBlock (const AudioBuffer<SampleType>& inputBlock, const AudioBuffer<SampleType>& outputBlock, size_t offsetFrames)
+    {
+        m_hasReferenceMatcherRun = false;
+        const bool allChecksPassed = processChecks (m_perBlockChecks, outputBlock, offsetFrames);
+
+        if (m_failureWindow != nullptr)
+            pushToFailureWindow (inputBlock, outputBlock);
+
+        if (m_keepsFullInput)
+            m_fullInputBuffer.copyFrom (inputBlock, offsetFrames);
+
+        if (m_keepsFullOutput)
+            m_fullOutputBuffer.copyFrom (outputBlock, offsetFrames);
+
+        return allChecksPassed;
+    }
+
+    bool processChecks (std::vector<Check>& checksGroup, const AudioBuffer<SampleType>& outputBlock, size_t offsetFrames)
+    {
+        for (auto& check : checksGroup)
+        {
+            if (check.shouldSkip)
+                continue;
+
+            auto& assertionLevel = check.signalAssertionLevel;
+            auto& matcher = check.matcher;
+
+            const bool matchPassed = matcher->match (outputBlock);
+            m_hasReferenceMatcherRun |= matcher.get() == m_referenceMatcher;
+
+            if (matchPassed != check.shouldPass)
+            {
+                check.shouldSkip = true;
+
+                if (m_failureWindow != nullptr)
+                    m_failureWindow->markFailure (offsetFrames + (check.shouldPass ? matcher->getFailureDetails().frame : 0));
+                // TODO: Add optional label for each test
+
+                if (assertionLevel == SignalAssertionLevel::assert)
+                {
+                    std::stringstream stream;
+                    stream << (check.shouldPass ? "assertTrue() failed" : "assertFalse() failed");
+
+                    if (! m_testLabel.empty())
+                        stream << " at \"" << m_testLabel << "\"";
+
+                    stream << std::endl << "Condition: " << *matcher;
+
+                    if (check.shouldPass)
+                        appendFailureDetails (stream, matcher->getFailureDetails(), outputBlock, offsetFrames);
+
+                    throw hart::TestAssertException (std::string (stream.str()));
+                }
+                else
+                {
+                    std::stringstream stream;
+                    stream << (check.shouldPass ? "expectTrue() failed" : "expectFalse() failed");
+
+                    if (!m_testLabel.empty())
+                        stream << " at \"" << m_testLabel << "\"";
+
+                    stream << std::endl << "Condition: " << * matcher;
+
+                    if (check.shouldPass)
+                        appendFailureDetails (stream, matcher->getFailureDetails(), outputBlock, offsetFrames);
+
+                    hart::ExpectationFailureMessages::get().emplace_back (stream.str());
+                }
+
+                // TODO: FIXME: Do not throw indife of per-block loop if requested to write input or output to a wav file, throw after the loop instead
+                // TODO: Stop processing if expect has failed and outputting to a file wasn't requested
+                // TODO: Skip all checks if check failed, but asked to output a wav file
+                return false;
+            }
+        }
+
+        return true;
+    }
+
+    void pushToFailureWindow (const AudioBuffer<SampleType>& inputBlock, const AudioBuffer<SampleType>& outputBlock)
+    {
+        const AudioBuffer<SampleType>* referenceBlock = nullptr;
+
+        if (m_referenceMatcher != nullptr)
+        {
+            // The reference matcher might have been skipped for this block, but the reference audio is still needed
+            if (! m_hasReferenceMatcherRun && ! m_failureWindow->isComplete())
+                m_referenceMatcher->match (outputBlock);
+
+            referenceBlock = m_referenceMatcher->getReferenceAudio();
+        }
+
+        m_failureWindow->pushBlock (inputBlock, outputBlock, referenceBlock);
+    }
+
+    void saveFailureWindowAudio()
+    {
+        WavWriter<SampleType>::writeBuffer (m_failureWindow->getOutput(), m_saveOutputPath, m_sampleRateHz, m_saveOutputWavFormat);
+        WavWriter<SampleType>::writeBuffer (m_failureWindow->getInput(), appendToFileName (m_saveOutputPath, "_input"), m_sampleRateHz, m_saveOutputWavFormat);
+
+        if (m_failureWindow->hasReference())
+            WavWriter<SampleType>::writeBuffer (m_failureWindow->getReference(), appendToFileName (m_saveOutputPath, "_reference"), m_sampleRateHz, m_saveOutputWavFormat);
+    }
+
+    void plotFailureWindow()
+    {
+        const double startTimeSeconds = static_cast<double> (m_failureWindow->getStartFrame()) / m_sampleRateHz;
+        plotData (m_failureWindow->getInput(), m_failureWindow->getOutput(), m_sampleRateHz, m_savePlotPath, startTimeSeconds);
+    }
+
+    void throwCancelled (const CancellationToken& cancellationToken, size_t blockIndex, size_t offsetFrames)
+    {
+        std::stringstream stream;
+        stream << cancellationToken.describeReason() << " at block " << blockIndex;
+
+        if (! m_testLabel.empty())
+            stream << " at \"" << m_testLabel << "\"";
+
+        const double timestampSeconds = static_cast<double> (offsetFrames) / m_sampleRateHz;
+        stream << std::endl << secPrecision << "Timestamp: " << timestampSeconds << " seconds";
+        throw hart::TestAssertException (stream.str());
+    }
+
+    void appendFailureDetails (std::stringstream& stream, const MatcherFailureDetails& details, const AudioBuffer<SampleType>& observedAudioBlock, size_t offsetFrames)
+    {
+        const double timestampSeconds = static_cast<double> (offsetFrames + details.frame) / m_sampleRateHz;
+        const SampleType sampleValue = observedAudioBlock[details.channel][details.frame];
+
+        stream << std::endl
+            << "Channel: " << details.channel << std::endl
+            << "Frame: " << details.frame << std::endl
+            << secPrecision << "Timestamp: " << timestampSeconds << " seconds" << std::endl
+            << linPrecision << "Sample value: " << sampleValue
+            << dbPrecision << " (" << ratioToDecibels (std::abs (sampleValue)) << " dB)" << std::endl
+            << details.description;
+    }
+};
+
+}  // namespace hart
@@ -1,16 +1,33 @@
 #pragma once
 
-#include <algorithm>  // shuffle()
+#include <algorithm>  // max(), min(), remove(), shuffle()
+#include <atomic>
+#include <chrono>
+#include <cmath>  // sqrt()
+#include <condition_variable>
+#include <functional>
+#include <iomanip>
 #include <iostream>
+#include <mutex>
 #include <random>
+#include <sstream>
 #include <string>
+#include <unordered_map>
 #include <unordered_set>
+#include <utility>  // pair
 #include <vector>
 
+#include "hart_accessed_files.hpp"
 #include "hart_ascii_art.hpp"
+#include "hart_cancellation.hpp"
 #include "hart_cliconfig.hpp"
+#include "hart_duration_history.hpp"
 #include "hart_exceptions.hpp"
 #include "hart_expectation_failure_messages.hpp"
+#include "hart_fixture.hpp"
+#include "hart_result_cache.hpp"
+#include "hart_thread_pool.hpp"
+#include "hart_watchdog.hpp"
 
 namespace hart
 {
@@ -58,7 +75,18 @@ public:
                 ? tests
                 : generators;
 
-        tasks.emplace_back (TaskInfo {name, tags, func});
+        double timeoutSeconds = noTimeoutOverride;
+        const std::vector<std::string> timeoutTagValues = getTagValues (tags, "timeout");
+
+        if (! timeoutTagValues.empty())
+        {
+            timeoutSeconds = parseTimeout (timeoutTagValues.back());
+
+            if (timeoutSeconds < 0)
+                HART_THROW_OR_RETURN_VOID (hart::ValueError, std::string ("Timeout should be a non-negative value in seconds, test case: ") + name);
+        }
+
+        tasks.emplace_back (TaskInfo {name, tags, testCategory, func, timeoutSeconds, getTagValues (tags, "produces"), getTagValues (tags, "consumes")});
     }
 
     /// @brief Runs all tests or generators
@@ -66,14 +94,19 @@ public:
     {
         // TODO: Optional shuffle before running
         // TODO: Make data root dir if set, but doesn't exist
-        // TODO: Add support for runnings tasks in a thread pool
 
         std::cout << hartAsciiArt << std::endl;
 
-        std::vector<TaskInfo>& tasks =
-            CLIConfig::getInstance().shouldRunGenerators()
-                ? generators
-                : tests;
+        CLIConfig& config = CLIConfig::getInstance();
+        const bool runsGenerators = config.shouldRunGenerators() || config.shouldRunAll();
+        const bool runsTests = ! config.shouldRunGenerators() || config.shouldRunAll();
+        std::vector<TaskInfo> tasks;
+
+        if (runsGenerators)
+            tasks.insert (tasks.end(), generators.begin(), generators.end());
+
+        if (runsTests)
+            tasks.insert (tasks.end(), tests.begin(), tests.end());
 
         if (tasks.size() == 0)
         {
@@ -81,18 +114,43 @@ public:
             return 0;
         }
 
-        if (CLIConfig::getInstance().shouldShuffleTasks())
+        loadDurationHistory();
+
+        if (config.shouldShuffleTasks())
             shuffleTasks (tasks);
+        else if (config.getNumJobs() > 1)
+            sortLongestFirst (tasks);
+
+        // Generators are there to produce files, so they always run
+        const bool usesResultCache = runsTests && ! config.getCacheDir().empty();
+
+        if (usesResultCache)
+            loadResultCache();
+
+        const bool tasksRan = runTasks (tasks);
+        FixtureRegistry::getInstance().tearDownAll();
 
-        for (const TaskInfo& task : tasks)
-            runTask (task);
+        if (! tasksRan)
+            return 1;
+
+        if (resultCache.isEnabled() && ! resultCache.save())
+            std::cout << "Warning: Could not write the result cache to " << CLIConfig::getInstance().getCacheDir() << std::endl;
+
+        if (! durationHistory.save())
+            std::cout << "Warning: Could not write the test duration history to " << config.getDataRootPath() << std::endl;
 
         std::cout << std::endl;
         std::cout << "[ PASSED ] " << tasksPassed << '/' << tasks.size() << std::endl;
 
+        if (tasksCached > 0)
+            std::cout << "[ CACHED ] " << tasksCached << '/' << tasks.size() << std::endl;
+
         if (tasksFailed > 0)
             std::cout << "[ FAILED ] " << tasksFailed << '/' << tasks.size() << std::endl;
 
+        if (tasksSkipped > 0)
+            std::cout << "[ SKIPPED ] " << tasksSkipped << '/' << tasks.size() << " (--fail-fast)" << std::endl;
+
         const char* resultAsciiArt = tasksFailed > 0 ? failAsciiArt : passAsciiArt;
         std::cout << std::endl << resultAsciiArt << std::endl;
         return (int) (tasksFailed != 0);
@@ -103,68 +161,494 @@ private:
     {
         std::string name;
         std::string tags;
+        TaskCategory category;
         void (*func)();
+        double timeoutSeconds;
+        std::vector<std::string> producedFiles;
+        std::vector<std::string> consumedFiles;
     };
 
+    struct TaskRunResult
+    {
+        bool passed = false;
+        double durationSeconds = 0.0;
+        std::string assertionFailMessage;
+        std::vector<std::string> expectationFailureMessages;
+        std::vector<std::string> accessedFiles;
+    };
+
+    static constexpr double noTimeoutOverride = -1.0;
+    static constexpr double timeoutGracePeriodSeconds = 10.0;
+    static constexpr const char* durationHistoryFileName = "hart_test_durations.txt";
+
     TestRegistry() = default;  // Private ctor for singleton
     std::vector<TaskInfo> tests;
     std::vector<TaskInfo> generators;
     std::unordered_set<std::string> registeredTestNames;
     std::unordered_set<std::string> registeredGeneratorNames;
 
-    size_t tasksPassed = 0;
-    size_t tasksFailed = 0;
+    std::atomic<size_t> tasksPassed { 0 };
+    std::atomic<size_t> tasksFailed { 0 };
+    std::atomic<size_t> tasksCached { 0 };
+    std::atomic<size_t> tasksSkipped { 0 };
+    std::mutex resultCacheMutex;
+    DurationHistory durationHistory;
+    std::mutex durationHistoryMutex;
+    std::mutex outputMutex;
+    std::atomic<bool> failFastTriggered { false };
+    std::mutex activeTokensMutex;
+    std::vector<CancellationToken*> activeTokens;
+    ResultCache resultCache;
+    Watchdog watchdog { timeoutGracePeriodSeconds };
+
+    /// @brief Runs all the tasks, respecting the dependencies between them
+    /// @details A task that consumes a file gets scheduled only after all the tasks that produce this file
+    /// have finished. Independent tasks run in parallel, according to the `--jobs` CLI argument.
+    /// @return false if the tasks can't be scheduled
+    bool runTasks (const std::vector<TaskInfo>& tasks)
+    {
+        const size_t numTasks = tasks.size();
+        std::unordered_map<std::string, std::vector<size_t>> producersByFile;
+
+        for (size_t taskIndex = 0; taskIndex < numTasks; ++taskIndex)
+            for (const std::string& filePath : tasks[taskIndex].producedFiles)
+                producersByFile[filePath].push_back (taskIndex);
+
+        std::vector<std::vector<size_t>> dependents (numTasks);
+        std::vector<size_t> numPendingDependencies (numTasks, 0);
+        std::vector<std::string> failedDependencyNames (numTasks);
+
+        for (size_t taskIndex = 0; taskIndex < numTasks; ++taskIndex)
+        {
+            for (const std::string& filePath : tasks[taskIndex].consumedFiles)
+            {
+                const auto it = producersByFile.find (filePath);
+
+                if (it == producersByFile.end())
+                    continue;
+
+                for (size_t producerIndex : it->second)
+                {
+                    if (producerIndex == taskIndex)
+                        continue;
+
+                    dependents[producerIndex].push_back (taskIndex);
+                    ++numPendingDependencies[taskIndex];
+                }
+            }
+        }
+
+        if (hasCircularDependencies (dependents, numPendingDependencies))
+            HART_THROW_OR_RETURN (hart::ValueError, "Circular dependency between the tasks found - check their \"[produces=...]\" and \"[consumes=...]\" tags", false);
+
+        const size_t numJobs = CLIConfig::getInstance().getNumJobs();
+        ThreadPool threadPool (numJobs - 1);  // The calling thread runs tasks as well
+        std::mutex schedulerMutex;
+        std::condition_variable schedulerCondition;
+        size_t numTasksFinished = 0;
+        std::function<void (size_t)> schedule;
+
+        schedule = [&] (size_t taskIndex)
+        {
+            threadPool.enqueue ([&, taskIndex]
+            {
+                const bool taskPassed = runTask (tasks[taskIndex], failedDependencyNames[taskIndex]);
+                std::lock_guard<std::mutex> lock (schedulerMutex);
+
+                for (size_t dependentIndex : dependents[taskIndex])
+                {
+                    if (! taskPassed)
+                        failedDependencyNames[dependentIndex] = tasks[taskIndex].name;
+
+                    if (--numPendingDependencies[dependentIndex] == 0)
+                        schedule (dependentIndex);
+                }
+
+                ++numTasksFinished;
+                schedulerCondition.notify_all();
+            });
+        };
+
+        std::unique_lock<std::mutex> lock (schedulerMutex);
+
+        for (size_t taskIndex = 0; taskIndex < numTasks; ++taskIndex)
+        {
+            if (numPendingDependencies[taskIndex] == 0)
+                schedule (taskIndex);
+        }
+
+        while (numTasksFinished < numTasks)
+        {
+            lock.unlock();
+            const bool ranTask = threadPool.tryRunPendingJob();
+            lock.lock();
 
-    void runTask (const TaskInfo& task)
+            if (! ranTask)
+                schedulerCondition.wait (lock, [&] { return numTasksFinished == numTasks || threadPool.hasPendingJobs(); });
+        }
+
+        return true;
+    }
+
+    /// @brief Checks the dependency graph for loops with Kahn's algorithm
+    static bool hasCircularDependencies (const std::vector<std::vector<size_t>>& dependents, std::vector<size_t> numPendingDependencies)
     {
-        std::cout << "[  ...   ] Running " << task.name;
-        bool assertionFailed = false;
-        std::string assertionFailMessage;
-        ExpectationFailureMessages::clear();
+        std::vector<size_t> readyTasks;
 
-        try
+        for (size_t taskIndex = 0; taskIndex < numPendingDependencies.size(); ++taskIndex)
         {
-            task.func();
+            if (numPendingDependencies[taskIndex] == 0)
+                readyTasks.push_back (taskIndex);
         }
-        catch (const hart::TestAssertException& e)
+
+        size_t numSortedTasks = 0;
+
+        while (! readyTasks.empty())
         {
-            assertionFailMessage = e.what();
-            assertionFailed = true;
+            const size_t taskIndex = readyTasks.back();
+            readyTasks.pop_back();
+            ++numSortedTasks;
+
+            for (size_t dependentIndex : dependents[taskIndex])
+            {
+                if (--numPendingDependencies[dependentIndex] == 0)
+                    readyTasks.push_back (dependentIndex);
+            }
         }
-        catch (const hart::ConfigurationError& e)
+
+        return numSortedTasks != numPendingDependencies.size();
+    }
+
+    /// @brief Runs the task, possibly several times, and reports the result
+    /// @param task Task to run
+    /// @param failedDependencyName Name of a task this one depends on, if it has failed
+    /// @return true if the task has passed
+    bool runTask (const TaskInfo& task, const std::string& failedDependencyName)
+    {
+        const size_t numRepeats = CLIConfig::getInstance().getNumRepeats();
+        const bool runsInParallel = CLIConfig::getInstance().getNumJobs() > 1;
+        constexpr char separator[] = "-------------------------------------------";
+
+        if (failFastTriggered)
         {
-            assertionFailMessage = e.what();
-            assertionFailed = true;
+            ++tasksSkipped;
+            return false;
         }
 
-        // TODO: Output test durations
+        if (! failedDependencyName.empty())
+        {
+            std::lock_guard<std::mutex> lock (outputMutex);
+            std::cout << "[  </3   ] " << task.name << " - failed" << std::endl
+                << separator << std::endl
+                << "Not run, because \"" << failedDependencyName << "\" that produces its input files has failed" << std::endl
+                << separator << std::endl;
+            ++tasksFailed;
+            return false;
+        }
 
-        std::cout << '\r';
-        const bool expectationsFailed = ExpectationFailureMessages::get().size() > 0;
+        // Repeated runs are there to measure things, so they shouldn't be skipped
+        if (numRepeats == 1 && task.category == TaskCategory::test && CLIConfig::getInstance().shouldUseCachedResults() && isCachedResultUpToDate (task))
+        {
+            std::lock_guard<std::mutex> lock (outputMutex);
+            std::cout << "[   <3   ] " << task.name << " - passed (cached)" << std::endl;
+            ++tasksPassed;
+            ++tasksCached;
+            return true;
+        }
+
+        // Progress is only shown when tasks run one by one, otherwise the lines would get mixed up
+        if (! runsInParallel)
+        {
+            std::lock_guard<std::mutex> lock (outputMutex);
+            std::cout << "[  ...   ] Running " << task.name << std::flush;
+        }
+
+        std::vector<double> durationsSeconds;
+        size_t numRunsPassed = 0;
+        TaskRunResult failedRunResult;
+        TaskRunResult passedRunResult;
+
+        for (size_t repeat = 0; repeat < numRepeats; ++repeat)
+        {
+            TaskRunResult runResult = runTaskOnce (task);
+            durationsSeconds.push_back (runResult.durationSeconds);
+
+            if (runResult.passed)
+            {
+                ++numRunsPassed;
+                passedRunResult = std::move (runResult);
+            }
+            else if (numRunsPassed == repeat)  // Only the first failure gets reported
+            {
+                failedRunResult = std::move (runResult);
+
+                if (CLIConfig::getInstance().shouldFailFast())
+                    break;
+            }
+        }
+
+        const size_t numRuns = durationsSeconds.size();
+        recordDuration (task, durationsSeconds);
+        const std::string runStats = numRepeats > 1
+            ? std::to_string (numRunsPassed) + '/' + std::to_string (numRuns) + " runs (" + describeDurations (durationsSeconds) + ')'
+            : "";
+        const bool taskPassed = numRunsPassed == numRuns;
+        std::stringstream report;
 
-        if (assertionFailed || expectationsFailed)
+        if (! runsInParallel)
+            report << '\r';
+
+        if (! taskPassed)
         {
-            constexpr char separator[] = "-------------------------------------------";
-            std::cout << "[  </3   ] " << task.name << " - failed" << std::endl;
+            report << "[  </3   ] " << task.name << " - failed" << (runStats.empty() ? "" : ", passed ") << runStats << std::endl;
 
-            if (assertionFailed)
+            if (! failedRunResult.assertionFailMessage.empty())
             {
-                std::cout << separator << std::endl << assertionFailMessage << std::endl;
+                report << separator << std::endl << failedRunResult.assertionFailMessage << std::endl;
             }
 
-            for (const std::string& expectationFailureMessage : ExpectationFailureMessages::get())
+            for (const std::string& expectationFailureMessage : failedRunResult.expectationFailureMessages)
             {
-                std::cout << separator << std::endl << expectationFailureMessage << std::endl;
+                report << separator << std::endl << expectationFailureMessage << std::endl;
             }
 
-            std::cout << separator << std::endl;
+            report << separator << std::endl;
             ++tasksFailed;
+
+            if (task.category == TaskCategory::test)
+            {
+                std::lock_guard<std::mutex> lock (resultCacheMutex);
+                resultCache.forget (task.name);
+            }
+
+            if (CLIConfig::getInstance().shouldFailFast())
+                triggerFailFast();
         }
         else
         {
-            std::cout << "[   <3   ] " << task.name << " - passed" << std::endl;
+            report << "[   <3   ] " << task.name << " - passed" << (runStats.empty() ? "" : " ") << runStats << std::endl;
             ++tasksPassed;
+
+            if (task.category == TaskCategory::test)
+            {
+                std::lock_guard<std::mutex> lock (resultCacheMutex);
+                resultCache.storePassed (task.name, passedRunResult.accessedFiles);
+            }
+        }
+
+        std::lock_guard<std::mutex> lock (outputMutex);
+        std::cout << report.str();
+        return taskPassed;
+    }
+
+    bool isCachedResultUpToDate (const TaskInfo& task)
+    {
+        std::lock_guard<std::mutex> lock (resultCacheMutex);
+        return resultCache.isUpToDate (task.name);
+    }
+
+    TaskRunResult runTaskOnce (const TaskInfo& task)
+    {
+        TaskRunResult result;
+        ExpectationFailureMessages::clear();
+        AccessedFiles::clear();
+
+        const double timeoutSeconds = task.timeoutSeconds == noTimeoutOverride
+            ? CLIConfig::getInstance().getTimeoutSeconds()
+            : task.timeoutSeconds;
+        const bool hasTimeout = timeoutSeconds > 0;
+        CancellationToken cancellationToken;
+        CancellationToken::setCurrent (&cancellationToken);
+        addActiveToken (cancellationToken);
+        const size_t watchdogId = hasTimeout ? watchdog.arm (cancellationToken, timeoutSeconds, task.name) : 0;
+        const auto startTime = std::chrono::steady_clock::now();
+
+        try
+        {
+            task.func();
+        }
+        catch (const hart::TestAssertException& e)
+        {
+            result.assertionFailMessage = e.what();
+        }
+        catch (const hart::ConfigurationError& e)
+        {
+            result.assertionFailMessage = e.what();
+        }
+
+        const auto endTime = std::chrono::steady_clock::now();
+        result.durationSeconds = std::chrono::duration<double> (endTime - startTime).count();
+
+        if (hasTimeout)
+            watchdog.disarm (watchdogId);
+
+        removeActiveToken (cancellationToken);
+        CancellationToken::setCurrent (nullptr);
+
+        result.expectationFailureMessages = std::move (ExpectationFailureMessages::get());
+        ExpectationFailureMessages::clear();
+        result.accessedFiles = std::move (AccessedFiles::get());
+        AccessedFiles::clear();
+        result.passed = result.assertionFailMessage.empty() && result.expectationFailureMessages.empty();
+        return result;
+    }
+
+    /// @brief Stops scheduling new tasks, and asks the running ones to stop
+    void triggerFailFast()
+    {
+        failFastTriggered = true;
+        std::lock_guard<std::mutex> lock (activeTokensMutex);
+
+        for (CancellationToken* token : activeTokens)
+            token->cancel (CancellationReason::failFast);
+    }
+
+    void addActiveToken (CancellationToken& token)
+    {
+        std::lock_guard<std::mutex> lock (activeTokensMutex);
+        activeTokens.push_back (&token);
+
+        if (failFastTriggered)
+            token.cancel (CancellationReason::failFast);
+    }
+
+    void removeActiveToken (CancellationToken& token)
+    {
+        std::lock_guard<std::mutex> lock (activeTokensMutex);
+        activeTokens.erase (std::remove (activeTokens.begin(), activeTokens.end(), &token), activeTokens.end());
+    }
+
+    /// @brief Makes a summary like "min 1.0 ms, mean 1.5 ms, max 2.0 ms, stddev 0.5 ms"
+    static std::string describeDurations (const std::vector<double>& durationsSeconds)
+    {
+        double minSeconds = durationsSeconds.front();
+        double maxSeconds = durationsSeconds.front();
+        double sumSeconds = 0.0;
+
+        for (double durationSeconds : durationsSeconds)
+        {
+            minSeconds = std::min (minSeconds, durationSeconds);
+            maxSeconds = std::max (maxSeconds, durationSeconds);
+            sumSeconds += durationSeconds;
+        }
+
+        const double meanSeconds = sumSeconds / static_cast<double> (durationsSeconds.size());
+        double sumOfSquaredDeviations = 0.0;
+
+        for (double durationSeconds : durationsSeconds)
+            sumOfSquaredDeviations += (durationSeconds - meanSeconds) * (durationSeconds - meanSeconds);
+
+        const double stdDevSeconds = std::sqrt (sumOfSquaredDeviations / static_cast<double> (durationsSeconds.size()));
+
+        std::stringstream stream;
+        stream << std::fixed << std::setprecision (3)
+            << "min " << minSeconds * 1000.0 << " ms, "
+            << "mean " << meanSeconds * 1000.0 << " ms, "
+            << "max " << maxSeconds * 1000.0 << " ms, "
+            << "stddev " << stdDevSeconds * 1000.0 << " ms";
+        return stream.str();
+    }
+
+    void loadResultCache()
+    {
+        CLIConfig& config = CLIConfig::getInstance();
+        const std::string executablePath = config.getExecutablePath();
+        const std::string binaryFingerprint = ResultCache::fingerprintFile (executablePath);
+
+        if (binaryFingerprint == "missing")
+        {
+            std::cout << "Warning: Could not read the test binary at \"" << executablePath << "\", result caching is disabled" << std::endl;
+            return;
         }
+
+        // Anything that's not a part of the binary, but may change the outcome of any test
+        std::stringstream configStream;
+        configStream << config.getDataRootPath() << '\n' << config.getRandomSeed();
+        const std::string configFingerprint = ResultCache::fingerprintString (configStream.str());
+
+        const size_t lastSeparatorPos = executablePath.find_last_of ("/\\");
+        const std::string executableName = lastSeparatorPos == std::string::npos ? executablePath : executablePath.substr (lastSeparatorPos + 1);
+        resultCache.load (config.getCacheDir() + '/' + executableName + ".hartcache", binaryFingerprint, configFingerprint);
+    }
+
+    /// @brief Gets values of all "[key=value]" tags with the given key
+    static std::vector<std::string> getTagValues (const std::string& tags, const std::string& key)
+    {
+        std::vector<std::string> values;
+        const std::string prefix = '[' + key + '=';
+        size_t searchPos = 0;
+
+        while (true)
+        {
+            const size_t tagStartPos = tags.find (prefix, searchPos);
+
+            if (tagStartPos == std::string::npos)
+                break;
+
+            const size_t valueStartPos = tagStartPos + prefix.size();
+            const size_t tagEndPos = tags.find (']', valueStartPos);
+
+            if (tagEndPos == std::string::npos)
+                break;
+
+            values.emplace_back (tags.substr (valueStartPos, tagEndPos - valueStartPos));
+            searchPos = tagEndPos + 1;
+        }
+
+        return values;
+    }
+
+    /// @return Timeout in seconds, or a negative value if it can't be parsed
+    static double parseTimeout (const std::string& text)
+    {
+        std::stringstream stream (text);
+        double timeoutSeconds = -1.0;
+        stream >> timeoutSeconds;
+
+        if (stream.fail() || ! stream.eof())
+            return -1.0;
+
+        return timeoutSeconds;
+    }
+
+    void loadDurationHistory()
+    {
+        durationHistory.load (CLIConfig::getInstance().getDataRootPath() + '/' + durationHistoryFileName);
+    }
+
+    void recordDuration (const TaskInfo& task, const std::vector<double>& durationsSeconds)
+    {
+        double sumSeconds = 0.0;
+
+        for (double durationSeconds : durationsSeconds)
+            sumSeconds += durationSeconds;
+
+        std::lock_guard<std::mutex> lock (durationHistoryMutex);
+        durationHistory.record (getDurationHistoryKey (task), sumSeconds / static_cast<double> (durationsSeconds.size()));
+    }
+
+    static std::string getDurationHistoryKey (const TaskInfo& task)
+    {
+        return (task.category == TaskCategory::test ? "test " : "generator ") + task.name;
+    }
+
+    /// @brief Puts the tasks that took the longest during the previous runs first
+    /// @details Tasks that are not in the history yet go after them, in registration order
+    void sortLongestFirst (std::vector<TaskInfo>& tasks)
+    {
+        std::vector<std::pair<double, TaskInfo>> tasksWithDurations;
+
+        for (TaskInfo& task : tasks)
+            tasksWithDurations.emplace_back (durationHistory.getDurationSeconds (getDurationHistoryKey (task)), std::move (task));
+
+        std::stable_sort (tasksWithDurations.begin(), tasksWithDurations.end(),
+            [] (const std::pair<double, TaskInfo>& a, const std::pair<double, TaskInfo>& b)
+            {
+                return a.first > b.first;
+            });
+
+        for (size_t taskIndex = 0; taskIndex < tasks.size(); ++taskIndex)
+            tasks[taskIndex] = std::move (tasksWithDurations[taskIndex].second);
     }
 
     static void shuffleTasks (std::vector<TaskInfo>& tasks)
@@ -0,0 +1,128 @@
+#pragma once
+
+#include <algorithm>  // max()
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <utility>  // move()
+#include <vector>
+
+namespace hart
+{
+
+/// @brief A basic pool of worker threads
+/// @details Jobs are run in the order they were enqueued. The thread that owns the pool can help running the
+/// jobs with @ref tryRunPendingJob() while it waits for something, so a pool with zero worker threads is
+/// perfectly usable, it just runs everything on the owner's thread.
+/// @private
+class ThreadPool
+{
+public:
+    /// @param numThreads Number of background worker threads, can be zero
+    ThreadPool (size_t numThreads)
+    {
+        for (size_t i = 0; i < numThreads; ++i)
+            m_threads.emplace_back (&ThreadPool::work, this);
+    }
+
+    /// @brief Waits for the pending jobs to finish, then stops the threads
+    ~ThreadPool()
+    {
+        {
+            std::lock_guard<std::mutex> lock (m_mutex);
+            m_isStopping = true;
+        }
+
+        m_condition.notify_all();
+
+        for (std::thread& thread : m_threads)
+            thread.join();
+
+        while (tryRunPendingJob())
+            ;
+    }
+
+    /// @brief Adds a job to the queue
+    void enqueue (std::function<void()> job)
+    {
+        {
+            std::lock_guard<std::mutex> lock (m_mutex);
+            m_jobs.push_back (std::move (job));
+        }
+
+        m_condition.notify_one();
+    }
+
+    /// @brief Runs one pending job on the calling thread, if there is one
+    /// @return true if a job was run, false if the queue was empty
+    bool tryRunPendingJob()
+    {
+        std::function<void()> job;
+
+        {
+            std::lock_guard<std::mutex> lock (m_mutex);
+
+            if (m_jobs.empty())
+                return false;
+
+            job = std::move (m_jobs.front());
+            m_jobs.pop_front();
+        }
+
+        job();
+        return true;
+    }
+
+    /// @brief Checks if there are jobs waiting to be picked up
+    bool hasPendingJobs()
+    {
+        std::lock_guard<std::mutex> lock (m_mutex);
+        return ! m_jobs.empty();
+    }
+
+    /// @brief Gets the pool that runs the asynchronous renders
+    /// @details It has one thread less than there are CPU cores, as the threads that wait for their renders help running them
+    /// @see AudioTestBuilder::processAsync()
+    static ThreadPool& getSharedInstance()
+    {
+        static ThreadPool sharedInstance (std::max (1u, std::thread::hardware_concurrency()) - 1);
+        return sharedInstance;
+    }
+
+    size_t getNumThreads() const
+    {
+        return m_threads.size();
+    }
+
+private:
+    std::vector<std::thread> m_threads;
+    std::deque<std::function<void()>> m_jobs;
+    std::mutex m_mutex;
+    std::condition_variable m_condition;
+    bool m_isStopping = false;
+
+    void work()
+    {
+        while (true)
+        {
+            std::function<void()> job;
+
+            {
+                std::unique_lock<std::mutex> lock (m_mutex);
+                m_condition.wait (lock, [this] { return m_isStopping || ! m_jobs.empty(); });
+
+                if (m_jobs.empty())
+                    return;
+
+                job = std::move (m_jobs.front());
+                m_jobs.pop_front();
+            }
+
+            job();
+        }
+    }
+};
+
+}  // namespace hart
@@ -8,6 +8,7 @@
 #include <string>
 #include <unordered_map>
 
+#include "hart_accessed_files.hpp"
 #include "hart_cliconfig.hpp"
 
 namespace hart
@@ -114,13 +115,29 @@ inline static bool isAbsolutePath (const std::string& path)
 }
 
 /// @brief Converts path to absolute, if it's relative
-/// @deials Relative paths are resolved based on a provided `--data-root-path` CLI argument 
+/// @deials Relative paths are resolved based on a provided `--data-root-path` CLI argument. 
+/// Resulting path is recorded as accessed by the current test, see `--cache-dir` CLI argument.
 inline static std::string toAbsolutePath (const std::string& path)
 {
-    if (isAbsolutePath(path))
-        return path;
+    const std::string absolutePath = isAbsolutePath (path)
+        ? path
+        : CLIConfig::getInstance().getDataRootPath() + '/' + path;
 
-    return CLIConfig::getInstance().getDataRootPath() + '/' + path;
+    AccessedFiles::add (absolutePath);
+    return absolutePath;
+}
+
+/// @brief Adds a suffix to the file name, keeping its extension
+/// @details For example, "out/render.wav" with suffix "_input" becomes "out/render_input.wav"
+inline static std::string appendToFileName (const std::string& path, const std::string& suffix)
+{
+    const size_t nameStart = path.find_last_of ("/\\") + 1;
+    const size_t extensionStart = path.find_last_of ('.');
+
+    if (extensionStart == std::string::npos || extensionStart < nameStart)
+        return path + suffix;
+
+    return path.substr (0, extensionStart) + suffix + path.substr (extensionStart);
 }
 
 /// @brief `std::unordered_map::contains()` replacement for C++11
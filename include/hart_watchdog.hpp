@@ -0,0 +1,139 @@
+#pragma once
+
+#include <algorithm>  // min()
+#include <chrono>
+#include <condition_variable>
+#include <cstdlib>  // _Exit()
+#include <iostream>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "hart_cancellation.hpp"
+
+namespace hart
+{
+
+/// @brief Enforces test timeouts
+/// @details Runs a background thread that cancels the token of each task that runs past its deadline.
+/// A cancelled test is expected to stop at the next block boundary. If it doesn't stop within a grace period
+/// (for example, when it's stuck inside a DSP callback), there's no safe way to interrupt it in-process, so the
+/// watchdog reports the hung task and terminates the whole test run, rather than letting it hang forever.
+/// @private
+class Watchdog
+{
+public:
+    /// @param gracePeriodSeconds How long a timed out task has to stop before the run is terminated
+    Watchdog (double gracePeriodSeconds):
+        m_gracePeriod (toDuration (gracePeriodSeconds))
+    {
+    }
+
+    ~Watchdog()
+    {
+        {
+            std::lock_guard<std::mutex> lock (m_mutex);
+            m_isStopping = true;
+        }
+
+        m_condition.notify_all();
+
+        if (m_thread.joinable())
+            m_thread.join();
+    }
+
+    /// @brief Starts watching a task
+    /// @param token Token that will be cancelled when the task times out. Should outlive the call to @ref disarm().
+    /// @param timeoutSeconds Timeout for the task
+    /// @param taskName Name of the task, for the report
+    /// @return Id to pass to @ref disarm() once the task is done
+    size_t arm (CancellationToken& token, double timeoutSeconds, const std::string& taskName)
+    {
+        std::lock_guard<std::mutex> lock (m_mutex);
+
+        if (! m_thread.joinable())
+            m_thread = std::thread (&Watchdog::watch, this);
+
+        const size_t id = m_nextId++;
+        m_entries.emplace_back (Entry { id, &token, taskName, Clock::now() + toDuration (timeoutSeconds), false });
+        m_condition.notify_all();
+        return id;
+    }
+
+    /// @brief Stops watching a task
+    void disarm (size_t id)
+    {
+        std::lock_guard<std::mutex> lock (m_mutex);
+
+        for (auto it = m_entries.begin(); it != m_entries.end(); ++it)
+        {
+            if (it->id == id)
+            {
+                m_entries.erase (it);
+                return;
+            }
+        }
+    }
+
+private:
+    using Clock = std::chrono::steady_clock;
+
+    struct Entry
+    {
+        size_t id;
+        CancellationToken* token;
+        std::string taskName;
+        Clock::time_point deadline;
+        bool isCancelled;
+    };
+
+    const Clock::duration m_gracePeriod;
+    std::vector<Entry> m_entries;
+    size_t m_nextId = 0;
+    bool m_isStopping = false;
+    std::mutex m_mutex;
+    std::condition_variable m_condition;
+    std::thread m_thread;
+
+    void watch()
+    {
+        std::unique_lock<std::mutex> lock (m_mutex);
+
+        while (! m_isStopping)
+        {
+            const Clock::time_point now = Clock::now();
+            Clock::time_point nextDeadline = Clock::time_point::max();
+
+            for (Entry& entry : m_entries)
+            {
+                if (entry.deadline <= now)
+                {
+                    if (entry.isCancelled)
+                    {
+                        std::cout << std::endl << "[ HUNG   ] " << entry.taskName << " - did not stop after timing out, terminating the test run" << std::endl;
+                        std::_Exit (EXIT_FAILURE);
+                    }
+
+                    entry.token->cancel (CancellationReason::timeout);
+                    entry.isCancelled = true;
+                    entry.deadline = now + m_gracePeriod;
+                }
+
+                nextDeadline = std::min (nextDeadline, entry.deadline);
+            }
+
+            if (nextDeadline == Clock::time_point::max())
+                m_condition.wait (lock);
+            else
+                m_condition.wait_until (lock, nextDeadline);
+        }
+    }
+
+    static Clock::duration toDuration (double seconds)
+    {
+        return std::chrono::duration_cast<Clock::duration> (std::chrono::duration<double> (seconds));
+    }
+};
+
+}  // namespace hart
@@ -0,0 +1,256 @@
+#pragma once
+
+#include <algorithm>  // fill(), max(), min()
+#include <cmath>
+#include <sstream>
+#include <vector>
+
+#include "hart_exceptions.hpp"
+#include "hart_fft.hpp"  // nextPowerOfTwo()
+#include "matchers/hart_matcher.hpp"
+#include "hart_power_spectrogram.hpp"
+#include "hart_precision.hpp"
+#include "signals/hart_sine_sweep.hpp"
+#include "hart_utils.hpp"
+
+namespace hart
+{
+
+/// @brief Checks whether the aliasing of a sine or a sine sweep stays below a certain level
+/// @details The audio is split into overlapping frames of about 40 ms, and the power spectrum of each frame is split
+/// into the harmonics of the input frequency and everything else. The harmonics are all the multiples of the input
+/// frequency below Nyquist, as far as the input frequency goes within the frame, plus the leakage of the window.
+/// Everything else counts as aliasing, including the images of the harmonics above Nyquist that got folded back
+/// below it. The aliasing level is the energy of everything else relative to the energy of the whole frame, so it
+/// doesn't depend on the gain of the tested effect. DC doesn't count as aliasing, nor as the signal.
+/// Handy for saturators, waveshapers and oscillators:
+/// @code
+/// processAudioWith (MySaturator())
+///     .withInputSignal (SineWave (5_kHz))
+///     .expectTrue (AliasingBelow (-80_dB, 5_kHz))
+///     .process();
+/// @endcode
+/// The input frequency has to be the one that goes into the tested effect, so for the sweeps, pass the same
+/// @ref SineSweep as the input signal, and make sure the effect has no latency. The frames with silence in them,
+/// the ones after the sweep has ended, and the ones where a looped sweep turns around are skipped. Each channel
+/// is checked on its own.
+/// Keep in mind that the harmonics of the frequencies below about 200 Hz are too close together to tell apart
+/// from the aliasing in between, so the low frequencies hardly ever fail this check.
+/// @ingroup Matchers
+template<typename SampleType>
+class AliasingBelow:
+    public Matcher<SampleType>
+{
+public:
+    /// @brief Creates a matcher for a sine input
+    /// @param thresholdDb Maximum level of the aliasing relative to the whole signal, in decibels
+    /// @param frequencyHz Frequency of the input sine wave
+    AliasingBelow (double thresholdDb, double frequencyHz):
+        m_thresholdDb (thresholdDb),
+        // A sweep that never changes its frequency and never ends is just a sine wave
+        m_inputSweep (1.0, frequencyHz, frequencyHz, SineSweep<SampleType>::SweepType::linear, SineSweep<SampleType>::Loop::yes),
+        m_isSweep (false)
+    {
+    }
+
+    /// @brief Creates a matcher for a sine sweep input
+    /// @param thresholdDb Maximum level of the aliasing relative to the whole signal, in decibels
+    /// @param inputSweep Same sweep as the input signal of the tested effect
+    AliasingBelow (double thresholdDb, const SineSweep<SampleType>& inputSweep):
+        m_thresholdDb (thresholdDb),
+        m_inputSweep (inputSweep),
+        m_isSweep (true)
+    {
+    }
+
+    void prepare (double sampleRateHz, size_t numChannels, size_t /* maxBlockSizeFrames */) override
+    {
+        m_sampleRateHz = sampleRateHz;
+
+        PowerSpectrogram spectrogram;
+        spectrogram.prepare (nextPowerOfTwo (std::max<size_t> (64, roundToSizeT (0.04 * sampleRateHz))));
+        m_channelSpectrograms.assign (numChannels, spectrogram);
+        m_isHarmonicBin.assign (spectrogram.getNumBins(), false);
+    }
+
+    bool match (const AudioBuffer<SampleType>& observedAudio) override
+    {
+        const size_t numFrames = observedAudio.getNumFrames();
+
+        for (size_t channel = 0; channel < observedAudio.getNumChannels() && channel < m_channelSpectrograms.size(); ++channel)
+        {
+            PowerSpectrogram& spectrogram = m_channelSpectrograms[channel];
+            const SampleType* channelFrames = observedAudio[channel];
+
+            for (size_t frame = 0; frame < numFrames; ++frame)
+            {
+                if (! spectrogram.push (channelFrames[frame]))
+                    continue;
+
+                if (isWithin (spectrogram))
+                    continue;
+
+                m_failedFrame = frame;
+                m_failedChannel = channel;
+                return false;
+            }
+        }
+
+        return true;
+    }
+
+    bool canOperatePerBlock() override
+    {
+        return true;
+    }
+
+    void reset() override
+    {
+        for (PowerSpectrogram& spectrogram : m_channelSpectrograms)
+            spectrogram.reset();
+    }
+
+    virtual MatcherFailureDetails getFailureDetails() const override
+    {
+        std::stringstream stream;
+        stream << "Aliasing is " << dbPrecision << m_aliasingDb << " dB relative to the signal"
+            << ", loudest at " << hzPrecision << m_loudestAliasFrequencyHz << " Hz"
+            << ", with the input at " << hzPrecision << m_inputFrequencyHz << " Hz"
+            << ", in the frame starting at " << secPrecision << m_failedFrameStartSeconds << " seconds";
+
+        MatcherFailureDetails details;
+        details.frame = m_failedFrame;
+        details.channel = m_failedChannel;
+        details.description = stream.str();
+        return details;
+    }
+
+    void represent (std::ostream& stream) const override
+    {
+        stream << "AliasingBelow (" << dbPrecision << m_thresholdDb << "_dB, ";
+
+        if (m_isSweep)
+            stream << "<SineSweep>)";
+        else
+            stream << hzPrecision << m_inputSweep.getStartFrequencyHz() << "_Hz)";
+    }
+
+    HART_MATCHER_DEFINE_COPY_AND_MOVE (AliasingBelow);
+
+private:
+    const double m_thresholdDb;
+    const SineSweep<SampleType> m_inputSweep;
+    const bool m_isSweep;
+    std::vector<PowerSpectrogram> m_channelSpectrograms;
+    std::vector<bool> m_isHarmonicBin;
+
+    double m_sampleRateHz = 0.0;
+
+    size_t m_failedFrame = 0;
+    size_t m_failedChannel = 0;
+    double m_failedFrameStartSeconds = 0.0;
+    double m_aliasingDb = 0.0;
+    double m_inputFrequencyHz = 0.0;
+    double m_loudestAliasFrequencyHz = 0.0;
+
+    bool isWithin (const PowerSpectrogram& spectrogram)
+    {
+        const size_t frameSize = spectrogram.getFrameSize();
+        const double frameStartSeconds = spectrogram.getFrameStart() / m_sampleRateHz;
+        const double frameDurationSeconds = frameSize / m_sampleRateHz;
+
+        // The sweep can go either way within the frame, so it's sampled all over it
+        constexpr size_t numFrequencyPoints = 9;
+        const double pointIntervalSeconds = frameDurationSeconds / (numFrequencyPoints - 1);
+        double minFrequencyHz = 0.0;
+        double maxFrequencyHz = 0.0;
+        double maxSweepRateHzPerSecond = 0.0;
+        double previousFrequencyHz = 0.0;
+        double previousFrequencyChangeHz = 0.0;
+
+        for (size_t point = 0; point < numFrequencyPoints; ++point)
+        {
+            const double timeSeconds = frameStartSeconds + pointIntervalSeconds * point;
+            const double frequencyHz = m_inputSweep.getFrequencyHzAt (timeSeconds);
+
+            // The frequency is unknown after the sweep has ended
+            if (frequencyHz <= 0)
+                return true;
+
+            if (point > 0)
+            {
+                const double frequencyChangeHz = frequencyHz - previousFrequencyHz;
+
+                // The turn of a looped sweep splatters all over the spectrum on its own
+                if (frequencyChangeHz * previousFrequencyChangeHz < 0)
+                    return true;
+
+                maxSweepRateHzPerSecond = std::max (maxSweepRateHzPerSecond, std::abs (frequencyChangeHz) / pointIntervalSeconds);
+                previousFrequencyChangeHz = frequencyChangeHz;
+            }
+
+            minFrequencyHz = point == 0 ? frequencyHz : std::min (minFrequencyHz, frequencyHz);
+            maxFrequencyHz = point == 0 ? frequencyHz : std::max (maxFrequencyHz, frequencyHz);
+            previousFrequencyHz = frequencyHz;
+        }
+
+        const std::vector<double>& powerSpectrum = spectrogram.getPowerSpectrum();
+        const size_t numBins = powerSpectrum.size();
+        const double binsPerHz = frameSize / m_sampleRateHz;
+        const size_t margin = PowerSpectrogram::toneHalfWidthBins;
+
+        std::fill (m_isHarmonicBin.begin(), m_isHarmonicBin.end(), false);
+        std::fill (m_isHarmonicBin.begin(), m_isHarmonicBin.begin() + std::min (margin + 1, numBins), true);
+
+        for (size_t harmonic = 1; harmonic * minFrequencyHz * binsPerHz < numBins - 1; ++harmonic)
+        {
+            // A chirp spreads beyond its frequency range by about the square root of its rate
+            const double chirpSpreadBins = std::sqrt (harmonic * maxSweepRateHzPerSecond) * binsPerHz;
+            const double lowestBin = harmonic * minFrequencyHz * binsPerHz - chirpSpreadBins - margin;
+            const double highestBin = harmonic * maxFrequencyHz * binsPerHz + chirpSpreadBins + margin;
+            const size_t firstBin = lowestBin > 0 ? (size_t) std::floor (lowestBin) : 0;
+            const size_t lastBin = std::min (numBins - 1, (size_t) std::ceil (highestBin));
+
+            for (size_t bin = firstBin; bin <= lastBin; ++bin)
+                m_isHarmonicBin[bin] = true;
+        }
+
+        double totalEnergy = 0.0;
+        double aliasingEnergy = 0.0;
+        double loudestAliasPower = 0.0;
+        size_t loudestAliasBin = 0;
+
+        for (size_t bin = margin + 1; bin < numBins; ++bin)
+        {
+            totalEnergy += powerSpectrum[bin];
+
+            if (m_isHarmonicBin[bin])
+                continue;
+
+            aliasingEnergy += powerSpectrum[bin];
+
+            if (powerSpectrum[bin] > loudestAliasPower)
+            {
+                loudestAliasPower = powerSpectrum[bin];
+                loudestAliasBin = bin;
+            }
+        }
+
+        // Nothing but DC
+        if (totalEnergy <= 0)
+            return true;
+
+        const double aliasingDb = ratioToDecibels (std::sqrt (aliasingEnergy / totalEnergy));
+
+        if (aliasingDb <= m_thresholdDb)
+            return true;
+
+        m_aliasingDb = aliasingDb;
+        m_inputFrequencyHz = 0.5 * (minFrequencyHz + maxFrequencyHz);
+        m_loudestAliasFrequencyHz = loudestAliasBin / binsPerHz;
+        m_failedFrameStartSeconds = frameStartSeconds;
+        return false;
+    }
+};
+
+}  // namespace hart
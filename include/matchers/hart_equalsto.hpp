@@ -1,8 +1,11 @@
 #pragma once
 
+#include <algorithm>  // min()
 #include <cmath>  // abs()
 #include <iomanip>
+#include <memory>
 #include <sstream>
+#include <utility>  // forward()
 
 #include "matchers/hart_matcher.hpp"
 #include "hart_precision.hpp"
@@ -25,20 +28,33 @@ class EqualsTo:
 public:
     /// @brief Creates a matcher for a specific signal
     /// details The reference signal can be something simple like a @ref SineWave, or more
-    /// complex signal with DSP effects chain and automation envelopes.
+    /// complex signal with DSP effects chain and automation envelopes. It gets copied or moved, depending on what you pass.
     /// @note Tip: To compare audio to a pre-recorded wav file, you can use @ref WavFile.
     /// @param referenceSignal Signal to compare the incoming audio against
     /// @param toleranceLinear Absolute tolerance for comparing frames, in linear domain (not decibels)
-    template <typename SignalType>
-    EqualsTo (const SignalType& referenceSignal, double toleranceLinear = (SampleType) 1e-5):
-        m_referenceSignal (referenceSignal.copy()),
+    template <
+        typename SignalType,
+        typename = typename std::enable_if<
+            std::is_base_of<
+                Signal<SampleType>,
+                typename std::decay<SignalType>::type
+                >::value
+            >::type
+        >
+    EqualsTo (SignalType&& referenceSignal, double toleranceLinear = (SampleType) 1e-5):
+        m_referenceSignal (takeSignal (std::forward<SignalType> (referenceSignal))),
+        m_toleranceLinear ((SampleType) toleranceLinear)
+    {
+    }
+
+    /// @brief Creates a matcher for a specific signal by transfering a smart pointer
+    /// @details Use this if your signal does not support copying or moving
+    /// @param referenceSignal Signal to compare the incoming audio against
+    /// @param toleranceLinear Absolute tolerance for comparing frames, in linear domain (not decibels)
+    EqualsTo (std::unique_ptr<Signal<SampleType>> referenceSignal, double toleranceLinear = (SampleType) 1e-5):
+        m_referenceSignal (std::move (referenceSignal)),
         m_toleranceLinear ((SampleType) toleranceLinear)
     {
-        using DecayedType = typename std::decay<SignalType>::type;
-        static_assert (
-            std::is_base_of<Signal<SampleType>, DecayedType>::value,
-            "SignalType must be a hart::Signal subclass"
-            );
     }
 
     EqualsTo (EqualsTo&& other) noexcept:
@@ -56,16 +72,23 @@ public:
     void prepare (double sampleRateHz, size_t numChannels, size_t maxBlockSizeFrames) override
     {
         m_referenceSignal->prepareWithDSPChain (sampleRateHz, numChannels, maxBlockSizeFrames);
+        m_referenceAudio = hart::make_unique<AudioBuffer<SampleType>> (numChannels, maxBlockSizeFrames);
     }
 
     bool match (const AudioBuffer<SampleType>& observedAudio) override
     {
-        auto referenceAudio = AudioBuffer<SampleType>::emptyLike (observedAudio);
+        AudioBuffer<SampleType>& referenceAudio = *m_referenceAudio;
+        referenceAudio.resize (observedAudio.getNumFrames());
         m_referenceSignal->renderNextBlockWithDSPChain (referenceAudio);
 
-        for (size_t channel = 0; channel < referenceAudio.getNumChannels(); ++channel)
+        // If both are constant, e.g. a silent tail compared to Silence, the first frame tells it all
+        const bool areBothConstant = referenceAudio.isConstant() && observedAudio.isConstant();
+        const size_t numChannels = areBothConstant ? std::min<size_t> (1, referenceAudio.getNumChannels()) : referenceAudio.getNumChannels();
+        const size_t numFrames = areBothConstant ? std::min<size_t> (1, referenceAudio.getNumFrames()) : referenceAudio.getNumFrames();
+
+        for (size_t channel = 0; channel < numChannels; ++channel)
         {
-            for (size_t frame = 0; frame < referenceAudio.getNumFrames(); ++frame)
+            for (size_t frame = 0; frame < numFrames; ++frame)
             {
                 if (notEqual (observedAudio[channel][frame], referenceAudio[channel][frame]))
                 {
@@ -107,6 +130,11 @@ public:
         return details;
     }
 
+    const AudioBuffer<SampleType>* getReferenceAudio() const override
+    {
+        return m_referenceAudio.get();
+    }
+
     void represent (std::ostream& stream) const override
     {
         stream << "EqualsTo (" << *m_referenceSignal
@@ -118,12 +146,23 @@ public:
 private:
     std::unique_ptr<Signal<SampleType>> m_referenceSignal;
     const SampleType m_toleranceLinear;
+    std::unique_ptr<AudioBuffer<SampleType>> m_referenceAudio;
 
     size_t m_failedFrame = 0;
     size_t m_failedChannel = 0;
     SampleType m_failedObservedValue = (SampleType) 0;
     SampleType m_failedExpectedValue = (SampleType) 0;
 
+    static std::unique_ptr<Signal<SampleType>> takeSignal (const Signal<SampleType>& signal)
+    {
+        return signal.copy();
+    }
+
+    static std::unique_ptr<Signal<SampleType>> takeSignal (Signal<SampleType>&& signal)
+    {
+        return signal.move();
+    }
+
     inline bool notEqual (SampleType x, SampleType y)
     {
         return std::abs (x - y) > m_toleranceLinear;
@@ -0,0 +1,123 @@
+#pragma once
+
+#include <sstream>
+
+#include "matchers/hart_matcher.hpp"
+#include "matchers/hart_response_mask.hpp"
+#include "hart_precision.hpp"
+#include "signals/hart_sine_sweep.hpp"
+#include "hart_sweep_response.hpp"
+
+namespace hart
+{
+
+/// @brief Checks whether the magnitude response of the effect stays within a mask
+/// @details Measures the response from the output of the effect for a sine sweep, so one sweep checks all the
+/// frequencies at once. Feed the same sweep to the effect, like so:
+/// @code
+/// const SineSweep sweep (2_s, 20_Hz, 20_kHz);
+///
+/// processAudioWith (MyEffect())
+///     .withInputSignal (sweep)
+///     .withDuration (2.5_s)
+///     .expectTrue (FrequencyResponseWithin (sweep, ResponseMask().withBand (20_Hz, 20_kHz, -0.5_dB, 0.5_dB)))
+///     .process();
+/// @endcode
+/// Make the test a bit longer than the sweep, so that the tail of the effect gets measured too. Use a log sweep
+/// (the default one) if the effect distorts, so that its harmonics don't get mixed up with the linear response.
+/// Only the frequencies within the range of the sweep get checked. Each channel is checked on its own.
+/// @see ResponseMask, SweepResponse
+/// @ingroup Matchers
+template<typename SampleType>
+class FrequencyResponseWithin:
+    public Matcher<SampleType>
+{
+public:
+    /// @brief Creates a matcher for a magnitude response mask
+    /// @param sweep Sweep that the tested effect gets as an input
+    /// @param maskDb Limits of the magnitude response in decibels
+    FrequencyResponseWithin (const SineSweep<SampleType>& sweep, const ResponseMask& maskDb):
+        m_response (sweep),
+        m_maskDb (maskDb)
+    {
+    }
+
+    void prepare (double sampleRateHz, size_t /* numChannels */, size_t /* maxBlockSizeFrames */) override
+    {
+        m_response.prepare (sampleRateHz);
+    }
+
+    bool match (const AudioBuffer<SampleType>& observedAudio) override
+    {
+        for (size_t channel = 0; channel < observedAudio.getNumChannels(); ++channel)
+        {
+            m_failedChannel = channel;
+            m_isTooShort = ! m_response.measure (observedAudio[channel], observedAudio.getNumFrames());
+
+            if (m_isTooShort)
+                return false;
+
+            const auto getMagnitudeDb = [this] (size_t bin) { return m_response.getMagnitudeDb (bin); };
+
+            if (! m_response.isWithin (m_maskDb, getMagnitudeDb, false, m_failedBin, m_failedBand))
+            {
+                m_failedFrequencyHz = m_response.getBinFrequencyHz (m_failedBin);
+                m_failedMagnitudeDb = m_response.getMagnitudeDb (m_failedBin);
+                return false;
+            }
+        }
+
+        return true;
+    }
+
+    bool canOperatePerBlock() override
+    {
+        return false;
+    }
+
+    void reset() override {}
+
+    virtual MatcherFailureDetails getFailureDetails() const override
+    {
+        std::stringstream stream;
+        MatcherFailureDetails details;
+        details.channel = m_failedChannel;
+
+        if (m_isTooShort)
+        {
+            stream << "Audio is shorter than the sweep";
+        }
+        else
+        {
+            details.frame = m_response.getFrameOfFrequency (m_failedFrequencyHz);
+            stream << "Magnitude response is " << dbPrecision << m_failedMagnitudeDb << " dB"
+                << " at " << hzPrecision << m_failedFrequencyHz << " Hz"
+                << ", expected between " << dbPrecision << m_failedBand.minValue << " dB and " << m_failedBand.maxValue << " dB";
+        }
+
+        details.description = stream.str();
+        return details;
+    }
+
+    void represent (std::ostream& stream) const override
+    {
+        stream << "FrequencyResponseWithin (" << m_response.getSweep() << ", ";
+        m_maskDb.represent (stream, dbPrecision, "_dB");
+        stream << ')';
+    }
+
+    HART_MATCHER_DEFINE_COPY_AND_MOVE (FrequencyResponseWithin);
+
+private:
+    SweepResponse<SampleType> m_response;
+    const ResponseMask m_maskDb;
+
+    bool m_isTooShort = false;
+    size_t m_failedChannel = 0;
+    size_t m_failedBin = 0;
+    ResponseMask::Band m_failedBand {};
+    double m_failedFrequencyHz = 0.0;
+    double m_failedMagnitudeDb = 0.0;
+};
+
+}  // namespace hart
@@ -0,0 +1,202 @@
+#pragma once
+
+#include <algorithm>  // fill()
+#include <cmath>  // log2()
+#include <memory>
+#include <sstream>
+#include <vector>
+
+#include "envelopes/hart_envelope.hpp"
+#include "hart_exceptions.hpp"
+#include "hart_fft.hpp"  // nextPowerOfTwo()
+#include "matchers/hart_matcher.hpp"
+#include "hart_pitch_detector.hpp"
+#include "hart_precision.hpp"
+
+namespace hart
+{
+
+/// @brief Checks whether the fundamental frequency of the audio follows an envelope
+/// @details Same as @ref FundamentalFrequencyAt, but the expected frequency changes over time. The pitch is estimated
+/// every 5 ms, and compared to the value of the envelope at the time of the estimate, which is in the first half of
+/// the analysis window, see @ref PitchDetector::getEstimateAgeFrames(). The windows with silence in them are skipped,
+/// and so are the estimates where the envelope is at zero or below, which is handy for the glides you don't care
+/// about. For example, to check a pitch shifter that bends up an octave over one second:
+/// @code
+/// processAudioWith (PitchBend())
+///     .withInputSignal (SineWave (220_Hz))
+///     .expectTrue (FrequencyTracks (SegmentedEnvelope (220_Hz).rampTo (440_Hz, 1_s, SegmentedEnvelope::Shape::exponential)))
+///     .process();
+/// @endcode
+/// The length of the analysis window is twice the period of the lowest frequency, so it's worth narrowing down
+/// the frequency range for the faster changes of pitch.
+/// @see FundamentalFrequencyAt
+/// @ingroup Matchers
+template<typename SampleType>
+class FrequencyTracks:
+    public Matcher<SampleType>
+{
+public:
+    /// @brief Creates a matcher for a fundamental frequency envelope
+    /// @param frequencyHz Expected fundamental frequency in Hz over time
+    /// @param centsTolerance Maximum deviation from the expected frequency, in cents
+    /// @param minFrequencyHz Lowest frequency to look for
+    /// @param maxFrequencyHz Highest frequency to look for
+    FrequencyTracks (const Envelope& frequencyHz, double centsTolerance = 10.0, double minFrequencyHz = 30.0, double maxFrequencyHz = 8000.0):
+        m_frequencyEnvelope (frequencyHz.copy()),
+        m_centsTolerance (centsTolerance),
+        m_minFrequencyHz (minFrequencyHz),
+        m_maxFrequencyHz (maxFrequencyHz),
+        m_detector (minFrequencyHz, maxFrequencyHz)
+    {
+        if (centsTolerance < 0)
+            HART_THROW_OR_RETURN_VOID (hart::ValueError, "Tolerance cannot be negative");
+    }
+
+    FrequencyTracks (const FrequencyTracks& other):
+        m_frequencyEnvelope (other.m_frequencyEnvelope->copy()),
+        m_centsTolerance (other.m_centsTolerance),
+        m_minFrequencyHz (other.m_minFrequencyHz),
+        m_maxFrequencyHz (other.m_maxFrequencyHz),
+        m_detector (other.m_detector),
+        m_channelDetectors (other.m_channelDetectors),
+        m_expectedFrequenciesHz (other.m_expectedFrequenciesHz),
+        m_expectedFrequenciesMask (other.m_expectedFrequenciesMask),
+        m_blockFrequenciesHz (other.m_blockFrequenciesHz),
+        m_sampleRateHz (other.m_sampleRateHz),
+        m_numFramesMatched (other.m_numFramesMatched)
+    {
+    }
+
+    FrequencyTracks (FrequencyTracks&& other) = default;
+
+    void prepare (double sampleRateHz, size_t numChannels, size_t maxBlockSizeFrames) override
+    {
+        m_sampleRateHz = sampleRateHz;
+        m_detector.prepare (sampleRateHz);
+        m_channelDetectors.assign (numChannels, m_detector);
+
+        // The whole block is written before any of the windows ending in it get checked, so the expected values
+        // are kept for as long as the analysis window plus one block, to look up the one at the time of the estimate
+        const size_t ringSize = nextPowerOfTwo (m_detector.getWindowFrames() + maxBlockSizeFrames);
+        m_expectedFrequenciesHz.assign (ringSize, 0.0);
+        m_expectedFrequenciesMask = ringSize - 1;
+        m_blockFrequenciesHz.reserve (maxBlockSizeFrames);
+
+        m_frequencyEnvelope->prepare (sampleRateHz, maxBlockSizeFrames);
+        m_frequencyEnvelope->reset();
+        m_numFramesMatched = 0;
+    }
+
+    bool match (const AudioBuffer<SampleType>& observedAudio) override
+    {
+        const size_t numFrames = observedAudio.getNumFrames();
+        m_blockFrequenciesHz.resize (numFrames);
+        m_frequencyEnvelope->renderNextBlock (numFrames, m_blockFrequenciesHz);
+
+        for (size_t frame = 0; frame < numFrames; ++frame)
+            m_expectedFrequenciesHz[(m_numFramesMatched + frame) & m_expectedFrequenciesMask] = m_blockFrequenciesHz[frame];
+
+        for (size_t channel = 0; channel < observedAudio.getNumChannels() && channel < m_channelDetectors.size(); ++channel)
+        {
+            PitchDetector& detector = m_channelDetectors[channel];
+            const SampleType* channelFrames = observedAudio[channel];
+
+            for (size_t frame = 0; frame < numFrames; ++frame)
+            {
+                if (! detector.push (channelFrames[frame]) || detector.isSilent())
+                    continue;
+
+                const size_t estimateFrame = m_numFramesMatched + frame - detector.getEstimateAgeFrames();
+                const double expectedFrequencyHz = m_expectedFrequenciesHz[estimateFrame & m_expectedFrequenciesMask];
+
+                if (expectedFrequencyHz <= 0)
+                    continue;
+
+                m_observedFrequencyHz = detector.getFrequencyHz();
+                m_observedCents = detector.isPitched() ? 1200.0 * std::log2 (m_observedFrequencyHz / expectedFrequencyHz) : 0.0;
+
+                if (! detector.isPitched() || std::abs (m_observedCents) > m_centsTolerance)
+                {
+                    m_failedFrame = frame;
+                    m_failedChannel = channel;
+                    m_failedTimeSeconds = estimateFrame / m_sampleRateHz;
+                    m_expectedFrequencyHz = expectedFrequencyHz;
+                    return false;
+                }
+            }
+        }
+
+        m_numFramesMatched += numFrames;
+        return true;
+    }
+
+    bool canOperatePerBlock() override
+    {
+        return true;
+    }
+
+    void reset() override
+    {
+        for (PitchDetector& detector : m_channelDetectors)
+            detector.reset();
+
+        std::fill (m_expectedFrequenciesHz.begin(), m_expectedFrequenciesHz.end(), 0.0);
+        m_frequencyEnvelope->reset();
+        m_numFramesMatched = 0;
+    }
+
+    virtual MatcherFailureDetails getFailureDetails() const override
+    {
+        std::stringstream stream;
+
+        if (m_observedFrequencyHz > 0)
+            stream << "Fundamental frequency is " << hzPrecision << m_observedFrequencyHz << " Hz ("
+                << std::showpos << m_observedCents << std::noshowpos << " cents)";
+        else
+            stream << "No clear fundamental frequency";
+
+        stream << " at " << secPrecision << m_failedTimeSeconds << " seconds"
+            << ", expected " << hzPrecision << m_expectedFrequencyHz << " Hz";
+
+        MatcherFailureDetails details;
+        details.frame = m_failedFrame;
+        details.channel = m_failedChannel;
+        details.description = stream.str();
+        return details;
+    }
+
+    void represent (std::ostream& stream) const override
+    {
+        stream << "FrequencyTracks (<Envelope>, "
+            << m_centsTolerance << ", "
+            << hzPrecision << m_minFrequencyHz << "_Hz, "
+            << m_maxFrequencyHz << "_Hz)";
+    }
+
+    HART_MATCHER_DEFINE_COPY_AND_MOVE (FrequencyTracks);
+
+private:
+    std::unique_ptr<Envelope> m_frequencyEnvelope;
+    const double m_centsTolerance;
+    const double m_minFrequencyHz;
+    const double m_maxFrequencyHz;
+    PitchDetector m_detector;
+    std::vector<PitchDetector> m_channelDetectors;
+
+    std::vector<double> m_expectedFrequenciesHz;
+    size_t m_expectedFrequenciesMask = 0;
+    std::vector<double> m_blockFrequenciesHz;
+
+    double m_sampleRateHz = 0.0;
+    size_t m_numFramesMatched = 0;
+
+    size_t m_failedFrame = 0;
+    size_t m_failedChannel = 0;
+    double m_failedTimeSeconds = 0.0;
+    double m_expectedFrequencyHz = 0.0;
+    double m_observedFrequencyHz = 0.0;
+    double m_observedCents = 0.0;
+};
+
+}  // namespace hart
@@ -0,0 +1,145 @@
+#pragma once
+
+#include <cmath>  // log2()
+#include <sstream>
+#include <vector>
+
+#include "hart_exceptions.hpp"
+#include "matchers/hart_matcher.hpp"
+#include "hart_pitch_detector.hpp"
+#include "hart_precision.hpp"
+
+namespace hart
+{
+
+/// @brief Checks whether the audio has a specific fundamental frequency
+/// @details The pitch is estimated every 5 ms over a sliding window, see @ref PitchDetector. The window is eight
+/// periods of the expected frequency long, and the pitch is searched within two octaves around it, so octave errors
+/// of the tested effect are detected too. Each channel is checked on its own. The windows with silence in them are
+/// skipped, so the latency and the tail of the effect don't count, but the audio without any clear pitch does.
+/// Handy for oscillators, pitch shifters and resamplers:
+/// @code
+/// processAudioWith (PitchShifter (12))
+///     .withInputSignal (SineWave (440_Hz))
+///     .expectTrue (FundamentalFrequencyAt (880_Hz, 5))
+///     .process();
+/// @endcode
+/// @see FrequencyTracks
+/// @ingroup Matchers
+template<typename SampleType>
+class FundamentalFrequencyAt:
+    public Matcher<SampleType>
+{
+public:
+    /// @brief Creates a matcher for a specific fundamental frequency
+    /// @param frequencyHz Expected fundamental frequency in Hz
+    /// @param centsTolerance Maximum deviation from the expected frequency, in cents
+    FundamentalFrequencyAt (double frequencyHz, double centsTolerance = 10.0):
+        m_frequencyHz (frequencyHz),
+        m_centsTolerance (centsTolerance),
+        m_detector (frequencyHz / 4.0, frequencyHz * 4.0)
+    {
+        if (frequencyHz <= 0)
+            HART_THROW_OR_RETURN_VOID (hart::ValueError, "Frequency must be positive");
+
+        if (centsTolerance < 0)
+            HART_THROW_OR_RETURN_VOID (hart::ValueError, "Tolerance cannot be negative");
+    }
+
+    void prepare (double sampleRateHz, size_t numChannels, size_t /* maxBlockSizeFrames */) override
+    {
+        m_sampleRateHz = sampleRateHz;
+        m_detector.prepare (sampleRateHz);
+        m_channelDetectors.assign (numChannels, m_detector);
+        m_numFramesMatched = 0;
+    }
+
+    bool match (const AudioBuffer<SampleType>& observedAudio) override
+    {
+        const size_t numFrames = observedAudio.getNumFrames();
+
+        for (size_t channel = 0; channel < observedAudio.getNumChannels() && channel < m_channelDetectors.size(); ++channel)
+        {
+            PitchDetector& detector = m_channelDetectors[channel];
+            const SampleType* channelFrames = observedAudio[channel];
+
+            for (size_t frame = 0; frame < numFrames; ++frame)
+            {
+                if (! detector.push (channelFrames[frame]) || detector.isSilent())
+                    continue;
+
+                m_observedFrequencyHz = detector.getFrequencyHz();
+                m_observedCents = detector.isPitched() ? 1200.0 * std::log2 (m_observedFrequencyHz / m_frequencyHz) : 0.0;
+
+                if (! detector.isPitched() || std::abs (m_observedCents) > m_centsTolerance)
+                {
+                    m_failedFrame = frame;
+                    m_failedChannel = channel;
+                    m_failedTimeSeconds = (double) (m_numFramesMatched + frame - detector.getEstimateAgeFrames()) / m_sampleRateHz;
+                    return false;
+                }
+            }
+        }
+
+        m_numFramesMatched += numFrames;
+        return true;
+    }
+
+    bool canOperatePerBlock() override
+    {
+        return true;
+    }
+
+    void reset() override
+    {
+        for (PitchDetector& detector : m_channelDetectors)
+            detector.reset();
+
+        m_numFramesMatched = 0;
+    }
+
+    virtual MatcherFailureDetails getFailureDetails() const override
+    {
+        std::stringstream stream;
+
+        if (m_observedFrequencyHz > 0)
+            stream << "Fundamental frequency is " << hzPrecision << m_observedFrequencyHz << " Hz ("
+                << std::showpos << m_observedCents << std::noshowpos << " cents)";
+        else
+            stream << "No clear fundamental frequency";
+
+        stream << " at " << secPrecision << m_failedTimeSeconds << " seconds";
+
+        MatcherFailureDetails details;
+        details.frame = m_failedFrame;
+        details.channel = m_failedChannel;
+        details.description = stream.str();
+        return details;
+    }
+
+    void represent (std::ostream& stream) const override
+    {
+        stream << "FundamentalFrequencyAt ("
+            << hzPrecision << m_frequencyHz << "_Hz, "
+            << m_centsTolerance << ')';
+    }
+
+    HART_MATCHER_DEFINE_COPY_AND_MOVE (FundamentalFrequencyAt);
+
+private:
+    const double m_frequencyHz;
+    const double m_centsTolerance;
+    PitchDetector m_detector;
+    std::vector<PitchDetector> m_channelDetectors;
+
+    double m_sampleRateHz = 0.0;
+    size_t m_numFramesMatched = 0;
+
+    size_t m_failedFrame = 0;
+    size_t m_failedChannel = 0;
+    double m_failedTimeSeconds = 0.0;
+    double m_observedFrequencyHz = 0.0;
+    double m_observedCents = 0.0;
+};
+
+}  // namespace hart
@@ -0,0 +1,124 @@
+#pragma once
+
+#include <algorithm>  // min(), max()
+#include <limits>
+#include <sstream>
+
+#include "matchers/hart_matcher.hpp"
+#include "matchers/hart_response_mask.hpp"
+#include "hart_precision.hpp"
+#include "signals/hart_sine_sweep.hpp"
+#include "hart_sweep_response.hpp"
+
+namespace hart
+{
+
+/// @brief Checks whether the group delay of the effect stays below a threshold
+/// @details Measures the response from the output of the effect for a sine sweep, the same way
+/// @ref FrequencyResponseWithin does, so feed the same sweep to the effect. Group delay includes the latency
+/// of the effect, so it's handy for checking both. Frequencies where the response is more than 60 dB below
+/// its peak are skipped, as the phase there is mostly noise.
+/// @note Tip: To check if the group delay is @em above some value, just flip your assertion, e.g.
+/// @code expectFalse (GroupDelayBelow (sweep, 1_ms)) @endcode
+/// @ingroup Matchers
+template<typename SampleType>
+class GroupDelayBelow:
+    public Matcher<SampleType>
+{
+public:
+    /// @brief Creates a matcher for a group delay threshold
+    /// @param sweep Sweep that the tested effect gets as an input
+    /// @param thresholdSeconds Highest allowed group delay in seconds
+    /// @param startHz Lowest frequency to check, zero means the lowest frequency of the sweep
+    /// @param endHz Highest frequency to check, zero means the highest frequency of the sweep
+    GroupDelayBelow (const SineSweep<SampleType>& sweep, double thresholdSeconds, double startHz = 0.0, double endHz = 0.0):
+        m_response (sweep),
+        m_thresholdSeconds (thresholdSeconds),
+        m_mask (ResponseMask().withBand (
+            startHz > 0 ? startHz : std::min (sweep.getStartFrequencyHz(), sweep.getEndFrequencyHz()),
+            endHz > 0 ? endHz : std::max (sweep.getStartFrequencyHz(), sweep.getEndFrequencyHz()),
+            - std::numeric_limits<double>::infinity(),
+            thresholdSeconds))
+    {
+    }
+
+    void prepare (double sampleRateHz, size_t /* numChannels */, size_t /* maxBlockSizeFrames */) override
+    {
+        m_response.prepare (sampleRateHz);
+    }
+
+    bool match (const AudioBuffer<SampleType>& observedAudio) override
+    {
+        for (size_t channel = 0; channel < observedAudio.getNumChannels(); ++channel)
+        {
+            m_failedChannel = channel;
+            m_isTooShort = ! m_response.measure (observedAudio[channel], observedAudio.getNumFrames());
+
+            if (m_isTooShort)
+                return false;
+
+            const auto getGroupDelaySeconds = [this] (size_t bin) { return m_response.getGroupDelaySeconds (bin); };
+            ResponseMask::Band failedBand;
+
+            if (! m_response.isWithin (m_mask, getGroupDelaySeconds, true, m_failedBin, failedBand))
+            {
+                m_failedFrequencyHz = m_response.getBinFrequencyHz (m_failedBin);
+                m_failedGroupDelaySeconds = m_response.getGroupDelaySeconds (m_failedBin);
+                return false;
+            }
+        }
+
+        return true;
+    }
+
+    bool canOperatePerBlock() override
+    {
+        return false;
+    }
+
+    void reset() override {}
+
+    virtual MatcherFailureDetails getFailureDetails() const override
+    {
+        std::stringstream stream;
+        MatcherFailureDetails details;
+        details.channel = m_failedChannel;
+
+        if (m_isTooShort)
+        {
+            stream << "Audio is shorter than the sweep";
+        }
+        else
+        {
+            details.frame = m_response.getFrameOfFrequency (m_failedFrequencyHz);
+            stream << "Group delay is " << secPrecision << m_failedGroupDelaySeconds << " s"
+                << " at " << hzPrecision << m_failedFrequencyHz << " Hz";
+        }
+
+        details.description = stream.str();
+        return details;
+    }
+
+    void represent (std::ostream& stream) const override
+    {
+        const ResponseMask::Band& band = m_mask.getBands().front();
+        stream << "GroupDelayBelow (" << m_response.getSweep() << ", "
+            << secPrecision << m_thresholdSeconds << "_s, "
+            << hzPrecision << band.startHz << "_Hz, " << band.endHz << "_Hz)";
+    }
+
+    HART_MATCHER_DEFINE_COPY_AND_MOVE (GroupDelayBelow);
+
+private:
+    SweepResponse<SampleType> m_response;
+    const double m_thresholdSeconds;
+    const ResponseMask m_mask;
+
+    bool m_isTooShort = false;
+    size_t m_failedChannel = 0;
+    size_t m_failedBin = 0;
+    double m_failedFrequencyHz = 0.0;
+    double m_failedGroupDelaySeconds = 0.0;
+};
+
+}  // namespace hart
@@ -0,0 +1,73 @@
+#pragma once
+
+#include <algorithm>  // min()
+#include <cmath>  // isfinite()
+#include <iomanip>
+#include <sstream>
+
+#include "matchers/hart_matcher.hpp"
+#include "hart_precision.hpp"
+
+namespace hart
+{
+
+/// @brief Checks whether the audio contains only finite values
+/// @details Reports a mismatch on the first NaN or infinite sample. Handy as a basic sanity check for
+/// DSP that may blow up on extreme parameter values, and used as the default check by @ref Fuzzer.
+/// @ingroup Matchers
+template<typename SampleType>
+class IsFinite:
+    public Matcher<SampleType>
+{
+public:
+    void prepare (double /*sampleRateHz*/, size_t /* numChannels */, size_t /* maxBlockSizeFrames */) override {}
+
+    bool match (const AudioBuffer<SampleType>& observedAudio) override
+    {
+        // All frames of a constant block are the same, so the first one tells it all
+        const size_t numChannels = observedAudio.isConstant() ? std::min<size_t> (1, observedAudio.getNumChannels()) : observedAudio.getNumChannels();
+        const size_t numFrames = observedAudio.isConstant() ? std::min<size_t> (1, observedAudio.getNumFrames()) : observedAudio.getNumFrames();
+
+        for (size_t channel = 0; channel < numChannels; ++channel)
+        {
+            for (size_t frame = 0; frame < numFrames; ++frame)
+            {
+                if (! std::isfinite (observedAudio[channel][frame]))
+                {
+                    m_failedFrame = frame;
+                    m_failedChannel = channel;
+                    m_failedValueIsNaN = std::isnan (observedAudio[channel][frame]);
+                    return false;
+                }
+            }
+        }
+
+        return true;
+    }
+
+    bool canOperatePerBlock() override
+    {
+        return true;
+    }
+
+    void reset() override {}
+
+    virtual MatcherFailureDetails getFailureDetails() const override
+    {
+        MatcherFailureDetails details;
+        details.frame = m_failedFrame;
+        details.channel = m_failedChannel;
+        details.description = m_failedValueIsNaN ? "Observed a NaN value" : "Observed an infinite value";
+        return details;
+    }
+
+    HART_DEFINE_GENERIC_REPRESENT (IsFinite);
+    HART_MATCHER_DEFINE_COPY_AND_MOVE (IsFinite);
+
+private:
+    size_t m_failedFrame = 0;
+    size_t m_failedChannel = 0;
+    bool m_failedValueIsNaN = false;
+};
+
+}  // namespace hart
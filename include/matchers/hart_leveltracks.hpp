@@ -0,0 +1,209 @@
+#pragma once
+
+#include <algorithm>  // fill(), max()
+#include <cmath>  // abs()
+#include <memory>
+#include <sstream>
+#include <vector>
+
+#include "envelopes/hart_envelope.hpp"
+#include "hart_exceptions.hpp"
+#include "hart_fft.hpp"  // nextPowerOfTwo()
+#include "matchers/hart_matcher.hpp"
+#include "hart_precision.hpp"
+#include "hart_sliding_level_meter.hpp"
+#include "hart_utils.hpp"  // roundToSizeT()
+
+namespace hart
+{
+
+/// @brief Checks whether the short-term level of the audio follows an envelope
+/// @details The level is measured over a sliding window at every frame, and compared to the value of the envelope
+/// at the center of the window. Handy for checking the attack and release of compressors, gates and envelope
+/// generators, e.g. for a compressor that gets 20 dB of gain reduction in about 10 ms:
+/// @code
+/// processAudioWith (MyCompressor())
+///     .withInputSignal (SineWave (1_kHz))
+///     .expectTrue (LevelTracks (SegmentedEnvelope (-3_dB).rampTo (-23_dB, 10_ms, SegmentedEnvelope::Shape::exponential), 1_dB))
+///     .process();
+/// @endcode
+/// Note that the RMS level of a sine is 3 dB below its peak level. The first frames, until the window fills up, are not
+/// checked. Each channel is checked on its own. If the level is off by more than the tolerance, the worst deviation
+/// within the block gets reported, along with its time. When the matcher gets the whole signal at once, as with
+/// @ref AudioTestBuilder::expectFalse(), that's the worst deviation overall.
+/// @ingroup Matchers
+template<typename SampleType>
+class LevelTracks:
+    public Matcher<SampleType>
+{
+public:
+    /// @brief Determines how to measure the level
+    enum class Measure
+    {
+        rms,  ///< RMS level, the average energy over the window
+        peak  ///< Sample peak level over the window
+    };
+
+    /// @brief Creates a matcher for a level envelope
+    /// @param levelDb Expected level in decibels over time
+    /// @param toleranceDb Maximum deviation from the expected level, in decibels
+    /// @param windowSeconds Length of the sliding window in seconds
+    /// @param measure RMS or peak level, see @ref Measure
+    LevelTracks (const Envelope& levelDb, double toleranceDb = 1.0, double windowSeconds = 0.01, Measure measure = Measure::rms):
+        m_levelEnvelope (levelDb.copy()),
+        m_toleranceDb (toleranceDb),
+        m_windowSeconds (windowSeconds),
+        m_measure (measure)
+    {
+        if (toleranceDb < 0)
+            HART_THROW_OR_RETURN_VOID (hart::ValueError, "Tolerance cannot be negative");
+
+        if (windowSeconds <= 0)
+            HART_THROW_OR_RETURN_VOID (hart::ValueError, "Window duration must be positive");
+    }
+
+    LevelTracks (const LevelTracks& other):
+        m_levelEnvelope (other.m_levelEnvelope->copy()),
+        m_toleranceDb (other.m_toleranceDb),
+        m_windowSeconds (other.m_windowSeconds),
+        m_measure (other.m_measure),
+        m_channelMeters (other.m_channelMeters),
+        m_expectedLevelsDb (other.m_expectedLevelsDb),
+        m_expectedLevelsMask (other.m_expectedLevelsMask),
+        m_blockLevelsDb (other.m_blockLevelsDb),
+        m_sampleRateHz (other.m_sampleRateHz),
+        m_windowFrames (other.m_windowFrames),
+        m_numFramesMatched (other.m_numFramesMatched)
+    {
+    }
+
+    LevelTracks (LevelTracks&& other) = default;
+
+    void prepare (double sampleRateHz, size_t numChannels, size_t maxBlockSizeFrames) override
+    {
+        m_sampleRateHz = sampleRateHz;
+        m_windowFrames = std::max<size_t> (1, roundToSizeT (m_windowSeconds * sampleRateHz));
+
+        SlidingLevelMeter meter;
+        meter.prepare (m_windowFrames, m_measure == Measure::peak);
+        m_channelMeters.assign (numChannels, meter);
+
+        // The whole block is written before it gets checked, so the expected values are kept for as long as
+        // the window plus one block, to look up the one at the center of the window
+        const size_t ringSize = nextPowerOfTwo (m_windowFrames + maxBlockSizeFrames);
+        m_expectedLevelsDb.assign (ringSize, 0.0);
+        m_expectedLevelsMask = ringSize - 1;
+        m_blockLevelsDb.reserve (maxBlockSizeFrames);
+
+        m_levelEnvelope->prepare (sampleRateHz, maxBlockSizeFrames);
+        m_levelEnvelope->reset();
+        m_numFramesMatched = 0;
+    }
+
+    bool match (const AudioBuffer<SampleType>& observedAudio) override
+    {
+        const size_t numFrames = observedAudio.getNumFrames();
+        m_blockLevelsDb.resize (numFrames);
+        m_levelEnvelope->renderNextBlock (numFrames, m_blockLevelsDb);
+
+        for (size_t frame = 0; frame < numFrames; ++frame)
+            m_expectedLevelsDb[(m_numFramesMatched + frame) & m_expectedLevelsMask] = m_blockLevelsDb[frame];
+
+        double worstDeviationDb = 0.0;
+
+        for (size_t channel = 0; channel < observedAudio.getNumChannels() && channel < m_channelMeters.size(); ++channel)
+        {
+            SlidingLevelMeter& meter = m_channelMeters[channel];
+            const SampleType* channelFrames = observedAudio[channel];
+
+            for (size_t frame = 0; frame < numFrames; ++frame)
+            {
+                meter.push (channelFrames[frame]);
+
+                if (! meter.isWindowFull())
+                    continue;
+
+                const size_t windowCenterFrame = m_numFramesMatched + frame - (m_windowFrames - 1) / 2;
+                const double expectedLevelDb = m_expectedLevelsDb[windowCenterFrame & m_expectedLevelsMask];
+                const double observedLevelDb = meter.getLevelDb();
+                const double deviationDb = observedLevelDb - expectedLevelDb;
+
+                if (std::abs (deviationDb) > std::abs (worstDeviationDb))
+                {
+                    worstDeviationDb = deviationDb;
+                    m_failedFrame = frame;
+                    m_failedChannel = channel;
+                    m_failedTimeSeconds = windowCenterFrame / m_sampleRateHz;
+                    m_observedLevelDb = observedLevelDb;
+                    m_expectedLevelDb = expectedLevelDb;
+                }
+            }
+        }
+
+        m_numFramesMatched += numFrames;
+        return std::abs (worstDeviationDb) <= m_toleranceDb;
+    }
+
+    bool canOperatePerBlock() override
+    {
+        return true;
+    }
+
+    void reset() override
+    {
+        for (SlidingLevelMeter& meter : m_channelMeters)
+            meter.reset();
+
+        std::fill (m_expectedLevelsDb.begin(), m_expectedLevelsDb.end(), 0.0);
+        m_levelEnvelope->reset();
+        m_numFramesMatched = 0;
+    }
+
+    virtual MatcherFailureDetails getFailureDetails() const override
+    {
+        std::stringstream stream;
+        stream << (m_measure == Measure::peak ? "Peak" : "RMS") << " level is "
+            << dbPrecision << m_observedLevelDb << " dB at " << secPrecision << m_failedTimeSeconds << " seconds"
+            << ", expected " << dbPrecision << m_expectedLevelDb << " dB"
+            << " (off by " << std::showpos << m_observedLevelDb - m_expectedLevelDb << std::noshowpos << " dB)";
+
+        MatcherFailureDetails details;
+        details.frame = m_failedFrame;
+        details.channel = m_failedChannel;
+        details.description = stream.str();
+        return details;
+    }
+
+    void represent (std::ostream& stream) const override
+    {
+        stream << "LevelTracks (<Envelope>, "
+            << dbPrecision << m_toleranceDb << "_dB, "
+            << secPrecision << m_windowSeconds << "_s, "
+            << (m_measure == Measure::peak ? "Measure::peak)" : "Measure::rms)");
+    }
+
+    HART_MATCHER_DEFINE_COPY_AND_MOVE (LevelTracks);
+
+private:
+    std::unique_ptr<Envelope> m_levelEnvelope;
+    const double m_toleranceDb;
+    const double m_windowSeconds;
+    const Measure m_measure;
+    std::vector<SlidingLevelMeter> m_channelMeters;
+
+    std::vector<double> m_expectedLevelsDb;
+    size_t m_expectedLevelsMask = 0;
+    std::vector<double> m_blockLevelsDb;
+
+    double m_sampleRateHz = 0.0;
+    size_t m_windowFrames = 1;
+    size_t m_numFramesMatched = 0;
+
+    size_t m_failedFrame = 0;
+    size_t m_failedChannel = 0;
+    double m_failedTimeSeconds = 0.0;
+    double m_observedLevelDb = 0.0;
+    double m_expectedLevelDb = 0.0;
+};
+
+}  // namespace hart
@@ -78,6 +78,13 @@ public:
     /// @see MatcherFailureDetails
     virtual MatcherFailureDetails getFailureDetails() const = 0;
 
+    /// @brief Gives the host the reference audio for the last block passed to match()
+    /// @details Matchers that compare audio to some reference signal, like @ref EqualsTo, can override it,
+    /// so that the host can save the reference along with the output when the test fails.
+    /// @note This method is a callback for the test host, so you probably don't need to call it yourself ever.
+    /// @return Pointer to the reference audio, or nullptr if the matcher has none
+    virtual const AudioBuffer<SampleType>* getReferenceAudio() const { return nullptr; }
+
     /// @brief Makes a text representation of this Macther for test failure outputs.
     /// @details It is strongly encouraged to follow python's
     /// <a href="https://docs.python.org/3/reference/datamodel.html#object.__repr__" target="_blank">repr()</a>
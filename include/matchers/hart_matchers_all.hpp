@@ -1,5 +1,19 @@
 #pragma once
 
+#include "matchers/hart_aliasingbelow.hpp"
 #include "matchers/hart_equalsto.hpp"
+#include "matchers/hart_frequencyresponsewithin.hpp"
+#include "matchers/hart_frequencytracks.hpp"
+#include "matchers/hart_fundamentalfrequencyat.hpp"
+#include "matchers/hart_groupdelaybelow.hpp"
+#include "matchers/hart_isfinite.hpp"
+#include "matchers/hart_leveltracks.hpp"
+#include "matchers/hart_midsideratiowithin.hpp"
 #include "matchers/hart_peaksat.hpp"
 #include "matchers/hart_peaksbelow.hpp"
+#include "matchers/hart_phaseresponsewithin.hpp"
+#include "matchers/hart_polarityinverted.hpp"
+#include "matchers/hart_response_mask.hpp"
+#include "matchers/hart_stereo_matcher.hpp"
+#include "matchers/hart_stereobalancewithin.hpp"
+#include "matchers/hart_stereocorrelationwithin.hpp"
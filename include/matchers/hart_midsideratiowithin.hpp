@@ -0,0 +1,75 @@
+#pragma once
+
+#include <ostream>
+
+#include "hart_exceptions.hpp"
+#include "hart_precision.hpp"
+#include "matchers/hart_stereo_matcher.hpp"
+
+namespace hart
+{
+
+/// @brief Checks whether the energy of the mid channel relative to the side channel stays within a range
+/// @details Mid channel is (L + R) / 2, and side channel is (L - R) / 2. The ratio is 120 dB for a mono signal,
+/// around 0 dB for two unrelated channels, and -120 dB for the channels of opposite polarity. It's measured over
+/// consecutive windows, and each window should be within the range. The windows where both channels are silent
+/// are skipped. For example, to check that a stereo widener doesn't push the side channel over the mid one:
+/// @code
+/// processAudioWith (MyStereoWidener())
+///     .withInputSignal (WhiteNoise())
+///     .withOutputChannels (2)
+///     .expectTrue (MidSideRatioWithin (0_dB, oo_dB))
+///     .process();
+/// @endcode
+/// @see StereoCorrelationWithin, StereoBalanceWithin
+/// @ingroup Matchers
+template<typename SampleType>
+class MidSideRatioWithin:
+    public StereoMatcher<SampleType>
+{
+public:
+    /// @brief Creates a matcher for a range of mid to side ratio
+    /// @param minDb Lowest expected energy of the mid channel relative to the side channel, in decibels
+    /// @param maxDb Highest expected energy of the mid channel relative to the side channel, in decibels
+    /// @param windowSeconds Length of each window in seconds
+    MidSideRatioWithin (double minDb, double maxDb, double windowSeconds = 0.05):
+        StereoMatcher<SampleType> (windowSeconds),
+        m_minDb (minDb),
+        m_maxDb (maxDb)
+    {
+        if (minDb > maxDb)
+            HART_THROW_OR_RETURN_VOID (hart::ValueError, "Min ratio cannot be above max ratio");
+    }
+
+    void represent (std::ostream& stream) const override
+    {
+        stream << "MidSideRatioWithin ("
+            << dbPrecision << m_minDb << "_dB, "
+            << m_maxDb << "_dB, "
+            << secPrecision << this->m_windowSeconds << "_s)";
+    }
+
+    HART_MATCHER_DEFINE_COPY_AND_MOVE (MidSideRatioWithin);
+
+protected:
+    bool isWithin (const StereoMeter& meter) override
+    {
+        if (meter.isLeftSilent() && meter.isRightSilent())
+            return true;
+
+        m_observedRatioDb = meter.getMidSideRatioDb();
+        return m_observedRatioDb >= m_minDb && m_observedRatioDb <= m_maxDb;
+    }
+
+    void describeFailure (std::ostream& stream) const override
+    {
+        stream << "Mid to side ratio is " << dbPrecision << m_observedRatioDb << " dB";
+    }
+
+private:
+    const double m_minDb;
+    const double m_maxDb;
+    double m_observedRatioDb = 0.0;
+};
+
+}  // namespace hart
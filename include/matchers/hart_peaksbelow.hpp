@@ -1,5 +1,6 @@
 #pragma once
 
+#include <algorithm>  // min()
 #include <cmath>  // abs()
 #include <iomanip>
 #include <sstream>
@@ -35,9 +36,13 @@ public:
 
     bool match (const AudioBuffer<SampleType>& observedAudio) override
     {
-        for (size_t channel = 0; channel < observedAudio.getNumChannels(); ++channel)
+        // All frames of a constant block are the same, so the first one tells it all
+        const size_t numChannels = observedAudio.isConstant() ? std::min<size_t> (1, observedAudio.getNumChannels()) : observedAudio.getNumChannels();
+        const size_t numFrames = observedAudio.isConstant() ? std::min<size_t> (1, observedAudio.getNumFrames()) : observedAudio.getNumFrames();
+
+        for (size_t channel = 0; channel < numChannels; ++channel)
         {
-            for (size_t frame = 0; frame < observedAudio.getNumFrames(); ++frame)
+            for (size_t frame = 0; frame < numFrames; ++frame)
             {
                 const SampleType observedPeakLinear = std::abs (observedAudio[channel][frame]);
 
@@ -0,0 +1,114 @@
+#pragma once
+
+#include <sstream>
+
+#include "matchers/hart_matcher.hpp"
+#include "matchers/hart_response_mask.hpp"
+#include "hart_precision.hpp"
+#include "signals/hart_sine_sweep.hpp"
+#include "hart_sweep_response.hpp"
+
+namespace hart
+{
+
+/// @brief Checks whether the phase response of the effect stays within a mask
+/// @details Measures the response from the output of the effect for a sine sweep, the same way
+/// @ref FrequencyResponseWithin does, so feed the same sweep to the effect. The phase is in -pi..pi range,
+/// and it's relative to the start of the sweep, so any latency of the effect shows up as phase that keeps
+/// going down with frequency, wrapping around as it goes. Frequencies where the response is more than 60 dB
+/// below its peak are skipped, as the phase there is mostly noise.
+/// @see ResponseMask, GroupDelayBelow
+/// @ingroup Matchers
+template<typename SampleType>
+class PhaseResponseWithin:
+    public Matcher<SampleType>
+{
+public:
+    /// @brief Creates a matcher for a phase response mask
+    /// @param sweep Sweep that the tested effect gets as an input
+    /// @param maskRadians Limits of the phase response in radians
+    PhaseResponseWithin (const SineSweep<SampleType>& sweep, const ResponseMask& maskRadians):
+        m_response (sweep),
+        m_maskRadians (maskRadians)
+    {
+    }
+
+    void prepare (double sampleRateHz, size_t /* numChannels */, size_t /* maxBlockSizeFrames */) override
+    {
+        m_response.prepare (sampleRateHz);
+    }
+
+    bool match (const AudioBuffer<SampleType>& observedAudio) override
+    {
+        for (size_t channel = 0; channel < observedAudio.getNumChannels(); ++channel)
+        {
+            m_failedChannel = channel;
+            m_isTooShort = ! m_response.measure (observedAudio[channel], observedAudio.getNumFrames());
+
+            if (m_isTooShort)
+                return false;
+
+            const auto getPhaseRadians = [this] (size_t bin) { return m_response.getPhaseRadians (bin); };
+
+            if (! m_response.isWithin (m_maskRadians, getPhaseRadians, true, m_failedBin, m_failedBand))
+            {
+                m_failedFrequencyHz = m_response.getBinFrequencyHz (m_failedBin);
+                m_failedPhaseRadians = m_response.getPhaseRadians (m_failedBin);
+                return false;
+            }
+        }
+
+        return true;
+    }
+
+    bool canOperatePerBlock() override
+    {
+        return false;
+    }
+
+    void reset() override {}
+
+    virtual MatcherFailureDetails getFailureDetails() const override
+    {
+        std::stringstream stream;
+        MatcherFailureDetails details;
+        details.channel = m_failedChannel;
+
+        if (m_isTooShort)
+        {
+            stream << "Audio is shorter than the sweep";
+        }
+        else
+        {
+            details.frame = m_response.getFrameOfFrequency (m_failedFrequencyHz);
+            stream << "Phase response is " << radPrecision << m_failedPhaseRadians << " rad"
+                << " at " << hzPrecision << m_failedFrequencyHz << " Hz"
+                << ", expected between " << radPrecision << m_failedBand.minValue << " rad and " << m_failedBand.maxValue << " rad";
+        }
+
+        details.description = stream.str();
+        return details;
+    }
+
+    void represent (std::ostream& stream) const override
+    {
+        stream << "PhaseResponseWithin (" << m_response.getSweep() << ", ";
+        m_maskRadians.represent (stream, radPrecision, "_rad");
+        stream << ')';
+    }
+
+    HART_MATCHER_DEFINE_COPY_AND_MOVE (PhaseResponseWithin);
+
+private:
+    SweepResponse<SampleType> m_response;
+    const ResponseMask m_maskRadians;
+
+    bool m_isTooShort = false;
+    size_t m_failedChannel = 0;
+    size_t m_failedBin = 0;
+    ResponseMask::Band m_failedBand {};
+    double m_failedFrequencyHz = 0.0;
+    double m_failedPhaseRadians = 0.0;
+};
+
+}  // namespace hart
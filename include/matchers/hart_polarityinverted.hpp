@@ -0,0 +1,71 @@
+#pragma once
+
+#include <ostream>
+
+#include "hart_exceptions.hpp"
+#include "hart_precision.hpp"
+#include "matchers/hart_stereo_matcher.hpp"
+
+namespace hart
+{
+
+/// @brief Checks whether one of the stereo channels has its polarity inverted relative to the other one
+/// @details The channels count as inverted if their correlation is at or below the threshold, see
+/// @ref StereoCorrelationWithin. It's measured over consecutive windows, and each window should be inverted for the
+/// match to pass. The windows where either channel is silent are skipped. Flipped polarity of one channel is a common
+/// bug, and it makes the whole signal inverted, so it's easy to catch like this:
+/// @code
+/// processAudioWith (MyStereoEffect())
+///     .withInputSignal (SineWave())
+///     .withOutputChannels (2)
+///     .expectFalse (PolarityInverted())
+///     .process();
+/// @endcode
+/// @see StereoCorrelationWithin
+/// @ingroup Matchers
+template<typename SampleType>
+class PolarityInverted:
+    public StereoMatcher<SampleType>
+{
+public:
+    /// @brief Creates a polarity inversion matcher
+    /// @param maxCorrelation Correlation at or below which the channels count as inverted, from -1 to 0
+    /// @param windowSeconds Length of each window in seconds
+    PolarityInverted (double maxCorrelation = -0.9, double windowSeconds = 0.05):
+        StereoMatcher<SampleType> (windowSeconds),
+        m_maxCorrelation (maxCorrelation)
+    {
+        if (maxCorrelation < -1.0 || maxCorrelation > 0.0)
+            HART_THROW_OR_RETURN_VOID (hart::ValueError, "Correlation threshold should be between -1 and 0");
+    }
+
+    void represent (std::ostream& stream) const override
+    {
+        stream << "PolarityInverted ("
+            << linPrecision << m_maxCorrelation << ", "
+            << secPrecision << this->m_windowSeconds << "_s)";
+    }
+
+    HART_MATCHER_DEFINE_COPY_AND_MOVE (PolarityInverted);
+
+protected:
+    bool isWithin (const StereoMeter& meter) override
+    {
+        if (meter.isLeftSilent() || meter.isRightSilent())
+            return true;
+
+        m_observedCorrelation = meter.getCorrelation();
+        return m_observedCorrelation <= m_maxCorrelation;
+    }
+
+    void describeFailure (std::ostream& stream) const override
+    {
+        stream << "Polarity is not inverted, correlation is " << linPrecision << m_observedCorrelation;
+    }
+
+private:
+    const double m_maxCorrelation;
+    double m_observedCorrelation = 0.0;
+};
+
+}  // namespace hart
@@ -0,0 +1,74 @@
+#pragma once
+
+#include <ostream>
+#include <vector>
+
+#include "hart_exceptions.hpp"
+#include "hart_precision.hpp"
+
+namespace hart
+{
+
+/// @brief Limits for a frequency or phase response, band by band
+/// @details Used by matchers like @ref FrequencyResponseWithin and @ref PhaseResponseWithin. The units of the limits
+/// depend on the matcher, e.g. decibels for magnitude and radians for phase. Frequencies outside of all the bands are
+/// not checked, and if the bands overlap, the response has to be within the limits of each of them. Example:
+/// @code
+/// ResponseMask()
+///     .withBand (20_Hz, 10_kHz, -0.5_dB, 0.5_dB)
+///     .withBand (15_kHz, 20_kHz, -120_dB, -40_dB)
+/// @endcode
+/// @ingroup Matchers
+class ResponseMask
+{
+public:
+    /// @brief Frequency range with its limits
+    struct Band
+    {
+        double startHz;  ///< Lowest frequency of the band
+        double endHz;  ///< Highest frequency of the band
+        double minValue;  ///< Lowest allowed value
+        double maxValue;  ///< Highest allowed value
+    };
+
+    /// @brief Adds a band to the mask
+    /// @param startHz Lowest frequency of the band
+    /// @param endHz Highest frequency of the band
+    /// @param minValue Lowest allowed value within the band
+    /// @param maxValue Highest allowed value within the band
+    /// @return Reference to itself for chaining
+    ResponseMask& withBand (double startHz, double endHz, double minValue, double maxValue)
+    {
+        if (startHz < 0 || endHz < startHz)
+            HART_THROW_OR_RETURN (hart::ValueError, "Invalid frequency range of the band", *this);
+
+        if (maxValue < minValue)
+            HART_THROW_OR_RETURN (hart::ValueError, "Invalid limits of the band", *this);
+
+        m_bands.push_back ({ startHz, endHz, minValue, maxValue });
+        return *this;
+    }
+
+    const std::vector<Band>& getBands() const { return m_bands; }
+
+    /// @brief Makes a text representation of the mask for test failure outputs
+    /// @param stream Output stream to write to
+    /// @param valuePrecision Precision manipulator for the limits, like @ref dbPrecision
+    /// @param valueUnit Unit literal for the limits, like "_dB"
+    void represent (std::ostream& stream, std::ostream& (*valuePrecision) (std::ostream&), const char* valueUnit) const
+    {
+        stream << "ResponseMask()";
+
+        for (const Band& band : m_bands)
+        {
+            stream << ".withBand ("
+                << hzPrecision << band.startHz << "_Hz, " << band.endHz << "_Hz, "
+                << valuePrecision << band.minValue << valueUnit << ", " << band.maxValue << valueUnit << ')';
+        }
+    }
+
+private:
+    std::vector<Band> m_bands;
+};
+
+}  // namespace hart
@@ -0,0 +1,126 @@
+#pragma once
+
+#include <ostream>
+#include <sstream>
+
+#include "hart_exceptions.hpp"
+#include "matchers/hart_matcher.hpp"
+#include "hart_precision.hpp"
+#include "hart_stereo_meter.hpp"
+
+namespace hart
+{
+
+/// @brief Base class for the matchers that check the stereo image, like @ref StereoCorrelationWithin
+/// @details Splits the audio into consecutive windows, measures each one with a @ref StereoMeter, and checks them
+/// one by one as soon as they are complete, so the matchers can work per block without keeping any of the audio.
+/// The audio is expected to have exactly two channels, left and right. If the audio ends in the middle of a window,
+/// that last window doesn't get checked, so make sure the audio is at least one window long.
+/// The derived classes only override @ref isWithin() to check a complete window, and @ref describeFailure() to describe
+/// the value it has failed on.
+/// @private
+template<typename SampleType>
+class StereoMatcher:
+    public Matcher<SampleType>
+{
+public:
+    /// @param windowSeconds Length of each window in seconds
+    StereoMatcher (double windowSeconds):
+        m_windowSeconds (windowSeconds),
+        m_meter (windowSeconds)
+    {
+    }
+
+    void prepare (double sampleRateHz, size_t numChannels, size_t /* maxBlockSizeFrames */) override
+    {
+        m_sampleRateHz = sampleRateHz;
+        m_numChannels = numChannels;
+        m_meter.prepare (sampleRateHz);
+        m_numFramesMatched = 0;
+    }
+
+    bool match (const AudioBuffer<SampleType>& observedAudio) override
+    {
+        if (observedAudio.getNumChannels() != 2)
+        {
+            m_numChannels = observedAudio.getNumChannels();
+            m_failedFrame = 0;
+            return false;
+        }
+
+        const size_t numFrames = observedAudio.getNumFrames();
+        size_t frame = 0;
+
+        while (frame < numFrames)
+        {
+            frame += m_meter.push (observedAudio[0] + frame, observedAudio[1] + frame, numFrames - frame);
+
+            if (! m_meter.isWindowComplete())
+                break;
+
+            if (! isWithin (m_meter))
+            {
+                m_failedFrame = frame - 1;
+                m_failedWindowStartSeconds = (double) (m_numFramesMatched + frame - m_meter.getWindowFrames()) / m_sampleRateHz;
+                return false;
+            }
+
+            m_meter.startNextWindow();
+        }
+
+        m_numFramesMatched += numFrames;
+        return true;
+    }
+
+    bool canOperatePerBlock() override
+    {
+        return true;
+    }
+
+    void reset() override
+    {
+        m_meter.reset();
+        m_numFramesMatched = 0;
+    }
+
+    virtual MatcherFailureDetails getFailureDetails() const override
+    {
+        std::stringstream stream;
+
+        if (m_numChannels != 2)
+        {
+            stream << "Expected stereo audio, got " << m_numChannels << " channel(s)";
+        }
+        else
+        {
+            describeFailure (stream);
+            stream << " in the window starting at " << secPrecision << m_failedWindowStartSeconds << " seconds";
+        }
+
+        MatcherFailureDetails details;
+        details.frame = m_failedFrame;
+        details.channel = 0;
+        details.description = stream.str();
+        return details;
+    }
+
+protected:
+    const double m_windowSeconds;
+
+    /// @brief Checks a complete window
+    virtual bool isWithin (const StereoMeter& meter) = 0;
+
+    /// @brief Describes the value measured in the window that has failed the check
+    virtual void describeFailure (std::ostream& stream) const = 0;
+
+private:
+    StereoMeter m_meter;
+    double m_sampleRateHz = 0.0;
+    size_t m_numChannels = 2;
+    size_t m_numFramesMatched = 0;
+
+    size_t m_failedFrame = 0;
+    double m_failedWindowStartSeconds = 0.0;
+};
+
+}  // namespace hart
@@ -0,0 +1,75 @@
+#pragma once
+
+#include <ostream>
+
+#include "hart_exceptions.hpp"
+#include "hart_precision.hpp"
+#include "matchers/hart_stereo_matcher.hpp"
+
+namespace hart
+{
+
+/// @brief Checks whether the balance of the left and right channels stays within a range
+/// @details Balance is the RMS level of the right channel relative to the left one, so it's positive if the right
+/// channel is louder, and negative if the left one is. It's measured over consecutive windows, and each window should
+/// be within the range. The windows where both channels are silent are skipped, and a single silent channel
+/// counts as -120 dB or 120 dB. For example, to check a panner set to a hard left:
+/// @code
+/// processAudioWith (MyPanner (-1.0))
+///     .withInputSignal (WhiteNoise())
+///     .withOutputChannels (2)
+///     .expectTrue (StereoBalanceWithin (-oo_dB, -60_dB))
+///     .process();
+/// @endcode
+/// @see StereoCorrelationWithin, MidSideRatioWithin
+/// @ingroup Matchers
+template<typename SampleType>
+class StereoBalanceWithin:
+    public StereoMatcher<SampleType>
+{
+public:
+    /// @brief Creates a matcher for a range of balance
+    /// @param minDb Lowest expected level of the right channel relative to the left one, in decibels
+    /// @param maxDb Highest expected level of the right channel relative to the left one, in decibels
+    /// @param windowSeconds Length of each window in seconds
+    StereoBalanceWithin (double minDb, double maxDb, double windowSeconds = 0.05):
+        StereoMatcher<SampleType> (windowSeconds),
+        m_minDb (minDb),
+        m_maxDb (maxDb)
+    {
+        if (minDb > maxDb)
+            HART_THROW_OR_RETURN_VOID (hart::ValueError, "Min balance cannot be above max balance");
+    }
+
+    void represent (std::ostream& stream) const override
+    {
+        stream << "StereoBalanceWithin ("
+            << dbPrecision << m_minDb << "_dB, "
+            << m_maxDb << "_dB, "
+            << secPrecision << this->m_windowSeconds << "_s)";
+    }
+
+    HART_MATCHER_DEFINE_COPY_AND_MOVE (StereoBalanceWithin);
+
+protected:
+    bool isWithin (const StereoMeter& meter) override
+    {
+        if (meter.isLeftSilent() && meter.isRightSilent())
+            return true;
+
+        m_observedBalanceDb = meter.getBalanceDb();
+        return m_observedBalanceDb >= m_minDb && m_observedBalanceDb <= m_maxDb;
+    }
+
+    void describeFailure (std::ostream& stream) const override
+    {
+        stream << "Balance is " << dbPrecision << m_observedBalanceDb << " dB";
+    }
+
+private:
+    const double m_minDb;
+    const double m_maxDb;
+    double m_observedBalanceDb = 0.0;
+};
+
+}  // namespace hart
@@ -0,0 +1,75 @@
+#pragma once
+
+#include <ostream>
+
+#include "hart_exceptions.hpp"
+#include "hart_precision.hpp"
+#include "matchers/hart_stereo_matcher.hpp"
+
+namespace hart
+{
+
+/// @brief Checks whether the correlation of the left and right channels stays within a range
+/// @details Correlation coefficient is 1 for identical channels, 0 for unrelated ones, like two different noises,
+/// and -1 for the channels of opposite polarity, same as on a correlation meter. It's measured over consecutive
+/// windows, and each window should be within the range. The windows where either channel is silent are skipped.
+/// For example, to check that the effect stays mono compatible:
+/// @code
+/// processAudioWith (MyStereoWidener())
+///     .withInputSignal (WhiteNoise())
+///     .withOutputChannels (2)
+///     .expectTrue (StereoCorrelationWithin (0.0, 1.0))
+///     .process();
+/// @endcode
+/// @see StereoBalanceWithin, MidSideRatioWithin, PolarityInverted
+/// @ingroup Matchers
+template<typename SampleType>
+class StereoCorrelationWithin:
+    public StereoMatcher<SampleType>
+{
+public:
+    /// @brief Creates a matcher for a range of correlation
+    /// @param minCorrelation Lowest expected correlation, from -1 to 1
+    /// @param maxCorrelation Highest expected correlation, from -1 to 1
+    /// @param windowSeconds Length of each window in seconds
+    StereoCorrelationWithin (double minCorrelation, double maxCorrelation = 1.0, double windowSeconds = 0.05):
+        StereoMatcher<SampleType> (windowSeconds),
+        m_minCorrelation (minCorrelation),
+        m_maxCorrelation (maxCorrelation)
+    {
+        if (minCorrelation > maxCorrelation)
+            HART_THROW_OR_RETURN_VOID (hart::ValueError, "Min correlation cannot be above max correlation");
+    }
+
+    void represent (std::ostream& stream) const override
+    {
+        stream << "StereoCorrelationWithin ("
+            << linPrecision << m_minCorrelation << ", "
+            << m_maxCorrelation << ", "
+            << secPrecision << this->m_windowSeconds << "_s)";
+    }
+
+    HART_MATCHER_DEFINE_COPY_AND_MOVE (StereoCorrelationWithin);
+
+protected:
+    bool isWithin (const StereoMeter& meter) override
+    {
+        if (meter.isLeftSilent() || meter.isRightSilent())
+            return true;
+
+        m_observedCorrelation = meter.getCorrelation();
+        return m_observedCorrelation >= m_minCorrelation && m_observedCorrelation <= m_maxCorrelation;
+    }
+
+    void describeFailure (std::ostream& stream) const override
+    {
+        stream << "Correlation is " << linPrecision << m_observedCorrelation;
+    }
+
+private:
+    const double m_minCorrelation;
+    const double m_maxCorrelation;
+    double m_observedCorrelation = 0.0;
+};
+
+}  // namespace hart
@@ -0,0 +1,89 @@
+#pragma once
+
+#include <cmath>
+#include <cstdint>
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "hart_cliconfig.hpp"
+#include "signals/hart_signal.hpp"
+#include "hart_utils.hpp"
+
+namespace hart
+{
+
+/// @brief Produces deterministic brown (red) noise
+/// @details Integrates white noise with a leaky integrator, which gives a -6dB/octave slope down to 20Hz,
+/// and flat spectrum below that, so it doesn't wander away into DC. The level doesn't depend on the sample rate,
+/// and its RMS is about 17dB below full scale, so in practice it peaks well below 0dB.
+/// Each channel gets its own noise.
+/// @ingroup Signals
+template<typename SampleType>
+class BrownNoise : public Signal<SampleType>
+{
+public:
+
+    /// @brief Creates a Signal that produces brown noise
+    /// @param randomSeed Seed for the RNG
+    /// @details Two signals with the same seed are guaranteed to produce the identical audio
+    BrownNoise (uint_fast32_t randomSeed = CLIConfig::getInstance().getRandomSeed()):
+        m_randomSeed (randomSeed)
+    {
+        reset();
+    }
+
+    bool supportsNumChannels (size_t /* numChannels */) const override { return true; };
+
+    void prepare (double sampleRateHz, size_t numOutputChannels, size_t /*maxBlockSizeFrames*/) override
+    {
+        this->setNumChannels (numOutputChannels);
+        m_feedback = std::exp (-hart::twoPi * cornerFrequencyHz / sampleRateHz);
+
+        // Keeps the RMS at a quarter of the RMS of the white noise it's made of
+        m_outputGain = 0.25 * std::sqrt ((1.0 + m_feedback) / (1.0 - m_feedback));
+        reset();
+    }
+
+    void renderNextBlock (AudioBuffer<SampleType>& output) override
+    {
+        for (size_t frame = 0; frame < output.getNumFrames(); ++frame)
+        {
+            for (size_t channel = 0; channel < this->getNumChannels(); ++channel)
+            {
+                const double white = m_uniformRealDistribution (m_randomNumberGenerator);
+                m_states[channel] = m_feedback * m_states[channel] + (1.0 - m_feedback) * white;
+                output[channel][frame] = static_cast<SampleType> (m_outputGain * m_states[channel]);
+            }
+        }
+    }
+
+    /// @copybrief Signal::reset()
+    /// @details After resetting, BrownNoise is guaranteed to produce identical audio to the one produced after instantiation
+    void reset() override
+    {
+        m_randomNumberGenerator = std::mt19937 (m_randomSeed);
+        m_uniformRealDistribution.reset();
+        m_states.assign (this->getNumChannels(), 0.0);
+    }
+
+    void represent (std::ostream& stream) const override
+    {
+        stream << "BrownNoise (" << m_randomSeed << ")";
+    }
+
+    HART_SIGNAL_DEFINE_COPY_AND_MOVE (BrownNoise);
+
+private:
+    static constexpr double cornerFrequencyHz = 20.0;
+
+    const uint_fast32_t m_randomSeed;
+    std::mt19937 m_randomNumberGenerator;
+    std::uniform_real_distribution<double> m_uniformRealDistribution {-1.0, 1.0};
+    double m_feedback = 0.0;
+    double m_outputGain = 0.0;
+    std::vector<double> m_states;
+};
+
+}  // namespace hart
@@ -0,0 +1,76 @@
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <random>
+#include <string>
+
+#include "hart_cliconfig.hpp"
+#include "hart_exceptions.hpp"
+#include "hart_precision.hpp"
+#include "signals/hart_signal.hpp"
+
+namespace hart
+{
+
+/// @brief Produces deterministic white noise with normal distribution
+/// @details Unlike @ref WhiteNoise, its peaks are not bounded, so with large standard deviations
+/// expect some samples to go above 0dB. Each channel gets its own noise.
+/// @ingroup Signals
+template<typename SampleType>
+class GaussianNoise : public Signal<SampleType>
+{
+public:
+
+    /// @brief Creates a Signal that produces gaussian noise
+    /// @param standardDeviation Standard deviation, which is also the RMS value of the noise (linear, not dB)
+    /// @param randomSeed Seed for the RNG
+    /// @details Two signals with the same seed are guaranteed to produce the identical audio
+    GaussianNoise (double standardDeviation = 0.25, uint_fast32_t randomSeed = CLIConfig::getInstance().getRandomSeed()):
+        m_standardDeviation (standardDeviation),
+        m_randomSeed (randomSeed),
+        m_normalDistribution ((SampleType) 0, (SampleType) standardDeviation)
+    {
+        if (standardDeviation <= 0)
+            HART_THROW (hart::ValueError, "Standard deviation should be a positive value");
+
+        reset();
+    }
+
+    bool supportsNumChannels (size_t /* numChannels */) const override { return true; };
+
+    void prepare (double /*sampleRateHz*/, size_t numOutputChannels, size_t /*maxBlockSizeFrames*/) override
+    {
+        this->setNumChannels (numOutputChannels);
+    }
+
+    void renderNextBlock (AudioBuffer<SampleType>& output) override
+    {
+        for (size_t frame = 0; frame < output.getNumFrames(); ++frame)
+            for (size_t channel = 0; channel < this->getNumChannels(); ++channel)
+                output[channel][frame] = m_normalDistribution (m_randomNumberGenerator);
+    }
+
+    /// @copybrief Signal::reset()
+    /// @details After resetting, GaussianNoise is guaranteed to produce identical audio to the one produced after instantiation
+    void reset() override
+    {
+        m_randomNumberGenerator = std::mt19937 (m_randomSeed);
+        m_normalDistribution.reset();
+    }
+
+    void represent (std::ostream& stream) const override
+    {
+        stream << "GaussianNoise (" << linPrecision << m_standardDeviation << ", " << m_randomSeed << ")";
+    }
+
+    HART_SIGNAL_DEFINE_COPY_AND_MOVE (GaussianNoise);
+
+private:
+    const double m_standardDeviation;
+    const uint_fast32_t m_randomSeed;
+    std::mt19937 m_randomNumberGenerator;
+    std::normal_distribution<SampleType> m_normalDistribution;
+};
+
+}  // namespace hart
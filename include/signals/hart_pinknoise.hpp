@@ -0,0 +1,120 @@
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "hart_cliconfig.hpp"
+#include "signals/hart_signal.hpp"
+
+namespace hart
+{
+
+/// @brief Produces deterministic pink noise
+/// @details Uses Voss-McCartney algorithm: a sum of a white noise source updated every frame, and a number of rows
+/// of white noise held for 2, 4, 8 and so on frames. That gives a -3dB/octave slope from Nyquist
+/// down to about 1/65536th of the sample rate (0.7Hz at 44.1kHz), and flat spectrum below that.
+/// The sum is normalized, so the signal peaks below 0dB, and its RMS is about 17dB below full scale.
+/// Each channel gets its own noise.
+/// @ingroup Signals
+template<typename SampleType>
+class PinkNoise : public Signal<SampleType>
+{
+public:
+
+    /// @brief Creates a Signal that produces pink noise
+    /// @param randomSeed Seed for the RNG
+    /// @details Two signals with the same seed are guaranteed to produce the identical audio
+    PinkNoise (uint_fast32_t randomSeed = CLIConfig::getInstance().getRandomSeed()):
+        m_randomSeed (randomSeed)
+    {
+        reset();
+    }
+
+    bool supportsNumChannels (size_t /* numChannels */) const override { return true; };
+
+    void prepare (double /*sampleRateHz*/, size_t numOutputChannels, size_t /*maxBlockSizeFrames*/) override
+    {
+        this->setNumChannels (numOutputChannels);
+        reset();
+    }
+
+    void renderNextBlock (AudioBuffer<SampleType>& output) override
+    {
+        for (size_t frame = 0; frame < output.getNumFrames(); ++frame)
+        {
+            // Row n gets updated every 2^(n+1) frames, and they never get updated on the same frame
+            ++m_frameCounter;
+            const size_t rowToUpdate = countTrailingZeros (m_frameCounter);
+
+            for (size_t channel = 0; channel < this->getNumChannels(); ++channel)
+            {
+                if (rowToUpdate < numRows)
+                {
+                    double& row = m_rows[channel * numRows + rowToUpdate];
+                    const double newValue = m_uniformRealDistribution (m_randomNumberGenerator);
+                    m_rowSums[channel] += newValue - row;
+                    row = newValue;
+                }
+
+                const double white = m_uniformRealDistribution (m_randomNumberGenerator);
+                output[channel][frame] = static_cast<SampleType> ((m_rowSums[channel] + white) / (numRows + 1));
+            }
+        }
+    }
+
+    /// @copybrief Signal::reset()
+    /// @details After resetting, PinkNoise is guaranteed to produce identical audio to the one produced after instantiation
+    void reset() override
+    {
+        m_randomNumberGenerator = std::mt19937 (m_randomSeed);
+        m_uniformRealDistribution.reset();
+        m_frameCounter = 0;
+        m_rows.assign (this->getNumChannels() * numRows, 0.0);
+        m_rowSums.assign (this->getNumChannels(), 0.0);
+
+        // Starting with all the rows at zero would make the first few thousand frames noticeably quieter
+        for (size_t channel = 0; channel < this->getNumChannels(); ++channel)
+        {
+            for (size_t row = 0; row < numRows; ++row)
+            {
+                m_rows[channel * numRows + row] = m_uniformRealDistribution (m_randomNumberGenerator);
+                m_rowSums[channel] += m_rows[channel * numRows + row];
+            }
+        }
+    }
+
+    void represent (std::ostream& stream) const override
+    {
+        stream << "PinkNoise (" << m_randomSeed << ")";
+    }
+
+    HART_SIGNAL_DEFINE_COPY_AND_MOVE (PinkNoise);
+
+private:
+    static constexpr size_t numRows = 16;
+
+    const uint_fast32_t m_randomSeed;
+    std::mt19937 m_randomNumberGenerator;
+    std::uniform_real_distribution<double> m_uniformRealDistribution {-1.0, 1.0};
+    uint_fast32_t m_frameCounter = 0;
+    std::vector<double> m_rows;
+    std::vector<double> m_rowSums;
+
+    static size_t countTrailingZeros (uint_fast32_t value)
+    {
+        size_t numZeros = 0;
+
+        while ((value & 1) == 0 && numZeros < numRows)
+        {
+            value >>= 1;
+            ++numZeros;
+        }
+
+        return numZeros;
+    }
+};
+
+}  // namespace hart
@@ -0,0 +1,142 @@
+#pragma once
+
+#include <algorithm>  // copy()
+#include <cmath>
+
+#include "hart_exceptions.hpp"
+#include "signals/hart_signal.hpp"
+#include "hart_utils.hpp"
+
+namespace hart
+{
+
+/// @brief Base class for the band-limited oscillators like @ref Saw or @ref Square
+/// @details Takes care of the phase, and leaves the waveform to the derived class, which should define
+/// @code
+/// double getValue (double phase, double phaseIncrement) const;
+/// @endcode
+/// where both values are in cycles, not radians, and @c phase is in 0..1 range. Naive waveforms alias a lot,
+/// so the derived classes smooth out each of their jumps with @ref polyBlep() and each of their corners with
+/// @ref polyBlamp(). Same as @ref SineWave, phase of zero means starting at zero and heading up.
+/// The waveform is calculated once per frame, and then copied to all the channels.
+/// @tparam Derived The derived class itself (CRTP), so that the per-frame calls don't have to be virtual
+/// @private
+template<typename SampleType, typename Derived>
+class PolyBLEPOscillator:
+    public Signal<SampleType>
+{
+public:
+    /// @param frequencyHz Frequency in Hz, must be below Nyquist at the sample rate of the test
+    /// @param phaseRadians Initial phase in radians
+    PolyBLEPOscillator (double frequencyHz, double phaseRadians):
+        m_frequencyHz (frequencyHz),
+        m_initialPhaseRadians (phaseRadians),
+        m_initialPhase (wrapCycles (wrapPhase (phaseRadians) / hart::twoPi))
+    {
+        if (frequencyHz <= 0)
+            HART_THROW (hart::ValueError, "Invalid frequency value");
+
+        reset();
+    }
+
+    bool supportsNumChannels (size_t /* numChannels */) const override { return true; };
+
+    bool supportsSampleRate (double sampleRateHz) const override
+    {
+        return m_frequencyHz < sampleRateHz / 2;
+    }
+
+    void prepare (double sampleRateHz, size_t /* numOutputChannels */, size_t /*maxBlockSizeFrames*/) override
+    {
+        if (! supportsSampleRate (sampleRateHz))
+            HART_THROW_OR_RETURN_VOID (hart::SampleRateError, "Oscillator frequency should be below Nyquist frequency");
+
+        m_phaseIncrement = m_frequencyHz / sampleRateHz;
+    }
+
+    void renderNextBlock (AudioBuffer<SampleType>& output) override
+    {
+        const size_t numFrames = output.getNumFrames();
+
+        if (output.getNumChannels() == 0 || numFrames == 0)
+            return;
+
+        SampleType* const* channels = output.getArrayOfWritePointers();
+        const Derived& waveform = static_cast<const Derived&> (*this);
+
+        for (size_t frame = 0; frame < numFrames; ++frame)
+        {
+            channels[0][frame] = static_cast<SampleType> (waveform.getValue (m_phase, m_phaseIncrement));
+            m_phase += m_phaseIncrement;
+
+            if (m_phase >= 1.0)
+                m_phase -= 1.0;
+        }
+
+        for (size_t channel = 1; channel < output.getNumChannels(); ++channel)
+            std::copy (channels[0], channels[0] + numFrames, channels[channel]);
+    }
+
+    void reset() override
+    {
+        m_phase = m_initialPhase;
+    }
+
+protected:
+    const double m_frequencyHz;
+    const double m_initialPhaseRadians;
+
+    /// @brief Residual that turns a naive jump from -1 to +1 into a band-limited one
+    /// @param phase Distance from the jump in cycles, in 0..1 range
+    /// @param phaseIncrement Phase increment per frame in cycles
+    static double polyBlep (double phase, double phaseIncrement)
+    {
+        if (phase < phaseIncrement)
+        {
+            const double x = phase / phaseIncrement;
+            return - (1.0 - x) * (1.0 - x);
+        }
+
+        if (phase > 1.0 - phaseIncrement)
+        {
+            const double x = (phase - 1.0) / phaseIncrement;
+            return (1.0 + x) * (1.0 + x);
+        }
+
+        return 0.0;
+    }
+
+    /// @brief Residual that turns a naive corner into a band-limited one
+    /// @details Scale it by the change of slope at the corner, in value per frame
+    /// @param phase Distance from the corner in cycles, in 0..1 range
+    /// @param phaseIncrement Phase increment per frame in cycles
+    static double polyBlamp (double phase, double phaseIncrement)
+    {
+        if (phase < phaseIncrement)
+        {
+            const double x = 1.0 - phase / phaseIncrement;
+            return x * x * x / 6.0;
+        }
+
+        if (phase > 1.0 - phaseIncrement)
+        {
+            const double x = 1.0 + (phase - 1.0) / phaseIncrement;
+            return x * x * x / 6.0;
+        }
+
+        return 0.0;
+    }
+
+    /// @brief Wraps the phase in cycles into 0..1 range
+    static double wrapCycles (double phase)
+    {
+        return phase - std::floor (phase);
+    }
+
+private:
+    const double m_initialPhase;
+    double m_phase = 0.0;
+    double m_phaseIncrement = 0.0;
+};
+
+}  // namespace hart
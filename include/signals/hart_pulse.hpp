@@ -0,0 +1,55 @@
+#pragma once
+
+#include "hart_exceptions.hpp"
+#include "hart_precision.hpp"
+#include "signals/hart_polyblep_oscillator.hpp"
+
+namespace hart
+{
+
+/// @brief Produces a band-limited pulse wave at fixed frequency and duty cycle
+/// @details Outputs a signal at 0dB peak (-1.0..+1.0), with the jumps smoothed out by PolyBLEP, so it aliases
+/// way less than a naive pulse wave. Jumps up to +1.0 at zero phase, and stays there for the duty cycle portion
+/// of the period. Note that unless the duty cycle is 0.5, the signal has a DC offset of (2 * dutyCycle - 1).
+/// @see Square
+/// @ingroup Signals
+template<typename SampleType>
+class Pulse:
+    public PolyBLEPOscillator<SampleType, Pulse<SampleType>>
+{
+public:
+    /// @param frequencyHz Frequency in Hz, must be below Nyquist at the sample rate of the test
+    /// @param dutyCycle Portion of the period spent at +1.0, between 0.0 and 1.0 (exclusive)
+    /// @param phaseRadians Initial phase in radians
+    Pulse (double frequencyHz = 1000.0, double dutyCycle = 0.5, double phaseRadians = 0.0):
+        PolyBLEPOscillator<SampleType, Pulse<SampleType>> (frequencyHz, phaseRadians),
+        m_dutyCycle (dutyCycle)
+    {
+        if (dutyCycle <= 0.0 || dutyCycle >= 1.0)
+            HART_THROW (hart::ValueError, "Duty cycle should be between 0.0 and 1.0");
+    }
+
+    /// @private
+    double getValue (double phase, double phaseIncrement) const
+    {
+        const double naiveValue = phase < m_dutyCycle ? 1.0 : -1.0;
+        return naiveValue
+            + this->polyBlep (phase, phaseIncrement)
+            - this->polyBlep (this->wrapCycles (phase - m_dutyCycle), phaseIncrement);
+    }
+
+    void represent (std::ostream& stream) const override
+    {
+        stream << "Pulse ("
+            << hzPrecision << this->m_frequencyHz << "_Hz, "
+            << linPrecision << m_dutyCycle << ", "
+            << radPrecision << this->m_initialPhaseRadians << "_rad)";
+    }
+
+    HART_SIGNAL_DEFINE_COPY_AND_MOVE (Pulse);
+
+private:
+    const double m_dutyCycle;
+};
+
+}  // namespace hart
@@ -0,0 +1,42 @@
+#pragma once
+
+#include "hart_precision.hpp"
+#include "signals/hart_polyblep_oscillator.hpp"
+
+namespace hart
+{
+
+/// @brief Produces a band-limited sawtooth wave at fixed frequency
+/// @details Outputs a rising ramp at 0dB peak (-1.0..+1.0), with the jumps smoothed out by PolyBLEP, so it aliases
+/// way less than a naive sawtooth. Rises from zero with zero phase, and jumps from +1.0 to -1.0 in the middle of the cycle.
+/// @ingroup Signals
+template<typename SampleType>
+class Saw:
+    public PolyBLEPOscillator<SampleType, Saw<SampleType>>
+{
+public:
+    /// @param frequencyHz Frequency in Hz, must be below Nyquist at the sample rate of the test
+    /// @param phaseRadians Initial phase in radians
+    Saw (double frequencyHz = 1000.0, double phaseRadians = 0.0):
+        PolyBLEPOscillator<SampleType, Saw<SampleType>> (frequencyHz, phaseRadians)
+    {
+    }
+
+    /// @private
+    double getValue (double phase, double phaseIncrement) const
+    {
+        const double shiftedPhase = this->wrapCycles (phase + 0.5);
+        return 2.0 * shiftedPhase - 1.0 - this->polyBlep (shiftedPhase, phaseIncrement);
+    }
+
+    void represent (std::ostream& stream) const override
+    {
+        stream << "Saw ("
+            << hzPrecision << this->m_frequencyHz << "_Hz, "
+            << radPrecision << this->m_initialPhaseRadians << "_rad)";
+    }
+
+    HART_SIGNAL_DEFINE_COPY_AND_MOVE (Saw);
+};
+
+}  // namespace hart
@@ -18,6 +18,9 @@
 namespace hart {
 
 /// @brief Base class for signals
+/// @details Copying a signal is cheap: copies share the effects in the DSP chain until one of them gets
+/// modified, prepared or rendered, and only then that copy gets its own instances of the effects.
+/// So a signal with a long DSP chain can be used as a prototype for any number of tests.
 /// @ingroup Signals
 /// @tparam SampleType Type of values that will be generated, typically ```float``` or ```double```
 template<typename SampleType>
@@ -28,16 +31,11 @@ public:
     Signal() = default;
 
     /// @brief Copies other signal
+    /// @details The DSP chain is shared with the other signal until either of them modifies it
     Signal (const Signal& other):
-        m_numChannels(other.m_numChannels)
+        m_numChannels (other.m_numChannels),
+        dspChain (other.dspChain)
     {
-        if (other.dspChain.size() == 0)
-            return;
-
-        dspChain.reserve (dspChain.size());
-
-        for (auto& dsp : other.dspChain)
-            dspChain.push_back (dsp->copy());
     }
 
     /// @brief Moves from other signal
@@ -52,20 +50,14 @@ public:
     virtual ~Signal() = default;
 
     /// @brief Copies from other signal
+    /// @details The DSP chain is shared with the other signal until either of them modifies it
     Signal& operator= (const Signal& other)
     {
         if (this == &other)
             return *this;
 
         m_numChannels = other.m_numChannels;
-        dspChain.clear();
-
-        if (other.dspChain.size() == 0)
-            return *this;
-
-        for (auto& dsp : other.dspChain)
-            dspChain.push_back (dsp->copy());
-        
+        dspChain = other.dspChain;
         return *this;
     }
 
@@ -154,7 +146,7 @@ public:
     /// @param dsp A DSP effect instance
     Signal& followedBy (const DSP<SampleType>& dsp)
     {
-        dspChain.emplace_back (dsp.copy());
+        getUniqueDSPChain().emplace_back (dsp.copy());
         return *this;
     }
 
@@ -163,7 +155,7 @@ public:
     /// @param dsp A DSP effect instance
     Signal& followedBy (std::unique_ptr<DSP<SampleType>> dsp)
     {
-        dspChain.emplace_back (std::move (dsp));
+        getUniqueDSPChain().emplace_back (std::move (dsp));
         return *this;
     }
 
@@ -183,7 +175,7 @@ public:
         >
     Signal& followedBy (DerivedDSP&& dsp)
     {
-        dspChain.emplace_back (
+        getUniqueDSPChain().emplace_back (
             hart::make_unique<typename std::decay<DerivedDSP>::type> (std::forward<DerivedDSP> (dsp))
         );
         return *this;
@@ -200,9 +192,12 @@ public:
         prepare (sampleRateHz, numOutputChannels, maxBlockSizeFrames);
         const size_t numInputChannels = numOutputChannels;
 
+        if (dspChain == nullptr)
+            return;
+
         // TODO: Check if all the effects in the chain support those settings first
 
-        for (auto& dsp : dspChain)
+        for (auto& dsp : getUniqueDSPChain())
         {
             if (! dsp->supportsChannelLayout (numInputChannels, numOutputChannels))
                 HART_THROW_OR_RETURN_VOID (ChannelLayoutError, "Not all DSP in the Signal's DSP chain support its channel layout");
@@ -224,7 +219,10 @@ public:
         renderNextBlock (output);
         AudioBuffer<SampleType>& inputReplacing = output;
 
-        for (auto& dsp : dspChain)
+        if (dspChain == nullptr)
+            return;
+
+        for (auto& dsp : getUniqueDSPChain())
             dsp->processWithEnvelopes (inputReplacing, output);
     }
 
@@ -235,8 +233,11 @@ public:
     {
         reset();
 
-        for (auto& dsp : dspChain)
-            dsp->reset();
+        if (dspChain == nullptr)
+            return;
+
+        for (auto& dsp : getUniqueDSPChain())
+            dsp->resetWithEnvelopes();
     }
 
     /// @brief Makes a text representation of this signal and its entire signal chain for test failure outputs.
@@ -247,7 +248,10 @@ public:
     {
         represent (stream);
 
-        for (const auto& dsp : dspChain)
+        if (dspChain == nullptr)
+            return;
+
+        for (const auto& dsp : *dspChain)
             stream << " >> " << *dsp;
     }
 
@@ -267,8 +271,32 @@ protected:
     }
 
 private:
+    using DSPChain = std::vector<std::unique_ptr<DSP<SampleType>>>;
+
     size_t m_numChannels = 1;
-    std::vector<std::unique_ptr<DSP<SampleType>>> dspChain;
+    std::shared_ptr<DSPChain> dspChain;
+
+    /// @brief Gets the DSP chain for modifying it
+    /// @details If the chain is shared with other copies of this signal, this signal gets its own copy of it first
+    DSPChain& getUniqueDSPChain()
+    {
+        if (dspChain == nullptr)
+        {
+            dspChain = std::make_shared<DSPChain>();
+        }
+        else if (dspChain.use_count() > 1)
+        {
+            std::shared_ptr<DSPChain> uniqueDSPChain = std::make_shared<DSPChain>();
+            uniqueDSPChain->reserve (dspChain->size());
+
+            for (const auto& dsp : *dspChain)
+                uniqueDSPChain->push_back (dsp->copy());
+
+            dspChain = std::move (uniqueDSPChain);
+        }
+
+        return *dspChain;
+    }
 };
 
 /// @brief Prints readable text representation of the Signal object into the I/O stream
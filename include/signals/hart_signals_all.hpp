@@ -1,8 +1,15 @@
 #pragma once
 
+#include "signals/hart_brownnoise.hpp"
+#include "signals/hart_gaussiannoise.hpp"
+#include "signals/hart_pinknoise.hpp"
+#include "signals/hart_pulse.hpp"
+#include "signals/hart_saw.hpp"
 #include "signals/hart_signal.hpp"
 #include "signals/hart_silence.hpp"
 #include "signals/hart_sine_sweep.hpp"
 #include "signals/hart_sinewave.hpp"
+#include "signals/hart_square.hpp"
+#include "signals/hart_triangle.hpp"
 #include "signals/hart_wavfile.hpp"
 #include "signals/hart_whitenoise.hpp"
@@ -24,9 +24,7 @@ public:
 
     void renderNextBlock (AudioBuffer<SampleType>& output) override
     {
-        for (size_t channel = 0; channel < output.getNumChannels(); ++channel)
-            for (size_t frame = 0; frame < output.getNumFrames(); ++frame)
-                output[channel][frame] = (SampleType) 0;
+        output.fillSilence();
     }
 
     void reset() override {}
@@ -124,6 +124,43 @@ public:
         return SineSweep (m_durationSeconds, m_startFrequencyHz, m_endFrequencyHz, m_type, m_loop, initialPhaseRadians);
     }
 
+    /// @brief Returns the duration of one sweep in seconds
+    double getDurationSeconds() const { return m_durationSeconds; }
+
+    /// @brief Returns the start frequency of the sweep in Hz
+    double getStartFrequencyHz() const { return m_startFrequencyHz; }
+
+    /// @brief Returns the end frequency of the sweep in Hz
+    double getEndFrequencyHz() const { return m_endFrequencyHz; }
+
+    /// @brief Returns the sweep type, see @ref SweepType
+    SweepType getType() const { return m_type; }
+
+    /// @brief Returns the loop preference, see @ref Loop
+    Loop getLoop() const { return m_loop; }
+
+    /// @brief Returns the instantaneous frequency of the sweep at a specific time
+    /// @details Handy for the matchers that need to know what the input was doing at some point, like @ref AliasingBelow.
+    /// Doesn't depend on the sample rate, so it can be called before @ref prepare().
+    /// @param timeSeconds Time since the start of the sweep in seconds
+    /// @return Frequency in Hz, or zero if the sweep is over by that time and doesn't loop
+    double getFrequencyHzAt (double timeSeconds) const
+    {
+        if (timeSeconds < 0 || floatsEqual (m_durationSeconds, 0.0))
+            return 0.0;
+
+        const double numSweeps = timeSeconds / m_durationSeconds;
+
+        if (m_loop == Loop::no && numSweeps >= 1.0)
+            return 0.0;
+
+        // Every other sweep goes backwards
+        const double sweepIndex = std::floor (numSweeps);
+        const bool isReversed = std::fmod (sweepIndex, 2.0) > 0.5;
+        const double portion = numSweeps - sweepIndex;
+        return frequencyAtPortion (isReversed ? 1.0 - portion : portion);
+    }
+
     bool supportsNumChannels (size_t /*numChannels*/) const override { return true; }
 
     void prepare (double sampleRateHz, size_t /*numOutputChannels*/, size_t /*maxBlockSizeFrames*/) override
@@ -136,7 +173,7 @@ public:
     {
         if (m_generateSilence)
         {
-            fillWithSilence (output);
+            output.fillSilence();
             return;
         }
 
@@ -229,8 +266,15 @@ private:
         hassert (offsetFrames < m_durationFrames);
         const double offsetSeconds = static_cast<double> (offsetFrames) / m_sampleRateHz;
 
-        double portion = offsetSeconds / m_durationSeconds;
-        portion = reverseFrequencyDirection ? 1.0 - portion : portion;
+        const double portion = offsetSeconds / m_durationSeconds;
+        return frequencyAtPortion (reverseFrequencyDirection ? 1.0 - portion : portion);
+    }
+
+    /// @param portion Position within one sweep, from 0 at the start frequency to 1 at the end frequency
+    double frequencyAtPortion (double portion) const
+    {
+        if (m_isFixedFrequency)
+            return m_startFrequencyHz;
 
         if (m_type == SweepType::linear)
             return m_startFrequencyHz + (m_endFrequencyHz - m_startFrequencyHz) * portion;
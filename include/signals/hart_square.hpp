@@ -0,0 +1,45 @@
+#pragma once
+
+#include "hart_precision.hpp"
+#include "signals/hart_polyblep_oscillator.hpp"
+
+namespace hart
+{
+
+/// @brief Produces a band-limited square wave at fixed frequency
+/// @details Outputs a signal at 0dB peak (-1.0..+1.0), with the jumps smoothed out by PolyBLEP, so it aliases
+/// way less than a naive square wave. Jumps up to +1.0 at zero phase, and down to -1.0 in the middle of the cycle.
+/// @see Pulse
+/// @ingroup Signals
+template<typename SampleType>
+class Square:
+    public PolyBLEPOscillator<SampleType, Square<SampleType>>
+{
+public:
+    /// @param frequencyHz Frequency in Hz, must be below Nyquist at the sample rate of the test
+    /// @param phaseRadians Initial phase in radians
+    Square (double frequencyHz = 1000.0, double phaseRadians = 0.0):
+        PolyBLEPOscillator<SampleType, Square<SampleType>> (frequencyHz, phaseRadians)
+    {
+    }
+
+    /// @private
+    double getValue (double phase, double phaseIncrement) const
+    {
+        const double naiveValue = phase < 0.5 ? 1.0 : -1.0;
+        return naiveValue
+            + this->polyBlep (phase, phaseIncrement)
+            - this->polyBlep (this->wrapCycles (phase + 0.5), phaseIncrement);
+    }
+
+    void represent (std::ostream& stream) const override
+    {
+        stream << "Square ("
+            << hzPrecision << this->m_frequencyHz << "_Hz, "
+            << radPrecision << this->m_initialPhaseRadians << "_rad)";
+    }
+
+    HART_SIGNAL_DEFINE_COPY_AND_MOVE (Square);
+};
+
+}  // namespace hart
@@ -0,0 +1,53 @@
+#pragma once
+
+#include "hart_precision.hpp"
+#include "signals/hart_polyblep_oscillator.hpp"
+
+namespace hart
+{
+
+/// @brief Produces a band-limited triangle wave at fixed frequency
+/// @details Outputs a signal at 0dB peak (-1.0..+1.0), with the corners smoothed out by PolyBLAMP, so it aliases
+/// way less than a naive triangle wave. Same as @ref SineWave, rises from zero with zero phase,
+/// peaks at a quarter of the cycle, and bottoms out at three quarters.
+/// @ingroup Signals
+template<typename SampleType>
+class Triangle:
+    public PolyBLEPOscillator<SampleType, Triangle<SampleType>>
+{
+public:
+    /// @param frequencyHz Frequency in Hz, must be below Nyquist at the sample rate of the test
+    /// @param phaseRadians Initial phase in radians
+    Triangle (double frequencyHz = 1000.0, double phaseRadians = 0.0):
+        PolyBLEPOscillator<SampleType, Triangle<SampleType>> (frequencyHz, phaseRadians)
+    {
+    }
+
+    /// @private
+    double getValue (double phase, double phaseIncrement) const
+    {
+        double naiveValue = 4.0 * phase;
+
+        if (phase >= 0.75)
+            naiveValue -= 4.0;
+        else if (phase >= 0.25)
+            naiveValue = 2.0 - naiveValue;
+
+        // Slope flips between +4 and -4 per cycle at each corner
+        const double slopeChange = 8.0 * phaseIncrement;
+        return naiveValue
+            - slopeChange * this->polyBlamp (this->wrapCycles (phase - 0.25), phaseIncrement)
+            + slopeChange * this->polyBlamp (this->wrapCycles (phase - 0.75), phaseIncrement);
+    }
+
+    void represent (std::ostream& stream) const override
+    {
+        stream << "Triangle ("
+            << hzPrecision << this->m_frequencyHz << "_Hz, "
+            << radPrecision << this->m_initialPhaseRadians << "_rad)";
+    }
+
+    HART_SIGNAL_DEFINE_COPY_AND_MOVE (Triangle);
+};
+
+}  // namespace hart
@@ -93,6 +93,15 @@ public:
     {
         // TODO: Add support for number of channels different from the wav file
         // TODO: Add resampling
+
+        // The whole file has been played already
+        if (m_wavOffsetFrames >= m_wavFrames->getNumFrames())
+        {
+            hassert (m_loop == Loop::no);
+            output.fillSilence();
+            return;
+        }
+
         const size_t numFrames = output.getNumFrames();
         size_t frameInOutputBuffer = 0;
         size_t frameInWavBuffer = m_wavOffsetFrames;
@@ -126,6 +135,24 @@ public:
         m_wavOffsetFrames = 0;
     }
 
+    /// @brief Gets all the frames of the wav file, as they are in the file
+    const AudioBuffer<float>& getWavFrames() const
+    {
+        return *m_wavFrames;
+    }
+
+    /// @brief Gets the sample rate of the wav file
+    double getWavSampleRateHz() const
+    {
+        return m_wavSampleRateHz;
+    }
+
+    /// @brief Gets the path to the wav file, exactly as it was given to the constructor
+    const std::string& getFilePath() const
+    {
+        return m_filePath;
+    }
+
     void represent (std::ostream& stream) const override
     {
         stream << "WavFile (\"" << m_filePath << (m_loop == Loop::yes ? "\", Loop::yes)" : "\", Loop::no)");
@@ -21,7 +21,7 @@ HART_GENERATE ("Envelope - Gain Envelope Regression")
     processAudioWith (GainLinear().withEnvelope (GainLinear::gainLinear, gainEnvelopeA))
         .withLabel ("Envelope A")
         .withInputSignal (SineWave (2_kHz))
-        .withDuration (75_ms)
+        .withFixedDuration (75_ms)
         .saveOutputTo ("Gain Envelope A Fail.wav", hart::Save::always)
         .process();
 
@@ -34,7 +34,7 @@ HART_GENERATE ("Envelope - Gain Envelope Regression")
     processAudioWith (GainLinear().withEnvelope (GainLinear::gainLinear, gainEnvelopeB))
         .withLabel ("Envelope B")
         .withInputSignal (SineWave (3_kHz))
-        .withDuration (75_ms)
+        .withFixedDuration (75_ms)
         .saveOutputTo ("Gain Envelope B Fail.wav", hart::Save::always)
         .process();
 
@@ -47,7 +47,7 @@ HART_GENERATE ("Envelope - Gain Envelope Regression")
     processAudioWith (GainLinear().withEnvelope (GainLinear::gainLinear, gainEnvelopeC))
         .withLabel ("Envelope C")
         .withInputSignal (SineWave (2.5_kHz))
-        .withDuration (75_ms)
+        .withFixedDuration (75_ms)
         .saveOutputTo ("Gain Envelope C Fail.wav", hart::Save::always)
         .process();
 }
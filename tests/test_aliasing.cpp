@@ -0,0 +1,71 @@
+#include "hart.hpp"
+
+using hart::processAudioWith;
+using AliasingBelow = hart::AliasingBelow<float>;
+using GainDb = hart::GainDb<float>;
+using HardClip = hart::HardClip<float>;
+using Oversampled = hart::Oversampled<float>;
+using SineSweep = hart::SineSweep<float>;
+using SineWave = hart::SineWave<float>;
+
+HART_TEST ("Aliasing - Sine")
+{
+    processAudioWith (GainDb (-6_dB))
+        .withInputSignal (SineWave (1_kHz))
+        .withInputChannels (2)
+        .withOutputChannels (2)
+        .withDuration (0.5_s)
+        .expectTrue (AliasingBelow (-80_dB, 1_kHz))
+        .process();
+
+    processAudioWith (HardClip())
+        .withLabel ("Naive clipper")
+        .withInputSignal (SineWave (5_kHz) >> GainDb (12_dB))
+        .withDuration (0.5_s)
+        .expectFalse (AliasingBelow (-40_dB, 5_kHz))
+        .process();
+
+    processAudioWith (Oversampled (HardClip(), 8))
+        .withLabel ("Oversampled clipper")
+        .withInputSignal (SineWave (5_kHz) >> GainDb (12_dB))
+        .withDuration (0.5_s)
+        .expectTrue (AliasingBelow (-40_dB, 5_kHz))
+        .process();
+
+    for (const size_t blockSize : { 1, 1024, 22050 })
+    {
+        processAudioWith (HardClip())
+            .withLabel ("Block size")
+            .withBlockSize (blockSize)
+            .withInputSignal (SineWave (5_kHz) >> GainDb (12_dB))
+            .withDuration (0.5_s)
+            .expectFalse (AliasingBelow (-40_dB, 5_kHz))
+            .process();
+    }
+}
+
+HART_TEST ("Aliasing - Sweep")
+{
+    const SineSweep sweep (1_s, 20_Hz, 20_kHz);
+
+    processAudioWith (GainDb())
+        .withInputSignal (sweep)
+        .withDuration (1.5_s)
+        .expectTrue (AliasingBelow (-80_dB, sweep))
+        .process();
+
+    processAudioWith (HardClip (-6_dB))
+        .withInputSignal (sweep)
+        .withDuration (1_s)
+        .expectFalse (AliasingBelow (-40_dB, sweep))
+        .process();
+
+    // The sweep goes up and down, and the frequency is known all the way through
+    const SineSweep loopedSweep = SineSweep (0.5_s, 500_Hz, 5_kHz).withLoop (SineSweep::Loop::yes);
+
+    processAudioWith (GainDb())
+        .withInputSignal (loopedSweep)
+        .withDuration (1_s)
+        .expectTrue (AliasingBelow (-80_dB, loopedSweep))
+        .process();
+}
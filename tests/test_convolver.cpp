@@ -0,0 +1,151 @@
+#include <random>
+#include <vector>
+
+#include "hart.hpp"
+
+using hart::processAudioWith;
+using AudioBuffer = hart::AudioBuffer<float>;
+using Convolver = hart::Convolver<float>;
+using EqualsTo = hart::EqualsTo<float>;
+using PeaksBelow = hart::PeaksBelow<float>;
+using Silence = hart::Silence<float>;
+using SineWave = hart::SineWave<float>;
+using WhiteNoise = hart::WhiteNoise<float>;
+
+/// @brief Straightforward time domain convolution, as a reference for @ref hart::Convolver
+class DirectConvolver:
+    public hart::DSP<float>
+{
+public:
+    using SampleType = float;
+
+    DirectConvolver (const AudioBuffer& impulseResponse):
+        m_impulseResponse (impulseResponse)
+    {
+    }
+
+    void prepare (double /* sampleRateHz */, size_t numInputChannels, size_t numOutputChannels, size_t /* maxBlockSizeFrames */) override
+    {
+        m_numInputChannels = numInputChannels;
+        m_history.assign (numOutputChannels, std::vector<double> (m_impulseResponse.getNumFrames()));
+    }
+
+    void process (const AudioBuffer& input, AudioBuffer& output, const hart::EnvelopeBuffers& /* envelopeBuffers */) override
+    {
+        const size_t numTaps = m_impulseResponse.getNumFrames();
+
+        for (size_t channel = 0; channel < output.getNumChannels(); ++channel)
+        {
+            const float* taps = m_impulseResponse[m_impulseResponse.getNumChannels() == 1 ? 0 : channel];
+            const float* inputFrames = input[m_numInputChannels == 1 ? 0 : channel];
+            std::vector<double>& history = m_history[channel];
+
+            for (size_t frame = 0; frame < input.getNumFrames(); ++frame)
+            {
+                history.erase (history.end() - 1);
+                history.insert (history.begin(), inputFrames[frame]);
+                double outputValue = 0.0;
+
+                for (size_t i = 0; i < numTaps; ++i)
+                    outputValue += taps[i] * history[i];
+
+                output[channel][frame] = static_cast<float> (outputValue);
+            }
+        }
+    }
+
+    void reset() override {}
+    void setValue (int /* paramId */, double /* value */) override {}
+    double getValue (int /* paramId */) const override { return 0.0; }
+    bool supportsChannelLayout (size_t /* numInputChannels */, size_t /* numOutputChannels */) const override { return true; }
+    HART_DEFINE_GENERIC_REPRESENT (DirectConvolver);
+    HART_DSP_DEFINE_COPY_AND_MOVE (DirectConvolver);
+
+private:
+    const AudioBuffer m_impulseResponse;
+    size_t m_numInputChannels = 0;
+    std::vector<std::vector<double>> m_history;
+};
+
+/// Exponentially decaying noise, a bit like a reverb tail
+static AudioBuffer makeImpulseResponse (size_t numChannels, size_t numFrames)
+{
+    AudioBuffer impulseResponse (numChannels, numFrames);
+    std::mt19937 randomGenerator (42);
+    std::uniform_real_distribution<float> distribution (-1.0f, 1.0f);
+
+    for (size_t channel = 0; channel < numChannels; ++channel)
+        for (size_t frame = 0; frame < numFrames; ++frame)
+            impulseResponse[channel][frame] = 0.1f * distribution (randomGenerator) * std::exp (-5.0f * frame / numFrames);
+
+    return impulseResponse;
+}
+
+HART_TEST ("Convolver - Unit Impulse")
+{
+    AudioBuffer unitImpulse (1, 1);
+    unitImpulse[0][0] = 1.0f;
+
+    processAudioWith (Convolver (unitImpulse))
+        .withInputChannels (2)
+        .withOutputChannels (2)
+        .withInputSignal (WhiteNoise (1))
+        .expectTrue (EqualsTo (WhiteNoise (1)))
+        .process();
+}
+
+HART_TEST ("Convolver - Matches Direct Convolution")
+{
+    for (const size_t numFrames : { 100, 256, 257, 3000 })
+    {
+        const AudioBuffer impulseResponse = makeImpulseResponse (1, numFrames);
+        WhiteNoise reference (1);
+        reference.followedBy (DirectConvolver (impulseResponse));
+
+        processAudioWith (Convolver (impulseResponse))
+            .withLabel (std::to_string (numFrames) + " frames long impulse response")
+            .withBlockSize (100)
+            .withDuration (0.2)
+            .withInputSignal (WhiteNoise (1))
+            .expectTrue (EqualsTo (reference, 1e-4))
+            .process();
+    }
+}
+
+HART_TEST ("Convolver - Channel Layouts")
+{
+    const AudioBuffer impulseResponse = makeImpulseResponse (2, 1000);
+
+    WhiteNoise stereoReference (1);
+    stereoReference.followedBy (DirectConvolver (impulseResponse));
+
+    processAudioWith (Convolver (impulseResponse))
+        .withLabel ("Stereo impulse response, stereo input")
+        .withInputChannels (2)
+        .withOutputChannels (2)
+        .withDuration (0.1)
+        .withInputSignal (WhiteNoise (1))
+        .expectTrue (EqualsTo (stereoReference, 1e-4))
+        .process();
+
+    // Reference signal can't change its number of channels, so the input has to be the same in all channels
+    SineWave monoInputReference (440_Hz);
+    monoInputReference.followedBy (DirectConvolver (impulseResponse));
+
+    processAudioWith (Convolver (impulseResponse))
+        .withLabel ("Stereo impulse response, mono input")
+        .withInputChannels (1)
+        .withOutputChannels (2)
+        .withDuration (0.1)
+        .withInputSignal (SineWave (440_Hz))
+        .expectTrue (EqualsTo (monoInputReference, 1e-4))
+        .process();
+}
+
+HART_TEST ("Convolver - Silence")
+{
+    processAudioWith (Convolver (makeImpulseResponse (1, 5000)))
+        .withInputSignal (Silence())
+        .expectTrue (PeaksBelow (-200_dB))
+        .process();
+}
@@ -0,0 +1,96 @@
+#include "hart.hpp"
+
+using hart::processAudioWith;
+using Delay = hart::Delay<float>;
+using EqualsTo = hart::EqualsTo<float>;
+using GainLinear = hart::GainLinear<float>;
+using IsFinite = hart::IsFinite<float>;
+using PeaksAt = hart::PeaksAt<float>;
+using SegmentedEnvelope = hart::SegmentedEnvelope;
+using SineWave = hart::SineWave<float>;
+using WhiteNoise = hart::WhiteNoise<float>;
+
+static constexpr double sampleRateHz = 48000.0;
+
+/// Sine wave that fades in smoothly after a pause, so that delaying it is the same as starting it later
+static SineWave fadingInSineWave (double frequencyHz, double startSeconds)
+{
+    GainLinear fadeIn;
+    fadeIn.withEnvelope (GainLinear::gainLinear, SegmentedEnvelope (0.0).hold (startSeconds).rampTo (1.0, 20_ms, SegmentedEnvelope::Shape::sCurve));
+
+    SineWave sineWave (frequencyHz, -hart::twoPi * frequencyHz * startSeconds);
+    sineWave.followedBy (std::move (fadeIn));
+    return sineWave;
+}
+
+HART_TEST ("Delay - Whole Frames")
+{
+    WhiteNoise delayedTwice (1);
+    delayedTwice.followedBy (Delay (10 / sampleRateHz));
+    delayedTwice.followedBy (Delay (21 / sampleRateHz, Delay::Interpolation::lagrange));
+
+    // Whole frames get copied over, so the result is exact no matter the interpolation or block size
+    processAudioWith (Delay (31 / sampleRateHz, Delay::Interpolation::thiran))
+        .withSampleRate (sampleRateHz)
+        .withInputChannels (2)
+        .withOutputChannels (2)
+        .withBlockSize (16)
+        .withInputSignal (WhiteNoise (1))
+        .expectTrue (EqualsTo (delayedTwice, 0.0))
+        .process();
+
+    processAudioWith (Delay (0_s))
+        .withSampleRate (sampleRateHz)
+        .withInputSignal (WhiteNoise (1))
+        .expectTrue (EqualsTo (WhiteNoise (1), 0.0))
+        .process();
+}
+
+HART_TEST ("Delay - Fractional Frames")
+{
+    const double delaySeconds = 10.3 / sampleRateHz;
+
+    for (const Delay::Interpolation interpolation : { Delay::Interpolation::linear, Delay::Interpolation::lagrange, Delay::Interpolation::thiran })
+    {
+        processAudioWith (Delay (delaySeconds, interpolation))
+            .withSampleRate (sampleRateHz)
+            .withInputSignal (fadingInSineWave (200_Hz, 10_ms))
+            .expectTrue (EqualsTo (fadingInSineWave (200_Hz, 10_ms + delaySeconds), 1e-3))
+            .process();
+    }
+
+    // Rounded to 10 frames
+    processAudioWith (Delay (delaySeconds, Delay::Interpolation::none))
+        .withSampleRate (sampleRateHz)
+        .withInputSignal (fadingInSineWave (200_Hz, 10_ms))
+        .expectTrue (EqualsTo (fadingInSineWave (200_Hz, 10_ms + 10 / sampleRateHz), 1e-5))
+        .process();
+}
+
+HART_TEST ("Delay - Automation")
+{
+    // Automated delay that stays put is the same as a fixed one
+    Delay steadyDelay (0_s, Delay::Interpolation::lagrange, 10_ms);
+    steadyDelay.withEnvelope (Delay::delaySeconds, SegmentedEnvelope (24 / sampleRateHz));
+
+    WhiteNoise reference (1);
+    reference.followedBy (Delay (24 / sampleRateHz));
+
+    processAudioWith (steadyDelay)
+        .withSampleRate (sampleRateHz)
+        .withBlockSize (100)
+        .withInputSignal (WhiteNoise (1))
+        .expectTrue (EqualsTo (reference, 1e-5))
+        .process();
+
+    // Slow sweep just bends the pitch a bit, and envelope values beyond the maximum delay are clamped
+    Delay sweepingDelay (1_ms, Delay::Interpolation::lagrange, 5_ms);
+    sweepingDelay.withEnvelope (Delay::delaySeconds, SegmentedEnvelope (1_ms).rampTo (10_ms, 1_s));
+
+    processAudioWith (sweepingDelay)
+        .withSampleRate (sampleRateHz)
+        .withInputSignal (fadingInSineWave (1_kHz, 0_s))
+        .expectTrue (PeaksAt (0_dB, 0.01))
+        .expectTrue (IsFinite())
+        .process();
+}
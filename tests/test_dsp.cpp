@@ -5,8 +5,11 @@ using HardClip = hart::HardClip<float>;
 using GainDb = hart::GainDb<float>;
 using PeaksAt = hart::PeaksAt<float>;
 using hart::processAudioWith;
+using PeaksBelow = hart::PeaksBelow<float>;
 using Silence = hart::Silence<float>;
 using SineWave = hart::SineWave<float>;
+using AudioBuffer = hart::AudioBuffer<float>;
+using EnvelopeBuffers = hart::EnvelopeBuffers;
 
 HART_TEST ("GainDb - GainDb Values")
 {
@@ -113,3 +116,40 @@ HART_TEST ("HardClip - Threshold Values")
         .expectTrue (PeaksAt (-10_dB))
         .process();
 }
+
+HART_TEST ("Silence - Constant Blocks")
+{
+    AudioBuffer input (2, 64);
+    AudioBuffer output (2, 64);
+    HART_EXPECT_TRUE (input.isSilent());
+
+    input[0][10] = 0.5f;
+    HART_EXPECT_TRUE (! input.isConstant());
+
+    input.fillConstant (0.5f);
+    HART_EXPECT_TRUE (input.isConstant() && input.getConstantValue() == 0.5f);
+    HART_EXPECT_TRUE (input.getMagnitude (0, 0, 64) == 0.5f);
+
+    HardClip hardClip (-oo_dB);
+    hardClip.process (input, output, EnvelopeBuffers());
+    HART_EXPECT_TRUE (output.isSilent());
+
+    GainDb gain (6_dB);
+    input.fillSilence();
+    gain.process (input, output, EnvelopeBuffers());
+    HART_EXPECT_TRUE (output.isSilent() && output[1][63] == 0.0f);
+
+    processAudioWith (GainDb (-6_dB))
+        .withLabel ("Long silent render")
+        .withInputSignal (Silence())
+        .withDuration (60.0)
+        .expectTrue (PeaksBelow (-120_dB))
+        .expectTrue (EqualsTo (Silence()))
+        .process();
+
+    processAudioWith (GainDb())
+        .withLabel ("Constant blocks still get checked")
+        .withInputSignal (Silence())
+        .expectFalse (EqualsTo (SineWave()))
+        .process();
+}
@@ -2,6 +2,8 @@
 #include <array>
 #include <random>
 #include <cstdint>  // uint_fast32_t
+#include <memory>
+#include <vector>
 
 #include "hart.hpp"
 
@@ -124,3 +126,75 @@ HART_TEST ("DSP Chains - Long Chains")
         .expectTrue (PeaksAt (expectedPeakDb))
         .process();
 }
+
+static size_t numCopyCountingDSPCopies = 0;
+
+/// @brief Passes the audio through, and counts how many times it got copied
+class CopyCountingDSP:
+    public hart::DSP<float>
+{
+public:
+    using SampleType = float;
+
+    CopyCountingDSP() = default;
+    CopyCountingDSP (CopyCountingDSP&& other) = default;
+
+    CopyCountingDSP (const CopyCountingDSP& other):
+        hart::DSP<float> (other)
+    {
+        ++numCopyCountingDSPCopies;
+    }
+
+    void prepare (double /* sampleRateHz */, size_t /* numInputChannels */, size_t /* numOutputChannels */, size_t /* maxBlockSizeFrames */) override {}
+
+    void process (const hart::AudioBuffer<float>& input, hart::AudioBuffer<float>& output, const hart::EnvelopeBuffers& /* envelopeBuffers */) override
+    {
+        for (size_t channel = 0; channel < input.getNumChannels(); ++channel)
+            for (size_t frame = 0; frame < input.getNumFrames(); ++frame)
+                output[channel][frame] = input[channel][frame];
+    }
+
+    void reset() override {}
+    void setValue (int /* paramId */, double /* value */) override {}
+    double getValue (int /* paramId */) const override { return 0.0; }
+    bool supportsChannelLayout (size_t numInputChannels, size_t numOutputChannels) const override { return numInputChannels == numOutputChannels; }
+    HART_DEFINE_GENERIC_REPRESENT (CopyCountingDSP);
+    HART_DSP_DEFINE_COPY_AND_MOVE (CopyCountingDSP);
+};
+
+HART_TEST ("DSP Chains - Copies Share The Chain")
+{
+    constexpr size_t chainLength = 100;
+    SineWave prototype;
+    prototype.followedBy (GainDb (-3_dB));
+
+    for (size_t i = 0; i < chainLength; ++i)
+        prototype.followedBy (CopyCountingDSP());
+
+    numCopyCountingDSPCopies = 0;
+    std::vector<std::unique_ptr<hart::Signal<float>>> copies;
+
+    for (size_t i = 0; i < 10; ++i)
+        copies.push_back (prototype.copy());
+
+    // Nothing gets copied until the chain is about to be modified or used
+    HART_EXPECT_TRUE (numCopyCountingDSPCopies == 0);
+
+    copies.back()->followedBy (GainDb (-3_dB));
+    HART_EXPECT_TRUE (numCopyCountingDSPCopies == chainLength);
+
+    // The modified copy has its own chain, and the rest still share one with the prototype
+    processAudioWith (GainDb (0_dB))
+        .withInputSignal (std::move (copies.back()))
+        .expectTrue (PeaksAt (-6_dB))
+        .process();
+
+    processAudioWith (GainDb (0_dB))
+        .withInputSignal (std::move (copies.front()))
+        .expectTrue (PeaksAt (-3_dB))
+        .expectTrue (EqualsTo (prototype))
+        .process();
+
+    // One more copy for each of the input signal and the reference signal, as they got rendered
+    HART_EXPECT_TRUE (numCopyCountingDSPCopies == 3 * chainLength);
+}
@@ -0,0 +1,28 @@
+#include <cstdio>  // remove()
+#include <string>
+
+#include "hart.hpp"
+
+using hart::DurationHistory;
+
+HART_TEST ("Duration History - Save and Load")
+{
+    HART_REQUIRES_DATA_PATH_ARG;
+
+    const std::string historyFilePath = hart::toAbsolutePath ("duration_history_test.tmp");
+
+    DurationHistory history;
+    history.load (historyFilePath);
+    HART_EXPECT_TRUE (history.getDurationSeconds ("test Soak") < 0);
+    history.record ("test Soak", 300.5);
+    history.record ("test Name With Spaces", 0.25);
+    HART_ASSERT_TRUE (history.save());
+
+    DurationHistory loadedHistory;
+    loadedHistory.load (historyFilePath);
+    HART_EXPECT_TRUE (loadedHistory.getDurationSeconds ("test Soak") == 300.5);
+    HART_EXPECT_TRUE (loadedHistory.getDurationSeconds ("test Name With Spaces") == 0.25);
+    HART_EXPECT_TRUE (loadedHistory.getDurationSeconds ("test Unknown") < 0);
+
+    std::remove (historyFilePath.c_str());
+}
@@ -21,7 +21,7 @@ HART_TEST ("Envelope - Gain Envelope Regression")
     processAudioWith (GainLinear().withEnvelope (GainLinear::gainLinear, gainEnvelopeA))
         .withLabel ("Envelope A")
         .withInputSignal (SineWave (2_kHz))
-        .withDuration (75_ms)
+        .withFixedDuration (75_ms)
         .saveOutputTo ("Gain Envelope A Fail.wav", hart::Save::whenFails)
         .expectTrue (EqualsTo (WavFile ("Gain Envelope A.wav")))
         .process();
@@ -35,7 +35,7 @@ HART_TEST ("Envelope - Gain Envelope Regression")
     processAudioWith (GainLinear().withEnvelope (GainLinear::gainLinear, gainEnvelopeB))
         .withLabel ("Envelope B")
         .withInputSignal (SineWave (3_kHz))
-        .withDuration (75_ms)
+        .withFixedDuration (75_ms)
         .saveOutputTo ("Gain Envelope B Fail.wav", hart::Save::whenFails)
         .expectTrue (EqualsTo (WavFile ("Gain Envelope B.wav")))
         .process();
@@ -49,7 +49,7 @@ HART_TEST ("Envelope - Gain Envelope Regression")
     processAudioWith (GainLinear().withEnvelope (GainLinear::gainLinear, gainEnvelopeC))
         .withLabel ("Envelope C")
         .withInputSignal (SineWave (2.5_kHz))
-        .withDuration (75_ms)
+        .withFixedDuration (75_ms)
         .saveOutputTo ("Gain Envelope C Fail.wav", hart::Save::whenFails)
         .expectTrue (EqualsTo (WavFile ("Gain Envelope C.wav")))
         .process();
@@ -0,0 +1,129 @@
+#include "hart.hpp"
+
+using hart::processAudioWith;
+using Biquad = hart::Biquad<float>;
+using BPF = hart::BPF<float>;
+using EqualsTo = hart::EqualsTo<float>;
+using GainLinear = hart::GainLinear<float>;
+using HighShelf = hart::HighShelf<float>;
+using HPF = hart::HPF<float>;
+using IsFinite = hart::IsFinite<float>;
+using LowShelf = hart::LowShelf<float>;
+using LPF = hart::LPF<float>;
+using PeakingEQ = hart::PeakingEQ<float>;
+using PeaksAt = hart::PeaksAt<float>;
+using PeaksBelow = hart::PeaksBelow<float>;
+using SegmentedEnvelope = hart::SegmentedEnvelope;
+using Silence = hart::Silence<float>;
+using SineWave = hart::SineWave<float>;
+
+/// Sine wave that fades in smoothly, so the filters don't ring at its onset
+static SineWave fadingInSineWave (double frequencyHz)
+{
+    GainLinear fadeIn;
+    fadeIn.withEnvelope (GainLinear::gainLinear, SegmentedEnvelope (0.0).rampTo (1.0, 20_ms, SegmentedEnvelope::Shape::sCurve));
+
+    SineWave sineWave (frequencyHz);
+    sineWave.followedBy (std::move (fadeIn));
+    return sineWave;
+}
+
+HART_TEST ("Filters - Pass And Stop Bands")
+{
+    processAudioWith (LPF (1_kHz))
+        .withLabel ("LPF pass band")
+        .withInputSignal (fadingInSineWave (50_Hz))
+        .expectTrue (PeaksAt (0_dB, 0.01))
+        .process();
+
+    processAudioWith (LPF (1_kHz))
+        .withLabel ("LPF stop band")
+        .withInputSignal (fadingInSineWave (10_kHz))
+        .expectTrue (PeaksBelow (-35_dB))
+        .process();
+
+    processAudioWith (LPF (1_kHz, 4))
+        .withLabel ("4th order LPF stop band")
+        .withInputSignal (fadingInSineWave (10_kHz))
+        .expectTrue (PeaksBelow (-70_dB))
+        .process();
+
+    processAudioWith (LPF (1_kHz, 3))
+        .withLabel ("3rd order LPF stop band")
+        .withInputSignal (fadingInSineWave (10_kHz))
+        .expectTrue (PeaksBelow (-55_dB))
+        .process();
+
+    processAudioWith (HPF (1_kHz))
+        .withLabel ("HPF pass band")
+        .withInputSignal (fadingInSineWave (15_kHz))
+        .expectTrue (PeaksAt (0_dB, 0.01))
+        .process();
+
+    processAudioWith (HPF (1_kHz, 6))
+        .withLabel ("6th order HPF stop band")
+        .withInputSignal (fadingInSineWave (100_Hz))
+        .expectTrue (PeaksBelow (-40_dB))
+        .process();
+
+    processAudioWith (BPF (1_kHz, 2.0))
+        .withLabel ("BPF center")
+        .withInputSignal (fadingInSineWave (1_kHz))
+        .expectTrue (PeaksAt (0_dB, 0.01))
+        .process();
+}
+
+HART_TEST ("Filters - Cookbook Gains")
+{
+    processAudioWith (PeakingEQ (1_kHz, 6_dB, 1.0))
+        .withLabel ("Peaking EQ at the center frequency")
+        .withInputSignal (fadingInSineWave (1_kHz))
+        .expectTrue (PeaksAt (6_dB, 0.01))
+        .process();
+
+    processAudioWith (LowShelf (1_kHz, -12_dB))
+        .withLabel ("Low shelf")
+        .withInputSignal (fadingInSineWave (30_Hz))
+        .expectTrue (PeaksAt (-12_dB, 0.01))
+        .process();
+
+    processAudioWith (HighShelf (1_kHz, 3_dB))
+        .withLabel ("High shelf")
+        .withInputSignal (fadingInSineWave (18_kHz))
+        .expectTrue (PeaksAt (3_dB, 0.01))
+        .process();
+
+    processAudioWith (Biquad (Biquad::Type::allPass, 1_kHz))
+        .withLabel ("All pass")
+        .withInputSignal (fadingInSineWave (3_kHz))
+        .expectTrue (PeaksAt (0_dB, 0.01))
+        .process();
+}
+
+HART_TEST ("Filters - Automation")
+{
+    processAudioWith (LPF().withEnvelope (LPF::frequencyHz, SegmentedEnvelope (2_kHz)))
+        .withLabel ("Flat envelope is the same as a fixed value")
+        .withInputSignal (SineWave (1.5_kHz))
+        .expectTrue (EqualsTo (SineWave (1.5_kHz) >> LPF (2_kHz)))
+        .process();
+
+    const auto sweep = SegmentedEnvelope (20_kHz)
+        .rampTo (100_Hz, 500_ms, SegmentedEnvelope::Shape::exponential)
+        .rampTo (20_kHz, 500_ms, SegmentedEnvelope::Shape::exponential);
+
+    processAudioWith (LPF().withEnvelope (LPF::frequencyHz, sweep).withEnvelope (LPF::q, SegmentedEnvelope (5.0)))
+        .withLabel ("Resonant cutoff sweep")
+        .withInputSignal (SineWave (5_kHz))
+        .withDuration (1_s)
+        .expectTrue (IsFinite())
+        .expectTrue (PeaksBelow (20_dB))
+        .expectFalse (PeaksBelow (-40_dB))
+        .process();
+
+    processAudioWith (LPF (1_kHz, 4))
+        .withLabel ("Silence stays silent")
+        .withInputSignal (Silence())
+        .expectTrue (EqualsTo (Silence()))
+        .process();
+}
@@ -0,0 +1,45 @@
+#include <atomic>
+#include <thread>
+#include <vector>
+
+#include "hart.hpp"
+
+static std::atomic<int> numSineTableSetups (0);
+
+HART_FIXTURE (SineTable)
+{
+    SineTable()
+    {
+        ++numSineTableSetups;
+
+        for (size_t frame = 0; frame < 1024; ++frame)
+            values.push_back (std::sin (hart::twoPi * frame / 1024.0));
+    }
+
+    std::vector<double> values;
+};
+
+HART_TEST ("Fixture - Set Up Once")
+{
+    const SineTable& sineTable = SineTable::get();
+    HART_EXPECT_TRUE (sineTable.values.size() == 1024);
+    HART_EXPECT_TRUE (&SineTable::get() == &sineTable);
+    HART_EXPECT_TRUE (numSineTableSetups == 1);
+}
+
+HART_TEST ("Fixture - Concurrent Access")
+{
+    std::vector<std::thread> threads;
+    std::vector<const SineTable*> fixtures (8, nullptr);
+
+    for (size_t i = 0; i < fixtures.size(); ++i)
+        threads.emplace_back ([&fixtures, i] { fixtures[i] = &SineTable::get(); });
+
+    for (auto& thread : threads)
+        thread.join();
+
+    for (const SineTable* fixture : fixtures)
+        HART_EXPECT_TRUE (fixture == &SineTable::get());
+
+    HART_EXPECT_TRUE (numSineTableSetups == 1);
+}
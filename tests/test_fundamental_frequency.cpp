@@ -0,0 +1,95 @@
+#include "hart.hpp"
+
+using hart::processAudioWith;
+using Delay = hart::Delay<float>;
+using FrequencyTracks = hart::FrequencyTracks<float>;
+using FundamentalFrequencyAt = hart::FundamentalFrequencyAt<float>;
+using GainDb = hart::GainDb<float>;
+using Saw = hart::Saw<float>;
+using SegmentedEnvelope = hart::SegmentedEnvelope;
+using SineSweep = hart::SineSweep<float>;
+using SineWave = hart::SineWave<float>;
+using WhiteNoise = hart::WhiteNoise<float>;
+
+HART_TEST ("Fundamental Frequency - Steady Pitch")
+{
+    processAudioWith (GainDb())
+        .withInputSignal (SineWave (440_Hz))
+        .withInputChannels (2)
+        .withOutputChannels (2)
+        .expectTrue (FundamentalFrequencyAt (440_Hz, 1))
+        .expectFalse (FundamentalFrequencyAt (445_Hz, 10))
+        .expectFalse (FundamentalFrequencyAt (220_Hz))
+        .expectFalse (FundamentalFrequencyAt (880_Hz))
+        .process();
+
+    processAudioWith (GainDb())
+        .withLabel ("Harmonic-rich waveform")
+        .withSampleRate (48_kHz)
+        .withInputSignal (Saw (110_Hz))
+        .expectTrue (FundamentalFrequencyAt (110_Hz, 5))
+        .expectFalse (FundamentalFrequencyAt (220_Hz))
+        .process();
+
+    for (const size_t blockSize : { 1, 32, 1024, 44100 })
+    {
+        processAudioWith (GainDb())
+            .withLabel ("Block size")
+            .withBlockSize (blockSize)
+            .withInputSignal (SineWave (1_kHz))
+            .expectTrue (FundamentalFrequencyAt (1_kHz, 1))
+            .expectFalse (FundamentalFrequencyAt (1010_Hz, 10))
+            .process();
+    }
+}
+
+HART_TEST ("Fundamental Frequency - Silence And Noise")
+{
+    // Latency and the silence after it aren't checked
+    processAudioWith (Delay (50_ms))
+        .withInputSignal (SineWave (440_Hz))
+        .expectTrue (FundamentalFrequencyAt (440_Hz, 1))
+        .process();
+
+    processAudioWith (GainDb())
+        .withInputSignal (WhiteNoise())
+        .expectFalse (FundamentalFrequencyAt (440_Hz))
+        .process();
+
+    bool hasThrown = false;
+
+    try
+    {
+        FundamentalFrequencyAt (0_Hz);
+    }
+    catch (const hart::ValueError&)
+    {
+        hasThrown = true;
+    }
+
+    HART_EXPECT_TRUE (hasThrown);
+}
+
+HART_TEST ("Fundamental Frequency - Tracking")
+{
+    const SineSweep sweep (1_s, 200_Hz, 800_Hz);
+    const SegmentedEnvelope expectedFrequency = SegmentedEnvelope (200_Hz).rampTo (800_Hz, 1_s, SegmentedEnvelope::Shape::exponential);
+    const SegmentedEnvelope octaveAbove = SegmentedEnvelope (400_Hz).rampTo (1600_Hz, 1_s, SegmentedEnvelope::Shape::exponential);
+
+    processAudioWith (GainDb())
+        .withSampleRate (48_kHz)
+        .withDuration (1.5_s)
+        .withInputSignal (sweep)
+        .expectTrue (FrequencyTracks (expectedFrequency, 10, 100_Hz, 2_kHz))
+        .expectFalse (FrequencyTracks (octaveAbove, 10, 100_Hz, 2_kHz))
+        .expectFalse (FrequencyTracks (SegmentedEnvelope (500_Hz), 10, 100_Hz, 2_kHz))
+        .process();
+
+    // Zero in the envelope skips the check
+    processAudioWith (GainDb())
+        .withInputSignal (SineWave (300_Hz))
+        .withDuration (1_s)
+        .expectTrue (FrequencyTracks (SegmentedEnvelope (0).hold (0.5_s).rampTo (300_Hz, 0_s).hold (0.5_s)))
+        .expectFalse (FrequencyTracks (SegmentedEnvelope (0).hold (0.5_s).rampTo (600_Hz, 0_s).hold (0.5_s)))
+        .process();
+}
@@ -0,0 +1,52 @@
+#include <string>
+
+#include "hart.hpp"
+
+using hart::fuzzAudioWith;
+using GainDb = hart::GainDb<float>;
+using HardClip = hart::HardClip<float>;
+using IsFinite = hart::IsFinite<float>;
+using PeaksBelow = hart::PeaksBelow<float>;
+using SineWave = hart::SineWave<float>;
+
+HART_TEST ("Fuzzer - Passing Cases")
+{
+    fuzzAudioWith (HardClip())
+        .withLabel ("Clipper never exceeds its threshold")
+        .withRandomValue (HardClip::thresholdDb, -60_dB, 0_dB)
+        .withBlockSizeRange (1, 512)
+        .inStereo()
+        .withNumCases (500)
+        .expectTrue (IsFinite())
+        .expectTrue (PeaksBelow (0_dB))
+        .run();
+
+    fuzzAudioWith (GainDb())
+        .withLabel ("Automated gain")
+        .withInputSignal (SineWave (440_Hz))
+        .withRandomEnvelope (GainDb::gainDb, -oo_dB, 0_dB)
+        .withNumCases (500)
+        .expectTrue (PeaksBelow (0_dB))
+        .run();
+}
+
+HART_TEST ("Fuzzer - Failing Case Gets Shrunk")
+{
+    fuzzAudioWith (GainDb())
+        .withLabel ("Boost breaks the ceiling")
+        .withInputSignal (SineWave (440_Hz))
+        .withRandomValue (GainDb::gainDb, -20_dB, +12_dB)
+        .withNumCases (200)
+        .expectTrue (PeaksBelow (0_dB))
+        .run();
+
+    // The failure above is intentional, so it's taken out of the report here
+    auto& messages = hart::ExpectationFailureMessages::get();
+    HART_ASSERT_TRUE (messages.size() == 1);
+    const std::string report = messages.back();
+    messages.clear();
+
+    HART_EXPECT_TRUE (report.find ("Minimal failing case:") != std::string::npos);
+    HART_EXPECT_TRUE (report.find (".withValue (0, ") != std::string::npos);
+    HART_EXPECT_TRUE (report.find (".expectTrue (PeaksBelow (") != std::string::npos);
+}
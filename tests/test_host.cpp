@@ -1,10 +1,16 @@
+#include <cstdio>  // remove()
 #include <memory>
+#include <string>
+#include <vector>
+
 #include "hart.hpp"
 
 using hart::processAudioWith;
 using EqualsTo = hart::EqualsTo<float>;
 using PeaksAt = hart::PeaksAt<float>;
 using GainDb = hart::GainDb<float>;
+using GainLinear = hart::GainLinear<float>;
+using SegmentedEnvelope = hart::SegmentedEnvelope;
 using SineWave = hart::SineWave<float>;
 
 HART_TEST ("Host - DSP Move, Copy and Transfer")
@@ -66,3 +72,186 @@ HART_TEST ("Host - DSP Re-use")
         .expectTrue (PeaksAt (-3_dB))
         .process();
 }
+
+HART_TEST ("Host - Compiled Test Plan Runs Repeatedly")
+{
+    const auto gainEnvelope = hart::SegmentedEnvelope (-12_dB)
+        .hold (10_ms)
+        .rampTo (0_dB, 20_ms);
+
+    // Both the DSP envelope and the reference signal have to start
+    // over on each run, otherwise EqualsTo would fail on the second one
+    auto plan = processAudioWith (GainDb().withEnvelope (GainDb::gainDb, gainEnvelope))
+        .withInputSignal (SineWave (1_kHz))
+        .withFixedDuration (50_ms)
+        .withBlockSize (100)
+        .expectTrue (EqualsTo (SineWave (1_kHz) >> GainDb().withEnvelope (GainDb::gainDb, gainEnvelope)))
+        .expectTrue (PeaksAt (0_dB))
+        .compile();
+
+    for (int run = 0; run < 5; ++run)
+        HART_ASSERT_TRUE (plan.run());
+
+    HART_EXPECT_TRUE (hart::ExpectationFailureMessages::get().empty());
+    auto reuseMe = plan.releaseProcessor();
+    HART_EXPECT_TRUE (reuseMe != nullptr);
+}
+
+HART_TEST_WITH_TAGS ("Host - Cancelled Test Stops At Block Boundary", "[timeout=60]")
+{
+    // Pretend that the watchdog has already fired for this test
+    hart::CancellationToken* runnerToken = hart::CancellationToken::getCurrent();
+    hart::CancellationToken cancelledToken;
+    cancelledToken.cancel (hart::CancellationReason::timeout);
+    hart::CancellationToken::setCurrent (&cancelledToken);
+    std::string failureMessage;
+
+    try
+    {
+        processAudioWith (GainDb())
+            .withInputSignal (SineWave())
+            .withDuration (10 * 60 * 60)
+            .expectTrue (hart::PeaksBelow<float> (0_dB))
+            .process();
+    }
+    catch (const hart::TestAssertException& e)
+    {
+        failureMessage = e.what();
+    }
+
+    hart::CancellationToken::setCurrent (runnerToken);
+    HART_EXPECT_TRUE (failureMessage.find ("Test timed out at block 0") != std::string::npos);
+}
+
+HART_TEST ("Host - Asynchronous Processing")
+{
+    std::vector<hart::ProcessFuture<float>> futures;
+
+    for (int preset = 0; preset < 16; ++preset)
+    {
+        const double gainDb = -1.0 * preset;
+
+        futures.push_back (processAudioWith (GainDb (gainDb))
+            .withLabel ("Preset " + std::to_string (preset))
+            .withInputSignal (SineWave())
+            .expectTrue (PeaksAt (gainDb))
+            .processAsync());
+    }
+
+    // This one fails on purpose
+    futures.push_back (processAudioWith (GainDb (-6_dB))
+        .withLabel ("Wrong peak")
+        .withInputSignal (SineWave())
+        .expectTrue (PeaksAt (0_dB))
+        .processAsync());
+
+    for (auto& future : futures)
+        HART_EXPECT_TRUE (future.get() != nullptr);
+
+    // The failed expectation has to end up here, and not on some worker thread
+    auto& messages = hart::ExpectationFailureMessages::get();
+    HART_ASSERT_TRUE (messages.size() == 1);
+    HART_EXPECT_TRUE (messages.back().find ("Wrong peak") != std::string::npos);
+    messages.clear();
+}
+
+static size_t countWavFrames (const std::string& path)
+{
+    unsigned int numChannels = 0;
+    unsigned int sampleRateHz = 0;
+    drwav_uint64 numFrames = 0;
+    float* pcmFrames = drwav_open_file_and_read_pcm_frames_f32 (path.c_str(), &numChannels, &sampleRateHz, &numFrames, nullptr);
+
+    if (pcmFrames == nullptr)
+        return 0;
+
+    drwav_free (pcmFrames, nullptr);
+    return static_cast<size_t> (numFrames);
+}
+
+HART_TEST ("Host - Failure Window")
+{
+    HART_REQUIRES_DATA_PATH_ARG;
+
+    // Gain drops by 6 dB half a second in, and the output stops matching the input there
+    const auto gainEnvelope = SegmentedEnvelope (1.0)
+        .hold (500_ms)
+        .rampTo (0.5, 1_ms);
+
+    processAudioWith (GainLinear().withEnvelope (GainLinear::gainLinear, gainEnvelope))
+        .withLabel ("Gain drop")
+        .withInputSignal (SineWave())
+        .withFixedDuration (2_s)
+        .withFailureWindow (10_ms, 20_ms)
+        .saveOutputTo ("Failure Window.wav", hart::Save::whenFails)
+        .expectTrue (EqualsTo (SineWave()))
+        .process();
+
+    auto& messages = hart::ExpectationFailureMessages::get();
+    HART_ASSERT_TRUE (messages.size() == 1);
+    messages.clear();
+
+    // 10 ms before the failed frame, the frame itself, and 20 ms after it
+    const size_t expectedNumFrames = 441 + 1 + 882;
+    const std::string outputPath = hart::toAbsolutePath ("Failure Window.wav");
+    const std::string inputPath = hart::toAbsolutePath ("Failure Window_input.wav");
+    const std::string referencePath = hart::toAbsolutePath ("Failure Window_reference.wav");
+    HART_EXPECT_TRUE (countWavFrames (outputPath) == expectedNumFrames);
+    HART_EXPECT_TRUE (countWavFrames (inputPath) == expectedNumFrames);
+    HART_EXPECT_TRUE (countWavFrames (referencePath) == expectedNumFrames);
+
+    std::remove (outputPath.c_str());
+    std::remove (inputPath.c_str());
+    std::remove (referencePath.c_str());
+}
+
+HART_TEST ("Host - Pipelined Processing")
+{
+    const auto gainEnvelope = SegmentedEnvelope (1.0)
+        .hold (50_ms)
+        .rampTo (0.5, 1_ms);
+
+    auto& messages = hart::ExpectationFailureMessages::get();
+    std::vector<std::string> failureMessages;
+
+    for (const bool isPipelined : { false, true })
+    {
+        auto builder = processAudioWith (GainLinear().withEnvelope (GainLinear::gainLinear, gainEnvelope));
+        builder.withInputSignal (SineWave())
+            .withBlockSize (32)
+            .withFixedDuration (100_ms)
+            .expectTrue (PeaksAt (0_dB))
+            .expectTrue (EqualsTo (SineWave()));
+
+        if (isPipelined)
+            builder.withPipelining();
+
+        HART_EXPECT_TRUE (builder.process() != nullptr);
+        HART_ASSERT_TRUE (messages.size() == 1);
+        failureMessages.push_back (messages.back());
+        messages.clear();
+    }
+
+    // Same failure at the same frame
+    HART_EXPECT_TRUE (failureMessages[0] == failureMessages[1]);
+
+    std::string assertionMessage;
+
+    try
+    {
+        processAudioWith (GainLinear().withEnvelope (GainLinear::gainLinear, gainEnvelope))
+            .withInputSignal (SineWave())
+            .withBlockSize (32)
+            .withFixedDuration (100_ms)
+            .withPipelining()
+            .assertTrue (EqualsTo (SineWave()))
+            .process();
+    }
+    catch (const hart::TestAssertException& exception)
+    {
+        assertionMessage = exception.what();
+    }
+
+    HART_EXPECT_TRUE (assertionMessage.find ("assertTrue() failed") != std::string::npos);
+    HART_EXPECT_TRUE (messages.empty());
+}
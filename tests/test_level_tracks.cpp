@@ -0,0 +1,97 @@
+#include "hart.hpp"
+
+using hart::processAudioWith;
+using GainDb = hart::GainDb<float>;
+using LevelTracks = hart::LevelTracks<float>;
+using SegmentedEnvelope = hart::SegmentedEnvelope;
+using SineWave = hart::SineWave<float>;
+using WhiteNoise = hart::WhiteNoise<float>;
+
+// RMS level of a sine is 3 dB below its peak level
+static const double sineRmsDb = -3.0103;
+
+HART_TEST ("Level Tracks - Steady Level")
+{
+    processAudioWith (GainDb (-6_dB))
+        .withInputSignal (SineWave (1_kHz))
+        .withInputChannels (2)
+        .withOutputChannels (2)
+        .expectTrue (LevelTracks (SegmentedEnvelope (sineRmsDb - 6_dB), 0.05_dB))
+        .expectTrue (LevelTracks (SegmentedEnvelope (-6_dB), 0.05_dB, 10_ms, LevelTracks::Measure::peak))
+        .expectFalse (LevelTracks (SegmentedEnvelope (-6_dB), 1_dB))
+        .process();
+
+    for (const size_t blockSize : { 1, 64, 4410 })
+    {
+        processAudioWith (GainDb (-12_dB))
+            .withLabel ("Block size")
+            .withBlockSize (blockSize)
+            .withInputSignal (SineWave (1_kHz))
+            .expectTrue (LevelTracks (SegmentedEnvelope (sineRmsDb - 12_dB), 0.05_dB))
+            .expectFalse (LevelTracks (SegmentedEnvelope (sineRmsDb - 11_dB), 0.5_dB))
+            .process();
+    }
+}
+
+HART_TEST ("Level Tracks - Gain Ramps")
+{
+    const auto gainEnvelope = SegmentedEnvelope (0_dB)
+        .hold (100_ms)
+        .rampTo (-20_dB, 200_ms)
+        .hold (100_ms)
+        .rampTo (-10_dB, 100_ms);
+
+    const auto expectedRmsDb = SegmentedEnvelope (sineRmsDb)
+        .hold (100_ms)
+        .rampTo (sineRmsDb - 20_dB, 200_ms)
+        .hold (100_ms)
+        .rampTo (sineRmsDb - 10_dB, 100_ms);
+
+    const auto expectedPeakDb = SegmentedEnvelope (0_dB)
+        .hold (100_ms)
+        .rampTo (-20_dB, 200_ms)
+        .hold (100_ms)
+        .rampTo (-10_dB, 100_ms);
+
+    // Same ramp, but 20 ms late
+    const auto lateRmsDb = SegmentedEnvelope (sineRmsDb)
+        .hold (120_ms)
+        .rampTo (sineRmsDb - 20_dB, 200_ms)
+        .hold (80_ms)
+        .rampTo (sineRmsDb - 10_dB, 100_ms);
+
+    processAudioWith (GainDb().withEnvelope (GainDb::gainDb, gainEnvelope))
+        .withInputSignal (SineWave (1_kHz))
+        .withDuration (0.5_s)
+        .expectTrue (LevelTracks (expectedRmsDb, 0.2_dB))
+        .expectTrue (LevelTracks (expectedPeakDb, 0.6_dB, 10_ms, LevelTracks::Measure::peak))
+        .expectFalse (LevelTracks (lateRmsDb, 1_dB))
+        .process();
+
+    // Longer window smooths out the noise
+    processAudioWith (GainDb().withEnvelope (GainDb::gainDb, gainEnvelope))
+        .withInputSignal (WhiteNoise())
+        .withDuration (0.5_s)
+        .expectTrue (LevelTracks (SegmentedEnvelope (-4.77_dB)
+            .hold (100_ms)
+            .rampTo (-24.77_dB, 200_ms)
+            .hold (100_ms)
+            .rampTo (-14.77_dB, 100_ms), 1_dB, 20_ms))
+        .process();
+}
+
+HART_TEST ("Level Tracks - Invalid Arguments")
+{
+    bool hasThrown = false;
+
+    try
+    {
+        LevelTracks (SegmentedEnvelope (0_dB), -1_dB);
+    }
+    catch (const hart::ValueError&)
+    {
+        hasThrown = true;
+    }
+
+    HART_EXPECT_TRUE (hasThrown);
+}
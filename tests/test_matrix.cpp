@@ -0,0 +1,83 @@
+#include "hart.hpp"
+
+using hart::processAudioWith;
+using EqualsTo = hart::EqualsTo<float>;
+using Matrix = hart::Matrix<float>;
+using PeaksAt = hart::PeaksAt<float>;
+using PeaksBelow = hart::PeaksBelow<float>;
+using SegmentedEnvelope = hart::SegmentedEnvelope;
+using SineWave = hart::SineWave<float>;
+using WhiteNoise = hart::WhiteNoise<float>;
+
+HART_TEST ("Matrix - Routing")
+{
+    const Matrix swapChannels ({{ 0.0, 1.0 }, { 1.0, 0.0 }});
+    WhiteNoise swappedNoise (1);
+    swappedNoise.followedBy (swapChannels);
+
+    processAudioWith (swapChannels)
+        .withLabel ("Swapping twice")
+        .withInputChannels (2)
+        .withOutputChannels (2)
+        .withInputSignal (swappedNoise)
+        .expectTrue (EqualsTo (WhiteNoise (1), 0.0))
+        .process();
+
+    // Sine wave is the same in every channel
+    std::vector<std::vector<double>> upmixGains (16, std::vector<double> (1, 0.5));
+    upmixGains[15][0] = 0.0;
+
+    processAudioWith (Matrix (upmixGains))
+        .withLabel ("Upmix")
+        .withInputChannels (1)
+        .withOutputChannels (16)
+        .withInputSignal (SineWave())
+        .expectTrue (PeaksAt (-6_dB, 0.01))
+        .process();
+
+    processAudioWith (Matrix ({ std::vector<double> (16, 1.0 / 16.0) }))
+        .withLabel ("Downmix")
+        .withInputChannels (16)
+        .withOutputChannels (1)
+        .withInputSignal (SineWave())
+        .expectTrue (EqualsTo (SineWave(), 1e-6))
+        .process();
+
+    processAudioWith (Matrix ({{ 0.5, -0.5 }}))
+        .withLabel ("Cancellation")
+        .withInputChannels (2)
+        .withOutputChannels (1)
+        .withInputSignal (SineWave())
+        .expectTrue (PeaksBelow (-120_dB))
+        .process();
+}
+
+HART_TEST ("Matrix - Automation")
+{
+    Matrix stereoToMono ({{ 1.0, 0.0 }});
+    stereoToMono.setValue (stereoToMono.getParamId (0, 0), 0.5);
+    stereoToMono.withEnvelope (stereoToMono.getParamId (0, 1), SegmentedEnvelope (0.0).rampTo (0.5, 100_ms));
+
+    processAudioWith (stereoToMono)
+        .withInputChannels (2)
+        .withOutputChannels (1)
+        .withInputSignal (SineWave())
+        .expectTrue (PeaksAt (0_dB, 0.01))
+        .process();
+}
+
+HART_TEST ("Matrix - Invalid Gains")
+{
+    bool hasThrown = false;
+
+    try
+    {
+        Matrix ({{ 1.0, 0.0 }, { 1.0 }});
+    }
+    catch (const hart::ValueError&)
+    {
+        hasThrown = true;
+    }
+
+    HART_EXPECT_TRUE (hasThrown);
+}
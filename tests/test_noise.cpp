@@ -0,0 +1,75 @@
+#include "hart.hpp"
+
+using hart::processAudioWith;
+using BrownNoise = hart::BrownNoise<float>;
+using EqualsTo = hart::EqualsTo<float>;
+using GainDb = hart::GainDb<float>;
+using GaussianNoise = hart::GaussianNoise<float>;
+using PeaksBelow = hart::PeaksBelow<float>;
+using PinkNoise = hart::PinkNoise<float>;
+
+HART_TEST ("Noise - Same Seed Same Noise")
+{
+    processAudioWith (GainDb())
+        .withLabel ("Gaussian noise")
+        .withInputSignal (GaussianNoise (0.25, 42))
+        .withInputChannels (2)
+        .withOutputChannels (2)
+        .expectTrue (EqualsTo (GaussianNoise (0.25, 42)))
+        .expectFalse (EqualsTo (GaussianNoise (0.25, 43)))
+        .process();
+
+    processAudioWith (GainDb())
+        .withLabel ("Pink noise")
+        .withInputSignal (PinkNoise (42))
+        .withInputChannels (2)
+        .withOutputChannels (2)
+        .expectTrue (EqualsTo (PinkNoise (42)))
+        .expectFalse (EqualsTo (PinkNoise (43)))
+        .process();
+
+    processAudioWith (GainDb())
+        .withLabel ("Brown noise")
+        .withInputSignal (BrownNoise (42))
+        .withInputChannels (2)
+        .withOutputChannels (2)
+        .expectTrue (EqualsTo (BrownNoise (42)))
+        .expectFalse (EqualsTo (BrownNoise (43)))
+        .process();
+}
+
+HART_TEST ("Noise - Levels")
+{
+    processAudioWith (GainDb())
+        .withLabel ("Gaussian noise")
+        .withDuration (10.0)
+        .withInputSignal (GaussianNoise (0.1))
+        .expectTrue (PeaksBelow (0_dB))
+        .expectFalse (PeaksBelow (-20_dB))
+        .process();
+
+    processAudioWith (GainDb())
+        .withLabel ("Pink noise")
+        .withDuration (10.0)
+        .withInputSignal (PinkNoise())
+        .expectTrue (PeaksBelow (0_dB))
+        .expectFalse (PeaksBelow (-20_dB))
+        .process();
+
+    processAudioWith (GainDb())
+        .withLabel ("Brown noise")
+        .withDuration (10.0)
+        .withInputSignal (BrownNoise())
+        .expectTrue (PeaksBelow (0_dB))
+        .expectFalse (PeaksBelow (-20_dB))
+        .process();
+
+    processAudioWith (GainDb())
+        .withLabel ("Brown noise at high sample rate")
+        .withSampleRate (192_kHz)
+        .withDuration (10.0)
+        .withInputSignal (BrownNoise())
+        .expectTrue (PeaksBelow (0_dB))
+        .expectFalse (PeaksBelow (-20_dB))
+        .process();
+}
@@ -0,0 +1,110 @@
+#include "hart.hpp"
+
+using hart::processAudioWith;
+using EqualsTo = hart::EqualsTo<float>;
+using GainDb = hart::GainDb<float>;
+using GainLinear = hart::GainLinear<float>;
+using PeaksAt = hart::PeaksAt<float>;
+using PeaksBelow = hart::PeaksBelow<float>;
+using Pulse = hart::Pulse<float>;
+using Saw = hart::Saw<float>;
+using Square = hart::Square<float>;
+using Triangle = hart::Triangle<float>;
+
+HART_TEST ("Oscillators - Levels")
+{
+    processAudioWith (GainDb())
+        .withLabel ("Saw")
+        .withInputSignal (Saw (1_kHz))
+        .withInputChannels (2)
+        .withOutputChannels (2)
+        .expectTrue (PeaksAt (0_dB, 0.05))
+        .expectTrue (PeaksBelow (0_dB))
+        .process();
+
+    processAudioWith (GainDb())
+        .withLabel ("Square")
+        .withInputSignal (Square (1_kHz))
+        .expectTrue (PeaksAt (0_dB, 0.05))
+        .expectTrue (PeaksBelow (0_dB))
+        .process();
+
+    processAudioWith (GainDb())
+        .withLabel ("Triangle")
+        .withInputSignal (Triangle (1_kHz))
+        .expectTrue (PeaksAt (0_dB, 0.05))
+        .expectTrue (PeaksBelow (0_dB))
+        .process();
+
+    processAudioWith (GainDb())
+        .withLabel ("Narrow pulse")
+        .withInputSignal (Pulse (1_kHz, 0.1))
+        .expectTrue (PeaksAt (0_dB, 0.05))
+        .expectTrue (PeaksBelow (0_dB))
+        .process();
+
+    processAudioWith (GainDb())
+        .withLabel ("Close to Nyquist")
+        .withSampleRate (48_kHz)
+        .withInputSignal (Saw (20_kHz))
+        .expectTrue (PeaksBelow (0_dB))
+        .process();
+}
+
+HART_TEST ("Oscillators - Phase")
+{
+    processAudioWith (GainDb())
+        .withLabel ("Square is a pulse with 50% duty cycle")
+        .withInputSignal (Square (1_kHz))
+        .expectTrue (EqualsTo (Pulse (1_kHz, 0.5)))
+        .process();
+
+    processAudioWith (GainDb())
+        .withLabel ("Half a cycle apart square waves")
+        .withInputSignal (Square (1_kHz, hart::pi))
+        .expectTrue (EqualsTo (Square (1_kHz) >> GainLinear (-1.0)))
+        .process();
+
+    processAudioWith (GainDb())
+        .withLabel ("Half a cycle apart triangle waves")
+        .withInputSignal (Triangle (1_kHz, hart::pi))
+        .expectTrue (EqualsTo (Triangle (1_kHz) >> GainLinear (-1.0)))
+        .process();
+
+    processAudioWith (GainDb())
+        .withLabel ("Saw is not a square")
+        .withInputSignal (Saw (1_kHz))
+        .expectFalse (EqualsTo (Square (1_kHz)))
+        .process();
+}
+
+HART_TEST ("Oscillators - Invalid Values")
+{
+    bool hasThrown = false;
+
+    try
+    {
+        Pulse (1_kHz, 1.0);
+    }
+    catch (const hart::ValueError&)
+    {
+        hasThrown = true;
+    }
+
+    HART_EXPECT_TRUE (hasThrown);
+    hasThrown = false;
+
+    try
+    {
+        processAudioWith (GainDb())
+            .withSampleRate (44.1_kHz)
+            .withInputSignal (Saw (30_kHz))
+            .process();
+    }
+    catch (const hart::SampleRateError&)
+    {
+        hasThrown = true;
+    }
+
+    HART_EXPECT_TRUE (hasThrown);
+}
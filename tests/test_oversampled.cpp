@@ -0,0 +1,80 @@
+#include "hart.hpp"
+
+using hart::processAudioWith;
+using GainDb = hart::GainDb<float>;
+using GainLinear = hart::GainLinear<float>;
+using HardClip = hart::HardClip<float>;
+using IsFinite = hart::IsFinite<float>;
+using LPF = hart::LPF<float>;
+using Oversampled = hart::Oversampled<float>;
+using PeaksAt = hart::PeaksAt<float>;
+using PeaksBelow = hart::PeaksBelow<float>;
+using SegmentedEnvelope = hart::SegmentedEnvelope;
+using SineWave = hart::SineWave<float>;
+
+HART_TEST ("Oversampled - Pass Band")
+{
+    for (const size_t factor : { 2, 4, 8, 16 })
+    {
+        processAudioWith (Oversampled (GainDb (0_dB), factor))
+            .withLabel (std::to_string (factor) + "x oversampling")
+            .withBlockSize (100)
+            .withInputSignal (SineWave (1_kHz))
+            .expectTrue (PeaksAt (0_dB, 0.01))
+            .expectTrue (IsFinite())
+            .process();
+    }
+}
+
+HART_TEST ("Oversampled - Wrapped DSP Runs At Higher Sample Rate")
+{
+    // Cutoff stays the same, no matter the oversampling factor
+    GainLinear fadeIn;
+    fadeIn.withEnvelope (GainLinear::gainLinear, SegmentedEnvelope (0.0).rampTo (1.0, 20_ms, SegmentedEnvelope::Shape::sCurve));
+    SineWave fadingInSineWave (10_kHz);
+    fadingInSineWave.followedBy (std::move (fadeIn));
+
+    processAudioWith (Oversampled (LPF (1_kHz), 4))
+        .withInputSignal (fadingInSineWave)
+        .expectTrue (PeaksBelow (-35_dB))
+        .process();
+
+    // Envelopes of the wrapped DSP get rendered at the higher sample rate, but take just as long
+    GainDb gainRamp;
+    gainRamp.withEnvelope (GainDb::gainDb, SegmentedEnvelope (-60_dB).rampTo (-6_dB, 100_ms));
+
+    processAudioWith (Oversampled (std::move (gainRamp), 8))
+        .withDuration (50_ms)
+        .withInputSignal (SineWave (1_kHz))
+        .expectTrue (PeaksBelow (-30_dB))
+        .process();
+
+    // Clipper at the higher sample rate still doesn't let anything through above its threshold, give or take the filter ripple
+    processAudioWith (Oversampled (HardClip (-6_dB), 4))
+        .withInputSignal (SineWave (1_kHz))
+        .expectTrue (PeaksBelow (-5.8_dB))
+        .process();
+}
+
+HART_TEST ("Oversampled - Latency")
+{
+    HART_EXPECT_TRUE (Oversampled (GainDb(), 2).getLatencyFrames() == 31.0);
+    HART_EXPECT_TRUE (Oversampled (GainDb(), 4).getLatencyFrames() == 36.5);
+    HART_EXPECT_TRUE (Oversampled (GainDb(), 8).getLatencyFrames() == 39.25);
+}
+
+HART_TEST ("Oversampled - Invalid Factor")
+{
+    bool hasThrown = false;
+
+    try
+    {
+        Oversampled (GainDb(), 3);
+    }
+    catch (const hart::ValueError&)
+    {
+        hasThrown = true;
+    }
+
+    HART_EXPECT_TRUE (hasThrown);
+}
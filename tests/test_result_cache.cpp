@@ -0,0 +1,56 @@
+#include <cstdio>  // remove()
+#include <fstream>
+#include <string>
+
+#include "hart.hpp"
+
+using hart::ResultCache;
+
+static void writeTextFile (const std::string& path, const std::string& text)
+{
+    std::ofstream file (path, std::ios::trunc);
+    file << text;
+}
+
+HART_TEST ("Result Cache - Stale Data Files")
+{
+    HART_REQUIRES_DATA_PATH_ARG;
+
+    const std::string dataFilePath = hart::toAbsolutePath ("result_cache_test_data.tmp");
+    const std::string cacheFilePath = hart::toAbsolutePath ("result_cache_test.hartcache");
+    writeTextFile (dataFilePath, "Original data");
+
+    ResultCache cache;
+    cache.load (cacheFilePath, "binary-a", "config-a");
+    HART_EXPECT_TRUE (! cache.isUpToDate ("Some Test"));
+    cache.storePassed ("Some Test", { dataFilePath });
+    cache.storePassed ("Other Test", {});
+    HART_ASSERT_TRUE (cache.save());
+
+    // Same binary and config
+    ResultCache sameCache;
+    sameCache.load (cacheFilePath, "binary-a", "config-a");
+    HART_EXPECT_TRUE (sameCache.isUpToDate ("Some Test"));
+    HART_EXPECT_TRUE (sameCache.isUpToDate ("Other Test"));
+    HART_EXPECT_TRUE (! sameCache.isUpToDate ("Unknown Test"));
+
+    // Data file has changed
+    writeTextFile (dataFilePath, "Updated data");
+    HART_EXPECT_TRUE (! sameCache.isUpToDate ("Some Test"));
+    HART_EXPECT_TRUE (sameCache.isUpToDate ("Other Test"));
+
+    // Test binary has changed
+    ResultCache rebuiltCache;
+    rebuiltCache.load (cacheFilePath, "binary-b", "config-a");
+    HART_EXPECT_TRUE (! rebuiltCache.isUpToDate ("Other Test"));
+
+    std::remove (dataFilePath.c_str());
+    std::remove (cacheFilePath.c_str());
+}
+
+HART_TEST ("Result Cache - Fingerprints")
+{
+    HART_EXPECT_TRUE (ResultCache::fingerprintString ("") == "cbf29ce484222325");
+    HART_EXPECT_TRUE (ResultCache::fingerprintString ("a") == "af63dc4c8601ec8c");
+    HART_EXPECT_TRUE (ResultCache::fingerprintFile ("/this/file/does/not/exist.wav") == "missing");
+}
@@ -57,7 +57,7 @@ HART_TEST ("SineSweep - Loop")
 {
     processAudioWith (GainDb (0_dB))
         .withLabel ("Actually loops if requested")
-        .withDuration (350_ms)
+        .withFixedDuration (350_ms)  // Should be longer than the sweep
         .withInputSignal (SineSweep (300_ms).withLoop (SineSweep::Loop::yes))
         .expectTrue (PeaksAt (0_dB))
         .expectFalse (EqualsTo (SineSweep (300_ms).withLoop (SineSweep::Loop::no)))
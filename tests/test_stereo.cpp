@@ -0,0 +1,94 @@
+#include "hart.hpp"
+
+using hart::processAudioWith;
+using GainDb = hart::GainDb<float>;
+using Matrix = hart::Matrix<float>;
+using MidSideRatioWithin = hart::MidSideRatioWithin<float>;
+using PolarityInverted = hart::PolarityInverted<float>;
+using SineWave = hart::SineWave<float>;
+using StereoBalanceWithin = hart::StereoBalanceWithin<float>;
+using StereoCorrelationWithin = hart::StereoCorrelationWithin<float>;
+using WhiteNoise = hart::WhiteNoise<float>;
+
+HART_TEST ("Stereo - Mono Signal")
+{
+    processAudioWith (GainDb())
+        .withInputSignal (SineWave (1_kHz))
+        .withInputChannels (2)
+        .withOutputChannels (2)
+        .expectTrue (StereoCorrelationWithin (0.999))
+        .expectTrue (StereoBalanceWithin (-0.01_dB, 0.01_dB))
+        .expectTrue (MidSideRatioWithin (100_dB, oo_dB))
+        .expectFalse (PolarityInverted())
+        .process();
+
+    // Opposite polarity
+    processAudioWith (Matrix ({ { 1.0 }, { -1.0 } }))
+        .withInputSignal (SineWave (1_kHz))
+        .withOutputChannels (2)
+        .expectTrue (StereoCorrelationWithin (-1.0, -0.999))
+        .expectTrue (StereoBalanceWithin (-0.01_dB, 0.01_dB))
+        .expectTrue (MidSideRatioWithin (-oo_dB, -100_dB))
+        .expectTrue (PolarityInverted())
+        .process();
+
+    // Right channel 6 dB down: mid is 1.5 and side is 0.5, so the ratio is 20 * log10 (3)
+    processAudioWith (Matrix ({ { 1.0 }, { 0.5 } }))
+        .withInputSignal (SineWave (1_kHz))
+        .withOutputChannels (2)
+        .expectTrue (StereoCorrelationWithin (0.999))
+        .expectTrue (StereoBalanceWithin (-6.03_dB, -6.00_dB))
+        .expectFalse (StereoBalanceWithin (-0.1_dB, 0.1_dB))
+        .expectTrue (MidSideRatioWithin (9.53_dB, 9.55_dB))
+        .process();
+}
+
+HART_TEST ("Stereo - Unrelated Channels")
+{
+    for (const size_t blockSize : { 32, 1000, 4410 })
+    {
+        processAudioWith (GainDb())
+            .withBlockSize (blockSize)
+            .withDuration (0.5_s)
+            .withInputSignal (WhiteNoise())
+            .withInputChannels (2)
+            .withOutputChannels (2)
+            .expectTrue (StereoCorrelationWithin (-0.15, 0.15))
+            .expectFalse (StereoCorrelationWithin (0.5))
+            .expectTrue (StereoBalanceWithin (-1_dB, 1_dB))
+            .expectTrue (MidSideRatioWithin (-1_dB, 1_dB))
+            .expectFalse (PolarityInverted())
+            .process();
+    }
+}
+
+HART_TEST ("Stereo - Silence And Layouts")
+{
+    // Silent channel only counts for the balance
+    processAudioWith (Matrix ({ { 1.0 }, { 0.0 } }))
+        .withInputSignal (WhiteNoise())
+        .withOutputChannels (2)
+        .expectTrue (StereoCorrelationWithin (0.9))
+        .expectTrue (StereoBalanceWithin (-oo_dB, -100_dB))
+        .expectTrue (MidSideRatioWithin (-0.01_dB, 0.01_dB))
+        .process();
+
+    processAudioWith (GainDb())
+        .withInputSignal (SineWave())
+        .withOutputChannels (1)
+        .expectFalse (StereoCorrelationWithin (-1.0))
+        .process();
+
+    bool hasThrown = false;
+
+    try
+    {
+        StereoBalanceWithin (3_dB, -3_dB);
+    }
+    catch (const hart::ValueError&)
+    {
+        hasThrown = true;
+    }
+
+    HART_EXPECT_TRUE (hasThrown);
+}
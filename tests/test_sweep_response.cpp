@@ -0,0 +1,78 @@
+#include "hart.hpp"
+
+using hart::processAudioWith;
+using Delay = hart::Delay<float>;
+using FrequencyResponseWithin = hart::FrequencyResponseWithin<float>;
+using GainDb = hart::GainDb<float>;
+using GroupDelayBelow = hart::GroupDelayBelow<float>;
+using HighShelf = hart::HighShelf<float>;
+using LPF = hart::LPF<float>;
+using PhaseResponseWithin = hart::PhaseResponseWithin<float>;
+using ResponseMask = hart::ResponseMask;
+using SineSweep = hart::SineSweep<float>;
+
+static const SineSweep sweep (2_s, 20_Hz, 20_kHz);
+
+HART_TEST ("Sweep Response - Flat")
+{
+    processAudioWith (GainDb (-6_dB))
+        .withSampleRate (48_kHz)
+        .withDuration (2.2_s)
+        .withInputSignal (sweep)
+        .expectTrue (FrequencyResponseWithin (sweep, ResponseMask().withBand (30_Hz, 19_kHz, -6.01_dB, -5.99_dB)))
+        .expectFalse (FrequencyResponseWithin (sweep, ResponseMask().withBand (30_Hz, 19_kHz, -0.1_dB, 0.1_dB)))
+        .expectTrue (PhaseResponseWithin (sweep, ResponseMask().withBand (30_Hz, 19_kHz, -0.001, 0.001)))
+        .expectTrue (GroupDelayBelow (sweep, 1_us))
+        .process();
+}
+
+HART_TEST ("Sweep Response - Filters")
+{
+    // Second order Butterworth: -3 dB and -90 degrees at the cutoff, then -12 dB per octave
+    processAudioWith (LPF (1_kHz))
+        .withSampleRate (48_kHz)
+        .withDuration (2.2_s)
+        .withInputSignal (sweep)
+        .expectTrue (FrequencyResponseWithin (sweep, ResponseMask()
+            .withBand (30_Hz, 200_Hz, -0.01_dB, 0.01_dB)
+            .withBand (995_Hz, 1005_Hz, -3.1_dB, -2.9_dB)
+            .withBand (8_kHz, 19_kHz, -120_dB, -35_dB)))
+        .expectTrue (PhaseResponseWithin (sweep, ResponseMask().withBand (999_Hz, 1001_Hz, -hart::halfPi - 0.01, -hart::halfPi + 0.01)))
+        .expectTrue (GroupDelayBelow (sweep, 0.3_ms))
+        .expectFalse (GroupDelayBelow (sweep, 0.2_ms))
+        .process();
+
+    processAudioWith (HighShelf (2_kHz, 6_dB))
+        .withSampleRate (48_kHz)
+        .withDuration (2.2_s)
+        .withInputSignal (sweep)
+        .expectTrue (FrequencyResponseWithin (sweep, ResponseMask()
+            .withBand (30_Hz, 200_Hz, -0.1_dB, 0.1_dB)
+            .withBand (1_kHz, 19_kHz, 0_dB, 6.01_dB)
+            .withBand (15_kHz, 19_kHz, 5.9_dB, 6.01_dB)))
+        .process();
+}
+
+HART_TEST ("Sweep Response - Latency")
+{
+    // Group delay of a pure delay is the same at all frequencies
+    processAudioWith (Delay (1_ms))
+        .withSampleRate (48_kHz)
+        .withDuration (2.2_s)
+        .withInputChannels (2)
+        .withOutputChannels (2)
+        .withInputSignal (sweep)
+        .expectTrue (GroupDelayBelow (sweep, 1.001_ms))
+        .expectFalse (GroupDelayBelow (sweep, 0.999_ms))
+        .expectTrue (FrequencyResponseWithin (sweep, ResponseMask().withBand (30_Hz, 19_kHz, -0.01_dB, 0.01_dB)))
+        .process();
+}
+
+HART_TEST ("Sweep Response - Audio Shorter Than Sweep")
+{
+    processAudioWith (GainDb())
+        .withDuration (1_s)
+        .withInputSignal (sweep)
+        .expectFalse (FrequencyResponseWithin (sweep, ResponseMask().withBand (30_Hz, 19_kHz, -1_dB, 1_dB)))
+        .process();
+}
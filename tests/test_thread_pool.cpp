@@ -0,0 +1,37 @@
+#include <atomic>
+
+#include "hart.hpp"
+
+using hart::ThreadPool;
+
+HART_TEST ("Thread Pool - Runs All Jobs")
+{
+    std::atomic<int> numJobsDone (0);
+
+    {
+        ThreadPool threadPool (3);
+
+        for (int i = 0; i < 100; ++i)
+            threadPool.enqueue ([&numJobsDone] { ++numJobsDone; });
+    }
+
+    HART_EXPECT_TRUE (numJobsDone == 100);
+}
+
+HART_TEST ("Thread Pool - No Worker Threads")
+{
+    ThreadPool threadPool (0);
+    int numJobsDone = 0;
+
+    for (int i = 0; i < 10; ++i)
+        threadPool.enqueue ([&numJobsDone] { ++numJobsDone; });
+
+    HART_EXPECT_TRUE (threadPool.hasPendingJobs());
+
+    // Everything runs on the owner's thread, in order
+    while (threadPool.tryRunPendingJob())
+        ;
+
+    HART_EXPECT_TRUE (numJobsDone == 10);
+    HART_EXPECT_TRUE (! threadPool.hasPendingJobs());
+}